@@ -0,0 +1,58 @@
+#ifndef CACHE_BENCH_POLICIES_HPP
+#define CACHE_BENCH_POLICIES_HPP
+
+#include "../include/Cache/ARCCache.hpp"
+#include "../include/Cache/ComposedCache.hpp"
+#include "../include/Cache/FIFOCache.hpp"
+#include "../include/Cache/LFUCache.hpp"
+#include "../include/Cache/LRUCache.hpp"
+#include "../include/Cache/RandomReplacementCache.hpp"
+#include "../include/Cache/S3FIFOCache.hpp"
+#include "../include/Cache/SIEVECache.hpp"
+#include "../include/Cache/SlabFIFOCache.hpp"
+#include "../include/Cache/SlabLRUCache.hpp"
+#include "../include/Cache/TinyLFUCache.hpp"
+#include "../include/Cache/Utility.hpp"
+#include "../include/Cache/WeightedCache.hpp"
+#include <array>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+/// 基准工具共用的 key/value 类型与策略列表
+using Key = std::uint64_t;
+using Value = std::array<std::uint64_t, 4>;
+using WeightedValue = std::pair<Value, std::uint64_t>;
+
+template<typename V>
+V makeValue(Key key) {
+    if constexpr (std::is_same_v<V, WeightedValue>) {
+        // 权重须互不相同;mixHash 是双射,淘汰顺序因此与 key 的热度无关
+        return {Value{key}, mixHash(key)};
+    } else {
+        return Value{key};
+    }
+}
+
+/// 对每个策略调用 visitor.template operator()<Policy, V>(name);V 为该策略的值类型
+template<typename Visitor>
+void forEachPolicy(Visitor &&visitor) {
+    visitor.template operator()<LRUCache<Key, Value>, Value>("LRU");
+    visitor.template operator()<FIFOCache<Key, Value>, Value>("FIFO");
+    visitor.template operator()<LFUCache<Key, Value>, Value>("LFU");
+    visitor.template operator()<RandomReplacementCache<Key, Value>, Value>("Random");
+    visitor.template operator()<RandomReplacementCache<Key, Value, StdHashIndex, UnitSizer, NoStats,
+            SampledEviction<LeastRecentlyUsed>>, Value>("SampledLRU");
+    visitor.template operator()<WeightedCache<Key, WeightedValue>, WeightedValue>("Weighted");
+    visitor.template operator()<WeightedCache<Key, WeightedValue, StdHashIndex, NoStats, GreedyDualSizeFrequency<>>,
+            WeightedValue>("GDSF");
+    visitor.template operator()<TinyLFUCache<Key, Value>, Value>("TinyLFU");
+    visitor.template operator()<ARCCache<Key, Value>, Value>("ARC");
+    visitor.template operator()<S3FIFOCache<Key, Value>, Value>("S3FIFO");
+    visitor.template operator()<SIEVECache<Key, Value>, Value>("SIEVE");
+    visitor.template operator()<SlabLRUCache<Key, Value>, Value>("SlabLRU");
+    visitor.template operator()<SlabFIFOCache<Key, Value>, Value>("SlabFIFO");
+    visitor.template operator()<ComposedCache<Key, Value, SIEVEOrdering, TinyLFUAdmission>, Value>("SIEVE+TinyLFU");
+}
+
+#endif //CACHE_BENCH_POLICIES_HPP
@@ -0,0 +1,122 @@
+#ifndef CACHE_BENCH_WORKLOAD_HPP
+#define CACHE_BENCH_WORKLOAD_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/// 基准测试的一次操作:write 为直接 put,否则为 get,未命中时再 put(read-through)
+struct Op {
+    std::uint64_t key;
+    bool write;
+};
+
+enum class Distribution {
+    Uniform,
+    Zipf
+};
+
+/// 负载描述
+/// - 热点 key 按 distribution 从 [0, keySpace) 中抽取,Zipf 下 key 越小越热
+/// - scanFraction:约有这么多比例的操作属于顺序扫描,每次扫描连续访问 scanLength 个只出现一次的冷 key,
+///   用来检验策略能否抵抗扫描冲刷
+/// - churnPeriod:每隔这么多次操作,热点集合整体平移 keySpace / 16,模拟热点漂移;0 表示不漂移
+struct WorkloadSpec {
+    std::string name;
+    Distribution distribution = Distribution::Zipf;
+    double skew = 0.99;
+    double writeRatio = 0.0;
+    double scanFraction = 0.0;
+    std::size_t scanLength = 0;
+    std::size_t churnPeriod = 0;
+};
+
+/// xorshift64,避免 <random> 的分布开销;种子不能为 0
+inline std::uint64_t nextRandom(std::uint64_t &state) {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return state;
+}
+
+/// [0, 1) 上的均匀分布
+inline double nextUnit(std::uint64_t &state) {
+    return static_cast<double>(nextRandom(state) >> 11) * 0x1.0p-53;
+}
+
+/// Zipf 分布的累积分布表:P(rank = i) ∝ 1 / (i + 1)^skew;按二分查找抽样
+/// 表在多个线程的生成器之间共享(只读)
+class ZipfTable {
+private:
+    std::vector<double> m_cdf;
+
+public:
+    ZipfTable(std::size_t n, double skew) : m_cdf(n) {
+        double sum = 0;
+        for (std::size_t i = 0; i < n; ++i) {
+            sum += 1.0 / std::pow(static_cast<double>(i + 1), skew);
+            m_cdf[i] = sum;
+        }
+        for (double &p: m_cdf) p /= sum;
+    }
+
+    [[nodiscard]] std::uint64_t sample(double u) const {
+        auto it = std::lower_bound(m_cdf.begin(), m_cdf.end(), u);
+        return static_cast<std::uint64_t>(std::min<std::ptrdiff_t>(it - m_cdf.begin(), m_cdf.size() - 1));
+    }
+};
+
+/// 按 WorkloadSpec 生成操作序列;每个线程一个生成器(不同种子),扫描的冷 key 按种子错开,互不重复
+class WorkloadGenerator {
+private:
+    const WorkloadSpec &m_spec;
+    std::size_t m_keySpace;
+    const ZipfTable *m_zipf;  // 仅 Zipf 分布使用
+    std::uint64_t m_state;
+    std::uint64_t m_issued = 0;
+    std::uint64_t m_scanCursor;
+    std::size_t m_scanRemaining = 0;
+
+    std::uint64_t hotKey() {
+        std::uint64_t rank = m_spec.distribution == Distribution::Zipf
+                             ? m_zipf->sample(nextUnit(m_state))
+                             : nextRandom(m_state) % m_keySpace;
+        if (m_spec.churnPeriod == 0) return rank;
+        std::uint64_t shift = m_issued / m_spec.churnPeriod * std::max<std::size_t>(1, m_keySpace / 16);
+        return (rank + shift) % m_keySpace;
+    }
+
+public:
+    WorkloadGenerator(const WorkloadSpec &spec, std::size_t keySpace, const ZipfTable *zipf, std::uint64_t seed)
+            : m_spec(spec), m_keySpace(keySpace), m_zipf(zipf), m_state(seed | 1),
+              m_scanCursor(keySpace + (seed << 32)) {}
+
+    Op next() {
+        Op op{};
+        if (m_scanRemaining == 0 && m_spec.scanLength > 0 &&
+            nextUnit(m_state) < m_spec.scanFraction / static_cast<double>(m_spec.scanLength)) {
+            m_scanRemaining = m_spec.scanLength;
+        }
+        if (m_scanRemaining > 0) {
+            --m_scanRemaining;
+            op.key = m_scanCursor++;
+        } else {
+            op.key = hotKey();
+        }
+        op.write = nextUnit(m_state) < m_spec.writeRatio;
+        ++m_issued;
+        return op;
+    }
+
+    std::vector<Op> generate(std::size_t count) {
+        std::vector<Op> ops;
+        ops.reserve(count);
+        for (std::size_t i = 0; i < count; ++i) ops.push_back(next());
+        return ops;
+    }
+};
+
+#endif //CACHE_BENCH_WORKLOAD_HPP
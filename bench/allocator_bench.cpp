@@ -0,0 +1,112 @@
+// 比较策略节点使用全局分配器、每缓存独占的 NodePoolResource、多缓存共享的 SynchronizedNodePoolResource 时的吞吐
+// 每个线程拥有自己的缓存(模拟一个进程内的大量缓存),键空间为容量的 4 倍,未命中时写入,淘汰持续发生
+// 用法:AllocatorBench [每线程操作数] [最大线程数]
+#include "../include/Cache/ARCCache.hpp"
+#include "../include/Cache/LRUCache.hpp"
+#include "../include/Cache/NodePool.hpp"
+#include "../include/Cache/SIEVECache.hpp"
+#include "../include/Cache/TinyLFUCache.hpp"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <memory_resource>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr std::size_t kCapacity = 4096;
+
+// 定长值,使每次插入只分配策略自身的节点
+using Value = std::array<std::uint64_t, 4>;
+
+enum class Mode {
+    Default,   // 全局分配器
+    Exclusive, // 每个缓存一个 NodePoolResource
+    Shared,    // 所有缓存共享一个 SynchronizedNodePoolResource
+};
+
+const char *modeName(Mode mode) {
+    switch (mode) {
+        case Mode::Default:
+            return "default";
+        case Mode::Exclusive:
+            return "node-pool";
+        case Mode::Shared:
+            return "shared-pool";
+    }
+    return "";
+}
+
+// xorshift,避免 <random> 的分布开销影响结果
+std::uint64_t nextRandom(std::uint64_t &state) {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return state;
+}
+
+template<typename Cache>
+void run(Cache &cache, std::size_t operations, std::uint64_t seed) {
+    std::uint64_t state = seed | 1;
+    for (std::size_t i = 0; i < operations; ++i) {
+        // 平方偏斜:小 key 更热
+        std::uint64_t r = nextRandom(state) % (kCapacity * 2);
+        int key = static_cast<int>(r * r / (kCapacity * 2) * 2);
+        if (!cache.get(key)) cache.put(key, Value{});
+    }
+}
+
+template<typename Cache>
+double measure(Mode mode, std::size_t threads, std::size_t operations) {
+    SynchronizedNodePoolResource shared;
+    std::vector<std::unique_ptr<NodePoolResource>> pools;
+    std::vector<std::unique_ptr<Cache>> caches;
+    for (std::size_t t = 0; t < threads; ++t) {
+        std::pmr::memory_resource *resource = std::pmr::get_default_resource();
+        if (mode == Mode::Exclusive) {
+            pools.push_back(std::make_unique<NodePoolResource>());
+            resource = pools.back().get();
+        } else if (mode == Mode::Shared) {
+            resource = &shared;
+        }
+        caches.push_back(std::make_unique<Cache>(kCapacity, resource));
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (std::size_t t = 0; t < threads; ++t) {
+        workers.emplace_back([&caches, t, operations] { run(*caches[t], operations, 0x9e3779b97f4a7c15ULL * (t + 1)); });
+    }
+    for (auto &worker: workers) worker.join();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    caches.clear();  // 先销毁缓存,再销毁节点池
+    return static_cast<double>(operations * threads) / elapsed.count();
+}
+
+template<typename Cache>
+void report(const char *policy, std::size_t maxThreads, std::size_t operations) {
+    for (std::size_t threads = 1; threads <= maxThreads; threads *= 2) {
+        for (Mode mode: {Mode::Default, Mode::Exclusive, Mode::Shared}) {
+            double opsPerSecond = measure<Cache>(mode, threads, operations);
+            std::printf("%-8s %-12s threads=%-3zu %12.0f ops/s\n", policy, modeName(mode), threads, opsPerSecond);
+        }
+    }
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    std::size_t operations = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 200000;
+    std::size_t maxThreads = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : std::max(1u, std::thread::hardware_concurrency());
+    report<LRUCache<int, Value>>("LRU", maxThreads, operations);
+    report<SIEVECache<int, Value>>("SIEVE", maxThreads, operations);
+    report<TinyLFUCache<int, Value>>("TinyLFU", maxThreads, operations);
+    report<ARCCache<int, Value>>("ARC", maxThreads, operations);
+    return 0;
+}
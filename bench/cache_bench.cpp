@@ -0,0 +1,254 @@
+// 各策略在不同负载与线程数下的吞吐、延迟分位数与命中率,以 JSON 输出到标准输出,便于在版本之间比较
+// - 单线程直接测策略本身(wrapper = "none"),并按线程数扫描 ConcurrentCache 与 ShardedConcurrentCache;
+//   FIFO 与 Random 另外扫描读路径无锁的 LockFreeReadCache(wrapper = "lock-free")
+// - 操作序列在计时前生成;每次操作单独计时,吞吐按总墙钟时间计算(包含计时本身的开销)
+// 用法:CacheBench [--ops 每线程操作数] [--threads 最大线程数] [--capacity 容量] [--keys key 空间]
+//                 [--skew Zipf 偏斜] [--write-ratio 写比例] [--policy 名称] [--workload 名称]
+#include "Policies.hpp"
+#include "Workload.hpp"
+#include "../include/ConcurrentCache/ConcurrentCache.hpp"
+#include "../include/ConcurrentCache/LockFreeReadCache.hpp"
+#include "../include/ConcurrentCache/ShardedConcurrentCache.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace {
+
+struct Options {
+    std::size_t operations = 200000;
+    std::size_t maxThreads = std::max(1u, std::thread::hardware_concurrency());
+    std::size_t capacity = 10000;
+    std::size_t keySpace = 100000;
+    double skew = 0.99;
+    double writeRatio = 0.25;
+    std::string policy;    // 为空表示全部
+    std::string workload;  // 为空表示全部
+};
+
+struct Result {
+    double opsPerSecond = 0;
+    std::uint64_t p50 = 0;
+    std::uint64_t p99 = 0;
+    std::uint64_t p999 = 0;
+    double hitRatio = 0;
+};
+
+std::uint64_t percentile(const std::vector<std::uint32_t> &sorted, double q) {
+    if (sorted.empty()) return 0;
+    return sorted[static_cast<std::size_t>(q * static_cast<double>(sorted.size() - 1))];
+}
+
+/// 每个线程执行自己的操作序列;get 未命中时写回
+template<typename V, typename Cache>
+Result measure(Cache &cache, const std::vector<std::vector<Op>> &streams) {
+    std::vector<std::vector<std::uint32_t>> latencies(streams.size());
+    std::vector<std::uint64_t> hits(streams.size(), 0);
+    std::vector<std::uint64_t> reads(streams.size(), 0);
+
+    auto worker = [&](std::size_t t) {
+        const auto &ops = streams[t];
+        auto &lat = latencies[t];
+        lat.resize(ops.size());
+        std::uint64_t hit = 0;
+        std::uint64_t read = 0;
+        for (std::size_t i = 0; i < ops.size(); ++i) {
+            auto start = std::chrono::steady_clock::now();
+            if (ops[i].write) {
+                cache.put(ops[i].key, makeValue<V>(ops[i].key));
+            } else {
+                ++read;
+                if (cache.get(ops[i].key)) ++hit;
+                else cache.put(ops[i].key, makeValue<V>(ops[i].key));
+            }
+            auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+            lat[i] = static_cast<std::uint32_t>(std::min<std::int64_t>(ns, std::numeric_limits<std::uint32_t>::max()));
+        }
+        hits[t] = hit;
+        reads[t] = read;
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    if (streams.size() == 1) {
+        worker(0);
+    } else {
+        std::vector<std::thread> threads;
+        for (std::size_t t = 0; t < streams.size(); ++t) threads.emplace_back(worker, t);
+        for (auto &thread: threads) thread.join();
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    std::vector<std::uint32_t> all;
+    std::uint64_t totalHits = 0;
+    std::uint64_t totalReads = 0;
+    for (std::size_t t = 0; t < streams.size(); ++t) {
+        all.insert(all.end(), latencies[t].begin(), latencies[t].end());
+        totalHits += hits[t];
+        totalReads += reads[t];
+    }
+    std::sort(all.begin(), all.end());
+
+    Result result;
+    result.opsPerSecond = static_cast<double>(all.size()) / elapsed.count();
+    result.p50 = percentile(all, 0.5);
+    result.p99 = percentile(all, 0.99);
+    result.p999 = percentile(all, 0.999);
+    result.hitRatio = totalReads == 0 ? 0.0 : static_cast<double>(totalHits) / static_cast<double>(totalReads);
+    return result;
+}
+
+class Reporter {
+private:
+    bool m_first = true;
+
+public:
+    explicit Reporter(const Options &options) {
+        std::printf("{\n  \"benchmark\": \"CacheBench\",\n"
+                    "  \"config\": {\"operationsPerThread\": %zu, \"maxThreads\": %zu, \"capacity\": %zu, "
+                    "\"keySpace\": %zu, \"skew\": %.3f, \"writeRatio\": %.3f},\n"
+                    "  \"results\": [",
+                    options.operations, options.maxThreads, options.capacity, options.keySpace,
+                    options.skew, options.writeRatio);
+    }
+
+    ~Reporter() {
+        std::printf("\n  ]\n}\n");
+    }
+
+    void add(const char *policy, const char *wrapper, const WorkloadSpec &workload, std::size_t threads,
+             const Result &r) {
+        std::printf("%s\n    {\"policy\": \"%s\", \"wrapper\": \"%s\", \"workload\": \"%s\", \"threads\": %zu, "
+                    "\"opsPerSecond\": %.0f, \"latencyNanos\": {\"p50\": %llu, \"p99\": %llu, \"p999\": %llu}, "
+                    "\"hitRatio\": %.5f}",
+                    m_first ? "" : ",", policy, wrapper, workload.name.c_str(), threads, r.opsPerSecond,
+                    static_cast<unsigned long long>(r.p50), static_cast<unsigned long long>(r.p99),
+                    static_cast<unsigned long long>(r.p999), r.hitRatio);
+        std::fflush(stdout);
+        m_first = false;
+    }
+};
+
+std::vector<std::vector<Op>> makeStreams(const WorkloadSpec &workload, const Options &options,
+                                         const ZipfTable &zipf, std::size_t threads) {
+    std::vector<std::vector<Op>> streams;
+    for (std::size_t t = 0; t < threads; ++t) {
+        WorkloadGenerator generator(workload, options.keySpace, &zipf, 0x9e3779b97f4a7c15ULL * (t + 1));
+        streams.push_back(generator.generate(options.operations));
+    }
+    return streams;
+}
+
+/// 1, 2, 4, ... 直到 maxThreads(maxThreads 不是 2 的幂时最后补上它本身)
+std::vector<std::size_t> threadCounts(std::size_t maxThreads) {
+    std::vector<std::size_t> counts;
+    for (std::size_t n = 1; n < maxThreads; n *= 2) counts.push_back(n);
+    counts.push_back(maxThreads);
+    return counts;
+}
+
+/// 有读路径无锁实现的策略(见 LockFreeReadCache.hpp)
+template<typename Policy>
+struct LockFreeCounterpart {
+    using type = void;
+};
+
+template<typename V>
+struct LockFreeCounterpart<FIFOCache<Key, V>> {
+    using type = LockFreeFIFOCache<Key, V>;
+};
+
+template<typename V>
+struct LockFreeCounterpart<RandomReplacementCache<Key, V>> {
+    using type = LockFreeRandomCache<Key, V>;
+};
+
+template<typename Policy, typename V>
+void benchPolicy(const char *name, const Options &options, const std::vector<WorkloadSpec> &workloads,
+                 Reporter &reporter) {
+    if (!options.policy.empty() && options.policy != name) return;
+    for (const auto &workload: workloads) {
+        ZipfTable zipf(options.keySpace, workload.skew);
+        {
+            Policy cache(options.capacity);
+            reporter.add(name, "none", workload, 1, measure<V>(cache, makeStreams(workload, options, zipf, 1)));
+        }
+        for (std::size_t threads: threadCounts(options.maxThreads)) {
+            auto streams = makeStreams(workload, options, zipf, threads);
+            {
+                ConcurrentCache<Key, V, Policy> cache(options.capacity);
+                reporter.add(name, "concurrent", workload, threads, measure<V>(cache, streams));
+            }
+            {
+                ShardedConcurrentCache<Key, V, Policy> cache(options.capacity);
+                reporter.add(name, "sharded", workload, threads, measure<V>(cache, streams));
+            }
+            using LockFree = typename LockFreeCounterpart<Policy>::type;
+            if constexpr (!std::is_void_v<LockFree>) {
+                LockFree cache(options.capacity);
+                reporter.add(name, "lock-free", workload, threads, measure<V>(cache, streams));
+            }
+        }
+    }
+}
+
+std::vector<WorkloadSpec> makeWorkloads(const Options &options) {
+    std::vector<WorkloadSpec> workloads;
+    workloads.push_back({"uniform", Distribution::Uniform, 0, options.writeRatio});
+    workloads.push_back({"zipf", Distribution::Zipf, options.skew, options.writeRatio});
+    workloads.push_back({"zipf-read-only", Distribution::Zipf, options.skew, 0.0});
+    // 20% 的操作是长度为容量一半的一次性扫描
+    workloads.push_back({"scan-mix", Distribution::Zipf, options.skew, options.writeRatio, 0.2,
+                         std::max<std::size_t>(1, options.capacity / 2)});
+    // 每 capacity 次操作热点平移一次
+    workloads.push_back({"hot-churn", Distribution::Zipf, options.skew, options.writeRatio, 0.0, 0,
+                         std::max<std::size_t>(1, options.capacity)});
+    if (options.workload.empty()) return workloads;
+    std::erase_if(workloads, [&](const WorkloadSpec &w) { return w.name != options.workload; });
+    return workloads;
+}
+
+bool parse(int argc, char **argv, Options &options) {
+    for (int i = 1; i + 1 < argc; i += 2) {
+        const char *flag = argv[i];
+        const char *value = argv[i + 1];
+        if (std::strcmp(flag, "--ops") == 0) options.operations = std::strtoull(value, nullptr, 10);
+        else if (std::strcmp(flag, "--threads") == 0) options.maxThreads = std::strtoull(value, nullptr, 10);
+        else if (std::strcmp(flag, "--capacity") == 0) options.capacity = std::strtoull(value, nullptr, 10);
+        else if (std::strcmp(flag, "--keys") == 0) options.keySpace = std::strtoull(value, nullptr, 10);
+        else if (std::strcmp(flag, "--skew") == 0) options.skew = std::strtod(value, nullptr);
+        else if (std::strcmp(flag, "--write-ratio") == 0) options.writeRatio = std::strtod(value, nullptr);
+        else if (std::strcmp(flag, "--policy") == 0) options.policy = value;
+        else if (std::strcmp(flag, "--workload") == 0) options.workload = value;
+        else return false;
+    }
+    return argc % 2 == 1 && options.operations > 0 && options.maxThreads > 0 && options.capacity > 0 &&
+           options.keySpace > 0;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    Options options;
+    if (!parse(argc, argv, options)) {
+        std::fprintf(stderr, "usage: CacheBench [--ops N] [--threads N] [--capacity N] [--keys N] [--skew X] "
+                             "[--write-ratio X] [--policy NAME] [--workload NAME]\n");
+        return 2;
+    }
+    auto workloads = makeWorkloads(options);
+    Reporter reporter(options);
+    forEachPolicy([&]<typename Policy, typename V>(const char *name) {
+        benchPolicy<Policy, V>(name, options, workloads, reporter);
+    });
+    return 0;
+}
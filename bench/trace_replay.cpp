@@ -0,0 +1,173 @@
+// 把 key 访问序列(trace)回放到各策略上,报告命中率;同一遍扫描中计算 LRU 的 miss-ratio curve
+// - trace 通过内存映射流式读取(见 Trace.hpp),多 GB 的 trace 不需要放进内存
+// - 回放:每条访问先 get,未命中时 put(read-through);每个 (策略, 容量) 组合一个缓存,同一遍扫描中一起回放
+// - miss-ratio curve:Mattson 栈距离,--sample-rate/--max-keys 开启 SHARDS 采样(见 MissRatioCurve.hpp)
+// 结果以 JSON 输出到标准输出,进度输出到标准错误
+// 用法:TraceReplay <trace> [--format binary|csv] [--column N] [--header] [--capacity N]... [--policy 名称]
+//                  [--sample-rate R] [--max-keys N] [--points N] [--no-mrc]
+#include "Policies.hpp"
+#include "../include/Cache/MissRatioCurve.hpp"
+#include "../include/Cache/Trace.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Options {
+    std::string path;
+    TraceFormat format = TraceFormat::Binary;
+    bool formatGiven = false;
+    std::size_t column = 0;
+    bool header = false;
+    std::vector<std::size_t> capacities;
+    std::string policy;  // 为空表示全部
+    bool curve = true;
+    double sampleRate = 1.0;
+    std::size_t maxKeys = 0;
+    std::size_t points = 32;
+};
+
+/// 一个 (策略, 容量) 组合的回放状态;access 返回是否命中
+struct Simulation {
+    const char *policy;
+    std::size_t capacity;
+    std::function<bool(Key)> access;
+    std::uint64_t hits = 0;
+};
+
+std::vector<Simulation> makeSimulations(const Options &options) {
+    std::vector<Simulation> simulations;
+    forEachPolicy([&]<typename Policy, typename V>(const char *name) {
+        if (!options.policy.empty() && options.policy != name) return;
+        for (std::size_t capacity: options.capacities) {
+            auto cache = std::make_shared<Policy>(capacity);
+            simulations.push_back({name, capacity, [cache](Key key) {
+                if (cache->get(key)) return true;
+                cache->put(key, makeValue<V>(key));
+                return false;
+            }});
+        }
+    });
+    return simulations;
+}
+
+/// 从 1 到 maxCapacity 按几何级数取 points 个容量,并加上显式给出的容量
+std::vector<std::size_t> curveCapacities(const Options &options, std::uint64_t maxCapacity) {
+    std::vector<std::size_t> capacities(options.capacities);
+    maxCapacity = std::max<std::uint64_t>(1, maxCapacity);
+    for (std::size_t i = 0; i < options.points; ++i) {
+        double exponent = options.points == 1 ? 1.0 : static_cast<double>(i) / static_cast<double>(options.points - 1);
+        capacities.push_back(static_cast<std::size_t>(std::llround(std::pow(static_cast<double>(maxCapacity), exponent))));
+    }
+    std::sort(capacities.begin(), capacities.end());
+    capacities.erase(std::unique(capacities.begin(), capacities.end()), capacities.end());
+    return capacities;
+}
+
+bool parse(int argc, char **argv, Options &options) {
+    if (argc < 2) return false;
+    options.path = argv[1];
+    for (int i = 2; i < argc; ++i) {
+        const char *flag = argv[i];
+        if (std::strcmp(flag, "--header") == 0) {
+            options.header = true;
+            continue;
+        }
+        if (std::strcmp(flag, "--no-mrc") == 0) {
+            options.curve = false;
+            continue;
+        }
+        if (i + 1 >= argc) return false;
+        const char *value = argv[++i];
+        if (std::strcmp(flag, "--format") == 0) {
+            if (std::strcmp(value, "binary") == 0) options.format = TraceFormat::Binary;
+            else if (std::strcmp(value, "csv") == 0) options.format = TraceFormat::Csv;
+            else return false;
+            options.formatGiven = true;
+        } else if (std::strcmp(flag, "--column") == 0) {
+            options.column = std::strtoull(value, nullptr, 10);
+        } else if (std::strcmp(flag, "--capacity") == 0) {
+            std::size_t capacity = std::strtoull(value, nullptr, 10);
+            if (capacity == 0) return false;
+            options.capacities.push_back(capacity);
+        } else if (std::strcmp(flag, "--policy") == 0) {
+            options.policy = value;
+        } else if (std::strcmp(flag, "--sample-rate") == 0) {
+            options.sampleRate = std::strtod(value, nullptr);
+            if (!(options.sampleRate > 0.0) || options.sampleRate > 1.0) return false;
+        } else if (std::strcmp(flag, "--max-keys") == 0) {
+            options.maxKeys = std::strtoull(value, nullptr, 10);
+        } else if (std::strcmp(flag, "--points") == 0) {
+            options.points = std::strtoull(value, nullptr, 10);
+        } else {
+            return false;
+        }
+    }
+    if (!options.formatGiven) options.format = TraceReader::formatOf(options.path);
+    return options.curve || !options.capacities.empty();
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    Options options;
+    if (!parse(argc, argv, options)) {
+        std::fprintf(stderr, "usage: TraceReplay <trace> [--format binary|csv] [--column N] [--header] "
+                             "[--capacity N]... [--policy NAME] [--sample-rate R] [--max-keys N] [--points N] "
+                             "[--no-mrc]\n");
+        return 2;
+    }
+    try {
+        TraceReader reader(options.path, options.format, options.column, options.header);
+        auto simulations = makeSimulations(options);
+        MissRatioCurveBuilder builder(options.sampleRate, options.maxKeys);
+
+        std::uint64_t references = 0;
+        Key key;
+        while (reader.next(key)) {
+            ++references;
+            for (auto &simulation: simulations) simulation.hits += simulation.access(key) ? 1 : 0;
+            if (options.curve) builder.access(key);
+            if ((references & ((std::uint64_t{1} << 24) - 1)) == 0)
+                std::fprintf(stderr, "\r%5.1f%% %llu references", 100.0 * reader.progress(),
+                             static_cast<unsigned long long>(references));
+        }
+        if (references >= (std::uint64_t{1} << 24)) std::fprintf(stderr, "\n");
+
+        std::printf("{\n  \"trace\": \"%s\",\n  \"references\": %llu,\n  \"replay\": [", options.path.c_str(),
+                    static_cast<unsigned long long>(references));
+        for (std::size_t i = 0; i < simulations.size(); ++i) {
+            const auto &s = simulations[i];
+            double hitRatio = references == 0 ? 0.0 : static_cast<double>(s.hits) / static_cast<double>(references);
+            std::printf("%s\n    {\"policy\": \"%s\", \"capacity\": %zu, \"hitRatio\": %.5f}", i == 0 ? "" : ",",
+                        s.policy, s.capacity, hitRatio);
+        }
+        std::printf("\n  ]");
+        if (options.curve) {
+            MissRatioCurve curve = builder.build();
+            std::printf(",\n  \"missRatioCurve\": {\"policy\": \"LRU\", \"sampleRate\": %.6f, \"trackedKeys\": %zu, "
+                        "\"points\": [", builder.sampleRate(), builder.trackedKeys());
+            auto capacities = curveCapacities(options, curve.maxDistance());
+            for (std::size_t i = 0; i < capacities.size(); ++i) {
+                std::printf("%s\n    {\"capacity\": %zu, \"missRatio\": %.5f}", i == 0 ? "" : ",", capacities[i],
+                            curve.missRatio(capacities[i]));
+            }
+            std::printf("\n  ]}");
+        }
+        std::printf("\n}\n");
+    } catch (const std::exception &e) {
+        std::fprintf(stderr, "TraceReplay: %s\n", e.what());
+        return 1;
+    }
+    return 0;
+}
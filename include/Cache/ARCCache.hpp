@@ -0,0 +1,282 @@
+#ifndef CACHE_ARCCACHE_HPP
+#define CACHE_ARCCACHE_HPP
+
+#include "Cache.hpp"
+#include "GhostList.hpp"
+#include "HashIndex.hpp"
+#include "Removal.hpp"
+#include "Stats.hpp"
+#include "Utility.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory_resource>
+#include <stdexcept>
+#include <type_traits>
+
+/// ARC(Adaptive Replacement Cache)策略缓存
+/// - T1:只被访问过一次的常驻元素(偏重最近性);T2:至少访问过两次的常驻元素(偏重频率)
+/// - B1/B2:分别从 T1/T2 淘汰出去的幽灵项,只记录 key 的哈希
+/// - 目标值 p 是 T1 的期望大小:新 key 命中 B1 说明 T1 太小,p 增大;命中 B2 则 p 减小,
+///   从而在最近性与频率之间在线自适应,无需预先在 LRU 与 LFU 之间做选择
+/// 常驻元素最多 capacity 个,幽灵项最多 capacity 个
+/// 容量 > 0;Index 为 key 索引容器选择器(见 HashIndex.hpp)
+/// Stats 为统计器(见 Stats.hpp),默认 NoStats 不做任何统计
+/// 调用 collectRemovals 后,被淘汰、删除、替换或拒绝的条目移入批次而不是就地析构(见 Removal.hpp)
+/// get/peek/erase/contains 另有异构重载(见 KeyTraits.hpp)
+/// 所有节点容器从构造时给出的 std::pmr::memory_resource 分配(默认为全局分配器,见 NodePool.hpp)
+template<typename K, typename V, typename Index = StdHashIndex, typename Stats = NoStats>
+class ARCCache : public CacheBase<ARCCache<K, V, Index, Stats>, K, V> {
+private:
+    static_assert(
+            std::is_default_constructible_v<std::hash<K>>,
+            "Key type K must be hashable: provide specialization of std::hash<K> if needed"
+    );
+    struct Entry {
+        K key;
+        V value;
+        bool frequent;  // true 表示位于 T2
+    };
+    using List = std::pmr::list<Entry>;  // front 为 LRU,back 为 MRU
+
+    std::size_t m_capacity;
+    std::size_t m_p = 0;  // T1 的目标大小
+    List m_t1;
+    List m_t2;
+    GhostList m_b1;
+    GhostList m_b2;
+    typename Index::template map<K, typename List::iterator> m_map;
+    [[no_unique_address]] mutable Stats m_stats;
+    RemovalSink<K, V> m_removals;
+
+    static std::uint64_t hashOf(const K &key) {
+        return mixHash(static_cast<std::uint64_t>(std::hash<K>{}(key)));
+    }
+
+    // 命中常驻元素:移到 T2 的 MRU 端
+    void onHit(typename List::iterator it) {
+        if (it->frequent) {
+            m_t2.splice(m_t2.end(), m_t2, it);
+        } else {
+            it->frequent = true;
+            m_t2.splice(m_t2.end(), m_t1, it);
+        }
+    }
+
+    void evictTo(List &list, GhostList &ghost) {
+        auto victim = list.begin();
+        ghost.pushBack(hashOf(victim->key));
+        m_map.erase(victim->key);
+        if (m_removals) m_removals.push(std::move(victim->key), std::move(victim->value), RemovalCause::Capacity);
+        list.erase(victim);
+        m_stats.recordEviction(EvictionCause::Size);
+    }
+
+    // REPLACE:常驻元素已满时,按目标值 p 从 T1 或 T2 淘汰一个到对应幽灵队列
+    void replace(bool hitInB2) {
+        if (m_t1.size() + m_t2.size() < m_capacity) return;
+        if (!m_t1.empty() && (m_t1.size() > m_p || (hitInB2 && m_t1.size() == m_p))) {
+            evictTo(m_t1, m_b1);
+        } else if (!m_t2.empty()) {
+            evictTo(m_t2, m_b2);
+        } else {
+            evictTo(m_t1, m_b1);
+        }
+    }
+
+    template<typename KK, typename VV>
+    void append(List &list, KK &&key, VV &&value, bool frequent) {
+        list.push_back(Entry{std::forward<KK>(key), std::forward<VV>(value), frequent});
+        m_map[list.back().key] = std::prev(list.end());
+    }
+
+    template<typename Q>
+    const V *access(const Q &key) {
+        auto it = m_map.find(key);
+        if (it == m_map.end()) {
+            m_stats.recordMiss();
+            return nullptr;
+        }
+        m_stats.recordHit();
+        auto lit = it->second;
+        onHit(lit);
+        return &lit->value;
+    }
+
+    template<typename Q>
+    const V *lookup(const Q &key) const {
+        auto it = m_map.find(key);
+        if (it == m_map.end())
+            return nullptr;
+        return &it->second->value;
+    }
+
+    template<typename KK, typename VV>
+    void insert(KK &&key, VV &&value) {
+        m_stats.recordPut();
+        auto it = m_map.find(key);
+        if (it != m_map.end()) {
+            auto lit = it->second;
+            if (m_removals) m_removals.push(lit->key, std::move(lit->value), RemovalCause::Replaced);
+            lit->value = std::forward<VV>(value);
+            onHit(lit);
+            return;
+        }
+        std::uint64_t h = hashOf(key);
+        if (m_b1.contains(h)) {
+            // 幽灵命中 B1:偏向最近性
+            std::size_t delta = std::max<std::size_t>(1, m_b2.size() / m_b1.size());
+            m_p = std::min(m_capacity, m_p + delta);
+            replace(false);
+            m_b1.erase(h);
+            append(m_t2, std::forward<KK>(key), std::forward<VV>(value), true);
+            return;
+        }
+        if (m_b2.contains(h)) {
+            // 幽灵命中 B2:偏向频率
+            std::size_t delta = std::max<std::size_t>(1, m_b1.size() / m_b2.size());
+            m_p = m_p > delta ? m_p - delta : 0;
+            replace(true);
+            m_b2.erase(h);
+            append(m_t2, std::forward<KK>(key), std::forward<VV>(value), true);
+            return;
+        }
+        // 全新 key
+        std::size_t l1 = m_t1.size() + m_b1.size();
+        std::size_t total = l1 + m_t2.size() + m_b2.size();
+        if (l1 >= m_capacity) {
+            if (m_t1.size() < m_capacity) {
+                m_b1.popFront();
+                replace(false);
+            } else {
+                // B1 为空且 T1 已满:直接丢弃 T1 的 LRU,不留幽灵
+                auto victim = m_t1.begin();
+                m_map.erase(victim->key);
+                if (m_removals) m_removals.push(std::move(victim->key), std::move(victim->value), RemovalCause::Capacity);
+                m_t1.erase(victim);
+                m_stats.recordEviction(EvictionCause::Size);
+            }
+        } else if (total >= m_capacity) {
+            if (total >= 2 * m_capacity) m_b2.popFront();
+            replace(false);
+        }
+        append(m_t1, std::forward<KK>(key), std::forward<VV>(value), false);
+    }
+
+    template<typename Q>
+    void remove(const Q &key) {
+        auto it = m_map.find(key);
+        if (it == m_map.end()) return;
+        auto lit = it->second;
+        m_map.erase(it);
+        if (m_removals) m_removals.push(std::move(lit->key), std::move(lit->value), RemovalCause::Explicit);
+        (lit->frequent ? m_t2 : m_t1).erase(lit);
+    }
+
+public:
+    explicit ARCCache(std::size_t capacity, std::pmr::memory_resource *resource = std::pmr::get_default_resource())
+            : m_capacity(capacity), m_t1(resource), m_t2(resource), m_b1(resource), m_b2(resource), m_map(resource) {
+        if (capacity == 0) throw std::invalid_argument("ARCCache capacity must be > 0");
+    }
+
+    void put(const K &key, const V &value) {
+        insert(key, value);
+    }
+
+    void put(K &&key, V &&value) {
+        insert(std::move(key), std::move(value));
+    }
+
+    std::optional<V> get(const K &key) {
+        return optionalOf(access(key));
+    }
+
+    template<LookupKey<K> Q>
+    std::optional<V> get(const Q &key) {
+        return optionalOf(access(key));
+    }
+
+    const V *find(const K &key) {
+        return access(key);
+    }
+
+    /// 只读查找,不调整顺序;供并发装饰器在读锁下调用
+    [[nodiscard]] std::optional<V> peek(const K &key) const {
+        return optionalOf(lookup(key));
+    }
+
+    template<LookupKey<K> Q>
+    [[nodiscard]] std::optional<V> peek(const Q &key) const {
+        return optionalOf(lookup(key));
+    }
+
+    /// 与 peek 相同,但返回指向缓存内值的指针而不复制
+    [[nodiscard]] const V *peekValue(const K &key) const {
+        return lookup(key);
+    }
+
+    template<LookupKey<K> Q>
+    [[nodiscard]] const V *peekValue(const Q &key) const {
+        return lookup(key);
+    }
+
+    /// 记录一次命中:移到 T2 的 MRU 端;key 不存在时无操作
+    void touch(const K &key) {
+        auto it = m_map.find(key);
+        if (it != m_map.end()) onHit(it->second);
+    }
+
+    void erase(const K &key) {
+        remove(key);
+    }
+
+    template<LookupKey<K> Q>
+    void erase(const Q &key) {
+        remove(key);
+    }
+
+    void prefetch(const K &key) const {
+        prefetchIndex(m_map, key);
+    }
+
+    [[nodiscard]] bool contains(const K &key) const {
+        return m_map.count(key) != 0;
+    }
+
+    template<LookupKey<K> Q>
+    [[nodiscard]] bool contains(const Q &key) const {
+        return m_map.count(key) != 0;
+    }
+
+    [[nodiscard]] std::size_t size() const {
+        return m_map.size();
+    }
+
+    /// 被移除条目的去处(见 Removal.hpp);nullptr(默认)表示就地析构
+    void collectRemovals(RemovalBatch<K, V> *batch) noexcept {
+        m_removals.attach(batch);
+    }
+
+    [[nodiscard]] RemovalBatch<K, V> *removalBatch() const noexcept {
+        return m_removals.batch();
+    }
+
+    /// 统计器(见 Stats.hpp)
+    [[nodiscard]] Stats &statsRecorder() const noexcept {
+        return m_stats;
+    }
+
+    /// 节点容器使用的内存资源
+    [[nodiscard]] std::pmr::memory_resource *resource() const noexcept {
+        return m_map.get_allocator().resource();
+    }
+
+    /// 当前 T1 目标大小(用于观察自适应过程)
+    [[nodiscard]] std::size_t target() const noexcept {
+        return m_p;
+    }
+};
+
+#endif //CACHE_ARCCACHE_HPP
@@ -0,0 +1,44 @@
+#ifndef CACHE_ADMISSION_HPP
+#define CACHE_ADMISSION_HPP
+
+#include "FrequencySketch.hpp"
+#include <cstddef>
+
+/// ComposedCache 的准入策略选择器,作为 Admission 模板参数传入
+/// 选择器需提供成员类模板 policy<K>,以容量构造,并提供:
+/// - record(key):记录一次访问或插入尝试
+/// - admit(candidate, victim) -> bool:淘汰 victim 为 candidate 腾出空间之前询问;返回 false 时放弃插入 candidate
+
+/// 总是准入
+struct AlwaysAdmit {
+    template<typename K>
+    class policy {
+    public:
+        explicit policy(std::size_t) noexcept {}
+
+        void record(const K &) noexcept {}
+
+        [[nodiscard]] bool admit(const K &, const K &) const noexcept { return true; }
+    };
+};
+
+/// TinyLFU 准入:候选者的估计频率严格高于牺牲者时才准入(见 FrequencySketch.hpp)
+struct TinyLFUAdmission {
+    template<typename K>
+    class policy {
+    private:
+        FrequencySketch<K> m_sketch;
+
+    public:
+        explicit policy(std::size_t capacity)
+                : m_sketch(capacity) {}
+
+        void record(const K &key) { m_sketch.increment(key); }
+
+        [[nodiscard]] bool admit(const K &candidate, const K &victim) const {
+            return m_sketch.frequency(candidate) > m_sketch.frequency(victim);
+        }
+    };
+};
+
+#endif //CACHE_ADMISSION_HPP
@@ -0,0 +1,126 @@
+#ifndef CACHE_BLOCKFILE_HPP
+#define CACHE_BLOCKFILE_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/types.h>
+#include <unistd.h>
+#endif
+
+/// 定长的读写文件,按绝对偏移读写(POSIX 下为 pread/pwrite,Windows 下为带 OVERLAPPED 的 ReadFile/WriteFile)
+/// 读写不共享文件位置,因此多个线程可以同时 read;构造时创建或截断文件并预分配到 size 字节
+/// 打开、预分配或读写失败时抛出 std::runtime_error
+class BlockFile {
+private:
+#if defined(_WIN32)
+    HANDLE m_handle = INVALID_HANDLE_VALUE;
+#else
+    int m_fd = -1;
+#endif
+    std::string m_path;
+
+    void close() noexcept {
+#if defined(_WIN32)
+        if (m_handle != INVALID_HANDLE_VALUE) CloseHandle(m_handle);
+        m_handle = INVALID_HANDLE_VALUE;
+#else
+        if (m_fd >= 0) ::close(m_fd);
+        m_fd = -1;
+#endif
+    }
+
+public:
+    BlockFile(std::string path, std::uint64_t size) : m_path(std::move(path)) {
+#if defined(_WIN32)
+        m_handle = CreateFileA(m_path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr, CREATE_ALWAYS,
+                               FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (m_handle == INVALID_HANDLE_VALUE) throw std::runtime_error("BlockFile: cannot open " + m_path);
+        LARGE_INTEGER end;
+        end.QuadPart = static_cast<LONGLONG>(size);
+        if (!SetFilePointerEx(m_handle, end, nullptr, FILE_BEGIN) || !SetEndOfFile(m_handle)) {
+            close();
+            throw std::runtime_error("BlockFile: cannot resize " + m_path);
+        }
+#else
+        m_fd = ::open(m_path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0600);
+        if (m_fd < 0) throw std::runtime_error("BlockFile: cannot open " + m_path);
+        if (::ftruncate(m_fd, static_cast<off_t>(size)) != 0) {
+            close();
+            throw std::runtime_error("BlockFile: cannot resize " + m_path);
+        }
+#endif
+    }
+
+    BlockFile(const BlockFile &) = delete;
+
+    BlockFile &operator=(const BlockFile &) = delete;
+
+    ~BlockFile() {
+        close();
+    }
+
+    /// 从 offset 处读 size 字节
+    void read(void *data, std::size_t size, std::uint64_t offset) const {
+        char *out = static_cast<char *>(data);
+        while (size > 0) {
+#if defined(_WIN32)
+            OVERLAPPED at{};
+            at.Offset = static_cast<DWORD>(offset);
+            at.OffsetHigh = static_cast<DWORD>(offset >> 32);
+            DWORD done = 0;
+            DWORD chunk = static_cast<DWORD>(std::min<std::size_t>(size, 1u << 30));
+            if (!ReadFile(m_handle, out, chunk, &done, &at) || done == 0)
+                throw std::runtime_error("BlockFile: cannot read " + m_path);
+#else
+            ssize_t done = ::pread(m_fd, out, size, static_cast<off_t>(offset));
+            if (done < 0 && errno == EINTR) continue;
+            if (done <= 0) throw std::runtime_error("BlockFile: cannot read " + m_path);
+#endif
+            out += done;
+            size -= static_cast<std::size_t>(done);
+            offset += static_cast<std::uint64_t>(done);
+        }
+    }
+
+    /// 把 size 字节写到 offset 处
+    void write(const void *data, std::size_t size, std::uint64_t offset) {
+        const char *in = static_cast<const char *>(data);
+        while (size > 0) {
+#if defined(_WIN32)
+            OVERLAPPED at{};
+            at.Offset = static_cast<DWORD>(offset);
+            at.OffsetHigh = static_cast<DWORD>(offset >> 32);
+            DWORD done = 0;
+            DWORD chunk = static_cast<DWORD>(std::min<std::size_t>(size, 1u << 30));
+            if (!WriteFile(m_handle, in, chunk, &done, &at) || done == 0)
+                throw std::runtime_error("BlockFile: cannot write " + m_path);
+#else
+            ssize_t done = ::pwrite(m_fd, in, size, static_cast<off_t>(offset));
+            if (done < 0 && errno == EINTR) continue;
+            if (done <= 0) throw std::runtime_error("BlockFile: cannot write " + m_path);
+#endif
+            in += done;
+            size -= static_cast<std::size_t>(done);
+            offset += static_cast<std::uint64_t>(done);
+        }
+    }
+
+    [[nodiscard]] const std::string &path() const noexcept {
+        return m_path;
+    }
+};
+
+#endif //CACHE_BLOCKFILE_HPP
@@ -1,31 +1,141 @@
 #ifndef CACHE_CACHE_HPP
 #define CACHE_CACHE_HPP
 
+#include "Stats.hpp"
+#include <concepts>
 #include <cstddef>
 #include <optional>
+#include <span>
+#include <utility>
+#include <vector>
 
-/// 通用缓存接口
-template<typename K, typename V>
-class Cache {
+/// 把指向缓存内值的指针转换为 get 的返回值(复制一次)
+template<typename V>
+std::optional<V> optionalOf(const V *value) {
+    if (value == nullptr) return std::nullopt;
+    return *value;
+}
+
+/// 缓存策略的静态接口;ConcurrentCache 等装饰器按此接口直接调用具体策略,不经过虚函数
+template<typename C, typename K, typename V>
+concept CachePolicy = requires(C &cache, const C &constCache, const K &key, const V &value) {
+    cache.put(key, value);
+    cache.put(std::declval<K &&>(), std::declval<V &&>());
+    { cache.get(key) } -> std::same_as<std::optional<V>>;
+    { cache.find(key) } -> std::same_as<const V *>;
+    cache.erase(key);
+    { constCache.contains(key) } -> std::convertible_to<bool>;
+    { constCache.size() } -> std::convertible_to<std::size_t>;
+};
+
+/// 所有策略的公共基类(CRTP):在 put/get/find/erase/contains 之上提供便捷操作
+/// 本身没有虚函数,具体策略的调用在编译期解析,可以被完全内联
+template<typename Derived, typename K, typename V>
+class CacheBase {
 public:
-    virtual ~Cache() = default;
+    using key_type = K;
+    using mapped_type = V;
+
+    CacheBase() = default;
+
+    CacheBase(const CacheBase &) = delete;
+
+    CacheBase &operator=(const CacheBase &) = delete;
+
+    CacheBase(CacheBase &&) = delete;
+
+    CacheBase &operator=(CacheBase &&) = delete;
 
-    Cache() = default;
+    /// 以 args 构造值后插入或替换 key 对应的值;值只构造一次,之后只被移动
+    template<typename... Args>
+    void emplace(K key, Args &&... args) {
+        self().put(std::move(key), V(std::forward<Args>(args)...));
+    }
 
-    Cache(const Cache &) = delete;
+    /// 仅当 key 不存在时构造值并插入,返回是否插入;key 已存在时不构造值
+    template<typename... Args>
+    bool try_emplace(K key, Args &&... args) {
+        if (self().contains(key)) return false;
+        self().put(std::move(key), V(std::forward<Args>(args)...));
+        return true;
+    }
 
-    Cache &operator=(const Cache &) = delete;
+    /// 访问元素并以 const V& 调用 visitor,不复制值;返回是否命中
+    template<typename F>
+    bool visit(const K &key, F &&visitor) {
+        const V *value = self().find(key);
+        if (value == nullptr) return false;
+        std::forward<F>(visitor)(*value);
+        return true;
+    }
 
-    Cache(Cache &&) = delete;
+    /// 预取 key 在索引中的位置;只是性能提示,默认无操作
+    void prefetch(const K &) const {}
 
-    Cache &operator=(Cache &&) = delete;
+    /// 批量访问:先为所有 key 发出预取,再逐个查找;结果与 keys 一一对应
+    std::vector<std::optional<V>> getMany(std::span<const K> keys) {
+        for (const auto &key: keys) self().prefetch(key);
+        std::vector<std::optional<V>> result;
+        result.reserve(keys.size());
+        for (const auto &key: keys) result.push_back(self().get(key));
+        return result;
+    }
+
+    /// 批量插入或更新,按给定顺序生效
+    void putMany(std::span<const std::pair<K, V>> entries) {
+        for (const auto &entry: entries) self().prefetch(entry.first);
+        for (const auto &entry: entries) self().put(entry.first, entry.second);
+    }
+
+    /// 批量删除
+    void eraseMany(std::span<const K> keys) {
+        for (const auto &key: keys) self().prefetch(key);
+        for (const auto &key: keys) self().erase(key);
+    }
+
+    /// 统计快照,附上当前条目数与计费总和(仅当策略以启用的统计器实例化时可用,见 Stats.hpp)
+    [[nodiscard]] CacheStatsSnapshot stats() const
+    requires StatsRecordingPolicy<Derived> {
+        CacheStatsSnapshot result = self().statsRecorder().snapshot();
+        result.size = self().size();
+        if constexpr (requires { self().totalCharge(); }) {
+            result.charge = self().totalCharge();
+        } else {
+            result.charge = result.size;
+        }
+        return result;
+    }
+
+protected:
+    ~CacheBase() = default;
+
+private:
+    Derived &self() noexcept { return static_cast<Derived &>(*this); }
+
+    const Derived &self() const noexcept { return static_cast<const Derived &>(*this); }
+};
+
+/// 通用缓存接口(类型擦除):需要在运行时切换策略时使用,具体策略经 CacheAdapter 包装后得到
+template<typename K, typename V>
+class Cache : public CacheBase<Cache<K, V>, K, V> {
+public:
+    virtual ~Cache() = default;
 
     /// 插入新元素或更新已有元素
     virtual void put(const K &key, const V &value) = 0;
 
-    /// 访问元素;不存在时抛出 std::out_of_range
+    /// 插入或更新,key 与 value 被移入缓存;默认实现退化为复制
+    virtual void put(K &&key, V &&value) {
+        put(static_cast<const K &>(key), static_cast<const V &>(value));
+    }
+
+    /// 访问元素;不存在时返回 std::nullopt
     virtual std::optional<V> get(const K &key) = 0;
 
+    /// 与 get 一样访问元素(同样记录访问),但返回指向缓存内值的指针而不复制;不存在时返回 nullptr
+    /// 指针只在下一次修改缓存(put/erase/淘汰)之前有效
+    virtual const V *find(const K &key) = 0;
+
     /// 删除元素;不存在时无操作
     virtual void erase(const K &key) = 0;
 
@@ -34,6 +144,65 @@ public:
 
     /// 当前缓存中元素个数
     virtual std::size_t size() const = 0;
+
+    /// 预取 key 在索引中的位置;只是性能提示,默认无操作
+    virtual void prefetch(const K &) const {}
+};
+
+/// 把具体策略包装为 Cache<K,V>:策略按值保存,每个虚函数直接转发
+/// 例:std::unique_ptr<Cache<int, int>> cache = std::make_unique<CacheAdapter<LRUCache<int, int>>>(100);
+template<typename Impl>
+class CacheAdapter final : public Cache<typename Impl::key_type, typename Impl::mapped_type> {
+public:
+    using K = typename Impl::key_type;
+    using V = typename Impl::mapped_type;
+
+private:
+    static_assert(CachePolicy<Impl, K, V>, "Impl must satisfy CachePolicy");
+    Impl m_impl;
+
+public:
+    /// 构造参数原样转发给 Impl
+    template<typename... Args>
+    explicit CacheAdapter(Args &&... args)
+            : m_impl(std::forward<Args>(args)...) {}
+
+    void put(const K &key, const V &value) override {
+        m_impl.put(key, value);
+    }
+
+    void put(K &&key, V &&value) override {
+        m_impl.put(std::move(key), std::move(value));
+    }
+
+    std::optional<V> get(const K &key) override {
+        return m_impl.get(key);
+    }
+
+    const V *find(const K &key) override {
+        return m_impl.find(key);
+    }
+
+    void erase(const K &key) override {
+        m_impl.erase(key);
+    }
+
+    [[nodiscard]] bool contains(const K &key) const override {
+        return m_impl.contains(key);
+    }
+
+    [[nodiscard]] std::size_t size() const override {
+        return m_impl.size();
+    }
+
+    void prefetch(const K &key) const override {
+        m_impl.prefetch(key);
+    }
+
+    /// 被包装的具体策略
+    [[nodiscard]] Impl &impl() noexcept { return m_impl; }
+
+    [[nodiscard]] const Impl &impl() const noexcept { return m_impl; }
 };
 
 #endif //CACHE_CACHE_HPP
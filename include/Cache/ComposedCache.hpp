@@ -0,0 +1,258 @@
+#ifndef CACHE_COMPOSEDCACHE_HPP
+#define CACHE_COMPOSEDCACHE_HPP
+
+#include "Admission.hpp"
+#include "Cache.hpp"
+#include "HashIndex.hpp"
+#include "Ordering.hpp"
+#include "Sizer.hpp"
+#include "Removal.hpp"
+#include "Stats.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory_resource>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+/// 由静态构件组合而成的缓存:索引 × 淘汰顺序 × 准入 × 容量计费
+/// - Ordering:淘汰顺序(见 Ordering.hpp),如 LRUOrdering / FIFOOrdering / SIEVEOrdering
+/// - Admission:准入策略(见 Admission.hpp),如 AlwaysAdmit / TinyLFUAdmission
+/// - Index:key 索引容器选择器(见 HashIndex.hpp)
+/// - Sizer:条目计费器(见 Sizer.hpp),capacity 是计费总和的上限
+/// - Stats:统计器(见 Stats.hpp),默认 NoStats 不做任何统计
+/// 调用 collectRemovals 后,被淘汰、删除、替换或拒绝的条目移入批次而不是就地析构(见 Removal.hpp)
+/// 所有构件都在编译期组合,没有虚函数调用;例如
+/// ComposedCache<K, V, SIEVEOrdering, TinyLFUAdmission, FlatHashIndex> 即带 TinyLFU 准入的 SIEVE
+/// 容量 > 0;get/peek/erase/contains 另有异构重载(见 KeyTraits.hpp)
+/// 所有节点容器从构造时给出的 std::pmr::memory_resource 分配(默认为全局分配器,见 NodePool.hpp)
+template<typename K, typename V, typename Ordering = LRUOrdering, typename Admission = AlwaysAdmit,
+        typename Index = StdHashIndex, typename Sizer = UnitSizer, typename Stats = NoStats>
+class ComposedCache : public CacheBase<ComposedCache<K, V, Ordering, Admission, Index, Sizer, Stats>, K, V> {
+private:
+    static_assert(
+            std::is_default_constructible_v<std::hash<K>>,
+            "Key type K must be hashable: provide specialization of std::hash<K> if needed"
+    );
+    struct Node {
+        K key;
+        V value;
+        std::uint8_t mark = 0;  // 供 Ordering 使用
+
+        template<typename KK, typename VV>
+        Node(KK &&k, VV &&v)
+                : key(std::forward<KK>(k)), value(std::forward<VV>(v)) {}
+    };
+    using List = std::pmr::list<Node>;  // front 为最老的条目
+
+    std::size_t m_capacity;
+    std::size_t m_totalCharge = 0;
+    [[no_unique_address]] Sizer m_sizer;
+    List m_list;
+    typename Index::template map<K, typename List::iterator> m_map;
+    typename Ordering::template policy<List> m_ordering;
+    typename Admission::template policy<K> m_admission;
+    [[no_unique_address]] mutable Stats m_stats;
+    RemovalSink<K, V> m_removals;
+
+    void evict(typename List::iterator it, RemovalCause cause) {
+        m_totalCharge -= m_sizer(it->key, it->value);
+        m_ordering.erasing(m_list, it);
+        m_map.erase(it->key);
+        if (m_removals) m_removals.push(std::move(it->key), std::move(it->value), cause);
+        m_list.erase(it);
+    }
+
+    void onAccess(typename List::iterator it) {
+        m_admission.record(it->key);
+        m_ordering.accessed(m_list, it);
+    }
+
+    template<typename Q>
+    const V *access(const Q &key) {
+        auto it = m_map.find(key);
+        if (it == m_map.end()) {
+            m_stats.recordMiss();
+            return nullptr;
+        }
+        m_stats.recordHit();
+        onAccess(it->second);
+        return &it->second->value;
+    }
+
+    template<typename Q>
+    const V *lookup(const Q &key) const {
+        auto it = m_map.find(key);
+        if (it == m_map.end())
+            return nullptr;
+        return &it->second->value;
+    }
+
+    template<typename Q>
+    void remove(const Q &key) {
+        auto it = m_map.find(key);
+        if (it == m_map.end()) return;
+        evict(it->second, RemovalCause::Explicit);
+    }
+
+    template<typename KK, typename VV>
+    void insert(KK &&key, VV &&value) {
+        m_stats.recordPut();
+        std::size_t charge = m_sizer(key, value);
+        m_admission.record(key);
+        auto it = m_map.find(key);
+        if (charge > m_capacity) {
+            // 超出整个预算:拒绝,同时丢弃旧值
+            if (it != m_map.end()) evict(it->second, RemovalCause::Replaced);
+            m_stats.recordEviction(EvictionCause::Rejected);
+            if (m_removals) m_removals.push(std::forward<KK>(key), std::forward<VV>(value), RemovalCause::Capacity);
+            return;
+        }
+        if (it != m_map.end()) {
+            auto lit = it->second;
+            std::size_t oldCharge = m_sizer(lit->key, lit->value);
+            if (m_totalCharge - oldCharge + charge <= m_capacity) {
+                // 原地更新,视为一次访问
+                if (m_removals) m_removals.push(lit->key, std::move(lit->value), RemovalCause::Replaced);
+                lit->value = std::forward<VV>(value);
+                m_totalCharge = m_totalCharge - oldCharge + charge;
+                m_ordering.accessed(m_list, lit);
+                return;
+            }
+            // 更新后超出预算:按新元素重新插入
+            evict(lit, RemovalCause::Replaced);
+        }
+        while (m_totalCharge + charge > m_capacity) {
+            auto victim = m_ordering.victim(m_list);
+            if (!m_admission.admit(key, victim->key)) {
+                m_stats.recordEviction(EvictionCause::Rejected);
+                if (m_removals) m_removals.push(std::forward<KK>(key), std::forward<VV>(value), RemovalCause::Capacity);
+                return;
+            }
+            evict(victim, RemovalCause::Capacity);
+            m_stats.recordEviction(EvictionCause::Size);
+        }
+        m_list.emplace_back(std::forward<KK>(key), std::forward<VV>(value));
+        auto lit = std::prev(m_list.end());
+        try {
+            m_map.try_emplace(lit->key, lit);
+        } catch (...) {
+            m_list.pop_back();
+            throw;
+        }
+        m_ordering.inserted(m_list, lit);
+        m_totalCharge += charge;
+    }
+
+public:
+    explicit ComposedCache(std::size_t capacity, Sizer sizer = Sizer{},
+                           std::pmr::memory_resource *resource = std::pmr::get_default_resource())
+            : m_capacity(capacity), m_sizer(std::move(sizer)), m_list(resource), m_map(resource),
+              m_admission(capacity) {
+        if (capacity == 0) throw std::invalid_argument("ComposedCache capacity must be > 0");
+    }
+
+    ComposedCache(std::size_t capacity, std::pmr::memory_resource *resource)
+            : ComposedCache(capacity, Sizer{}, resource) {}
+
+    void put(const K &key, const V &value) {
+        insert(key, value);
+    }
+
+    void put(K &&key, V &&value) {
+        insert(std::move(key), std::move(value));
+    }
+
+    std::optional<V> get(const K &key) {
+        return optionalOf(access(key));
+    }
+
+    template<LookupKey<K> Q>
+    std::optional<V> get(const Q &key) {
+        return optionalOf(access(key));
+    }
+
+    const V *find(const K &key) {
+        return access(key);
+    }
+
+    /// 只读查找,不记录访问;供并发装饰器在读锁下调用
+    [[nodiscard]] std::optional<V> peek(const K &key) const {
+        return optionalOf(lookup(key));
+    }
+
+    template<LookupKey<K> Q>
+    [[nodiscard]] std::optional<V> peek(const Q &key) const {
+        return optionalOf(lookup(key));
+    }
+
+    /// 与 peek 相同,但返回指向缓存内值的指针而不复制
+    [[nodiscard]] const V *peekValue(const K &key) const {
+        return lookup(key);
+    }
+
+    template<LookupKey<K> Q>
+    [[nodiscard]] const V *peekValue(const Q &key) const {
+        return lookup(key);
+    }
+
+    /// 记录一次访问;key 不存在时无操作
+    void touch(const K &key) {
+        auto it = m_map.find(key);
+        if (it != m_map.end()) onAccess(it->second);
+    }
+
+    void erase(const K &key) {
+        remove(key);
+    }
+
+    template<LookupKey<K> Q>
+    void erase(const Q &key) {
+        remove(key);
+    }
+
+    void prefetch(const K &key) const {
+        prefetchIndex(m_map, key);
+    }
+
+    [[nodiscard]] bool contains(const K &key) const {
+        return m_map.count(key) != 0;
+    }
+
+    template<LookupKey<K> Q>
+    [[nodiscard]] bool contains(const Q &key) const {
+        return m_map.count(key) != 0;
+    }
+
+    [[nodiscard]] std::size_t size() const {
+        return m_map.size();
+    }
+
+    /// 当前计费总和
+    [[nodiscard]] std::size_t totalCharge() const noexcept {
+        return m_totalCharge;
+    }
+
+    /// 被移除条目的去处(见 Removal.hpp);nullptr(默认)表示就地析构
+    void collectRemovals(RemovalBatch<K, V> *batch) noexcept {
+        m_removals.attach(batch);
+    }
+
+    [[nodiscard]] RemovalBatch<K, V> *removalBatch() const noexcept {
+        return m_removals.batch();
+    }
+
+    /// 统计器(见 Stats.hpp)
+    [[nodiscard]] Stats &statsRecorder() const noexcept {
+        return m_stats;
+    }
+
+    /// 节点容器使用的内存资源
+    [[nodiscard]] std::pmr::memory_resource *resource() const noexcept {
+        return m_map.get_allocator().resource();
+    }
+};
+
+#endif //CACHE_COMPOSEDCACHE_HPP
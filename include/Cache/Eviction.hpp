@@ -0,0 +1,224 @@
+#ifndef CACHE_EVICTION_HPP
+#define CACHE_EVICTION_HPP
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <random>
+#include <utility>
+#include <vector>
+
+/// RandomReplacementCache 的淘汰选择器,作为 Eviction 模板参数传入
+/// 条目保存在稠密数组中(下标 0..size-1),删除时用最后一个条目填补空位;
+/// 选择器需提供成员类模板 policy<K, V>,以 std::pmr::memory_resource * 构造,并提供:
+/// - reserve(n):预留 n 个条目的元数据
+/// - inserted():新条目追加在下标 size 处;可以抛出异常,此时条目不会被插入
+/// - accessed(index):一次命中或原地更新;可能在读锁下并发调用,只能做 relaxed 原子写
+/// - removed(index):下标 index 的条目被删除,随后最后一个条目移到 index(index 为最后一个时直接删除)
+/// - victim(size, gen, entryAt) -> index:选出下一个淘汰对象;size > 0,
+///   entryAt(i) 返回 std::pair<const K &, const V &>(一次索引查找,只在排序需要条目内容时调用)
+/// 除 accessed 外均在写锁下调用
+
+/// 均匀随机淘汰(默认):不记录任何访问信息
+struct UniformEviction {
+    template<typename K, typename V>
+    class policy {
+    public:
+        explicit policy(std::pmr::memory_resource *) noexcept {}
+
+        void reserve(std::size_t) noexcept {}
+
+        void inserted() noexcept {}
+
+        void accessed(std::size_t) noexcept {}
+
+        void removed(std::size_t) noexcept {}
+
+        template<typename Gen, typename EntryAt>
+        std::size_t victim(std::size_t size, Gen &gen, EntryAt &&) {
+            return std::uniform_int_distribution<std::size_t>(0, size - 1)(gen);
+        }
+    };
+};
+
+/// SampledEviction 的排序:提供条目元数据 Meta(以当前逻辑时刻构造,可复制)、accessed(meta, now, size)
+/// 与 score(meta, now, size),score 越小越先被淘汰;kNeedsEntry 为 true 时改为 score(meta, now, size, key, value)
+/// 逻辑时刻 now 是已发生的插入次数,只由写者推进,读者只读取它
+
+/// 近似 LRU:淘汰上次访问最早的候选者;同一时刻内的重复访问不写内存
+struct LeastRecentlyUsed {
+    static constexpr bool kNeedsEntry = false;
+
+    struct Meta {
+        std::atomic<std::uint64_t> last;
+
+        explicit Meta(std::uint64_t now) noexcept : last(now) {}
+
+        Meta(const Meta &other) noexcept : last(other.last.load(std::memory_order_relaxed)) {}
+
+        Meta &operator=(const Meta &other) noexcept {
+            last.store(other.last.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            return *this;
+        }
+    };
+
+    static void accessed(Meta &meta, std::uint64_t now, std::size_t) noexcept {
+        if (meta.last.load(std::memory_order_relaxed) != now) meta.last.store(now, std::memory_order_relaxed);
+    }
+
+    static std::uint64_t score(const Meta &meta, std::uint64_t, std::size_t) noexcept {
+        return meta.last.load(std::memory_order_relaxed);
+    }
+};
+
+/// 近似 LFU:淘汰访问次数最少的候选者,次数相同时淘汰上次访问较早的
+/// 次数随闲置衰减:距上次访问每经过 size 次插入(约一轮全部替换)减半,曾经的热点因此会被逐渐淘汰;
+/// 并发命中的自增可能丢失,只影响近似程度
+struct LeastFrequentlyUsed {
+    static constexpr bool kNeedsEntry = false;
+
+    struct Meta {
+        std::atomic<std::uint32_t> hits{0};
+        std::atomic<std::uint64_t> last;
+
+        explicit Meta(std::uint64_t now) noexcept : last(now) {}
+
+        Meta(const Meta &other) noexcept
+                : hits(other.hits.load(std::memory_order_relaxed)), last(other.last.load(std::memory_order_relaxed)) {}
+
+        Meta &operator=(const Meta &other) noexcept {
+            hits.store(other.hits.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            last.store(other.last.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            return *this;
+        }
+    };
+
+    static std::uint32_t decayed(std::uint32_t hits, std::uint64_t idle, std::size_t size) noexcept {
+        std::uint64_t halvings = idle / std::max<std::size_t>(size, 1);
+        return halvings >= 32 ? 0 : hits >> halvings;
+    }
+
+    // 先把闲置期间的衰减折算进次数,再计入这次访问
+    static void accessed(Meta &meta, std::uint64_t now, std::size_t size) noexcept {
+        std::uint64_t last = meta.last.load(std::memory_order_relaxed);
+        std::uint32_t hits = decayed(meta.hits.load(std::memory_order_relaxed), now - last, size);
+        if (hits != UINT32_MAX) ++hits;
+        meta.hits.store(hits, std::memory_order_relaxed);
+        if (last != now) meta.last.store(now, std::memory_order_relaxed);
+    }
+
+    static std::pair<std::uint32_t, std::uint64_t> score(const Meta &meta, std::uint64_t now, std::size_t size) noexcept {
+        std::uint64_t last = meta.last.load(std::memory_order_relaxed);
+        return {decayed(meta.hits.load(std::memory_order_relaxed), now - last, size), last};
+    }
+};
+
+/// 最早过期:淘汰剩余 TTL 最短的候选者(Redis 的 volatile-ttl)
+/// Deadline 为可默认构造的函数对象,deadline(key, value) 返回可比较的到期时刻(例如值中保存的 time_point);
+/// 不记录访问信息
+template<typename Deadline>
+struct SoonestExpiry {
+    static constexpr bool kNeedsEntry = true;
+
+    struct Meta {
+        explicit Meta(std::uint64_t) noexcept {}
+    };
+
+    static void accessed(Meta &, std::uint64_t, std::size_t) noexcept {}
+
+    template<typename K, typename V>
+    static auto score(const Meta &, std::uint64_t, std::size_t, const K &key, const V &value) {
+        return Deadline{}(key, value);
+    }
+};
+
+/// 采样淘汰(Redis 风格):每次淘汰随机抽取 Samples 个条目,按 Rank 淘汰其中最差的一个
+/// - 命中只对条目自己的元数据做 relaxed 原子写,不调整任何链表,因此可以在读锁下并发调用
+/// - PoolSize > 0 时保留上一轮中次差的 PoolSize 个候选者,与下一轮的新样本一起比较(分数每次重新计算),
+///   候选者逐轮积累,以很小的样本数接近精确 LRU/LFU 的命中率
+/// - 条目数不超过 Samples 时比较全部条目,结果是精确的
+/// 每个条目额外占用 Rank::Meta 的空间
+template<typename Rank = LeastRecentlyUsed, std::size_t Samples = 5, std::size_t PoolSize = 16>
+struct SampledEviction {
+    static_assert(Samples > 0, "SampledEviction needs at least one sample");
+
+    template<typename K, typename V>
+    class policy {
+    private:
+        using Meta = typename Rank::Meta;
+
+        std::pmr::vector<Meta> m_meta;     // 与条目数组一一对应
+        std::uint64_t m_now = 0;           // 逻辑时刻:插入次数
+        std::array<std::size_t, PoolSize> m_pool{};  // 上一轮留下的候选者下标
+        std::size_t m_poolSize = 0;
+
+        template<typename EntryAt>
+        auto scoreOf(std::size_t index, std::size_t size, EntryAt &entryAt) const {
+            if constexpr (Rank::kNeedsEntry) {
+                auto [key, value] = entryAt(index);
+                return Rank::score(m_meta[index], m_now, size, key, value);
+            } else {
+                return Rank::score(m_meta[index], m_now, size);
+            }
+        }
+
+    public:
+        explicit policy(std::pmr::memory_resource *resource) : m_meta(resource) {}
+
+        void reserve(std::size_t n) {
+            m_meta.reserve(n);
+        }
+
+        void inserted() {
+            m_meta.emplace_back(m_now);
+            ++m_now;
+        }
+
+        void accessed(std::size_t index) noexcept {
+            Rank::accessed(m_meta[index], m_now, m_meta.size());
+        }
+
+        void removed(std::size_t index) noexcept {
+            std::size_t last = m_meta.size() - 1;
+            if (index != last) m_meta[index] = m_meta[last];
+            m_meta.pop_back();
+            // 候选池中的下标随之修正:被删除的丢弃,被搬移的改名
+            std::size_t kept = 0;
+            for (std::size_t i = 0; i < m_poolSize; ++i) {
+                if (m_pool[i] == index) continue;
+                m_pool[kept++] = m_pool[i] == last ? index : m_pool[i];
+            }
+            m_poolSize = kept;
+        }
+
+        template<typename Gen, typename EntryAt>
+        std::size_t victim(std::size_t size, Gen &gen, EntryAt &&entryAt) {
+            using Score = decltype(scoreOf(0, size, entryAt));
+            std::array<std::pair<Score, std::size_t>, Samples + PoolSize> candidates;
+            std::size_t count = 0;
+            auto add = [&](std::size_t index) {
+                for (std::size_t i = 0; i < count; ++i) {
+                    if (candidates[i].second == index) return;
+                }
+                candidates[count++] = {scoreOf(index, size, entryAt), index};
+            };
+            for (std::size_t i = 0; i < m_poolSize; ++i) add(m_pool[i]);
+            if (size <= Samples) {
+                for (std::size_t i = 0; i < size; ++i) add(i);
+            } else {
+                std::uniform_int_distribution<std::size_t> dist(0, size - 1);
+                for (std::size_t i = 0; i < Samples; ++i) add(dist(gen));
+            }
+            // 分数相同时按下标比较,结果只取决于抽样
+            std::sort(candidates.begin(), candidates.begin() + count);
+            m_poolSize = std::min(count - 1, PoolSize);
+            for (std::size_t i = 0; i < m_poolSize; ++i) m_pool[i] = candidates[i + 1].second;
+            return candidates[0].second;
+        }
+    };
+};
+
+#endif //CACHE_EVICTION_HPP
@@ -0,0 +1,277 @@
+#ifndef CACHE_EXPIRINGCACHE_HPP
+#define CACHE_EXPIRINGCACHE_HPP
+
+#include "Cache.hpp"
+#include "Removal.hpp"
+#include "TimerWheel.hpp"
+#include <chrono>
+#include <cstdint>
+#include <memory_resource>
+#include <optional>
+#include <utility>
+
+/// 带过期时间(TTL)的缓存装饰器:给任意策略(CachePolicy)加上逐条目的 TTL
+/// - put(key, value, ttl) 为单个条目指定 TTL;put(key, value) 使用构造时给出的默认 TTL,
+///   TTL 为 0(默认)表示永不过期
+/// - 到期时间登记在分层时间轮中,调度/取消 O(1)
+/// - 已过期的条目对 get/peek/contains 立即不可见(只读判断,可在读锁下调用);
+///   真正的删除在每次 put 或显式 cleanUp() 时按时间轮批量进行,不扫描全部条目
+/// - size() 统计的是底层策略中的条目数,可能包含尚未清理的过期条目
+/// 底层策略启用统计(见 Stats.hpp)时,过期的访问计为未命中,时间轮清理掉的条目计为 EvictionCause::Expired
+/// 底层策略支持 collectRemovals 时(见 Removal.hpp),它移除的条目先交给 ExpiringCache:被淘汰或拒绝
+/// (RemovalCause::Capacity)的条目同时取消时间轮中的登记,时间轮因此不超过策略中的条目数;之后再移入调用方
+/// 通过 collectRemovals 设置的批次(未设置时就地析构),时间轮清理掉的条目以 RemovalCause::Expired 移入
+/// 不支持 collectRemovals 的策略只能在 put 被拒绝时取消登记,被淘汰的 key 的登记留到到期时才清理
+/// get/peek/erase/contains 另有异构重载(见 KeyTraits.hpp),要求底层策略同样支持
+/// CacheImpl 的第一个构造参数为容量,其余参数原样转发;底层策略提供 resource() 时,时间轮也从同一内存资源分配
+/// Clock 须满足 TrivialClock(测试中可替换为手动时钟)
+template<typename K, typename V, typename CacheImpl, typename Clock = std::chrono::steady_clock>
+class ExpiringCache : public CacheBase<ExpiringCache<K, V, CacheImpl, Clock>, K, V> {
+public:
+    using Duration = typename Clock::duration;
+
+private:
+    static constexpr bool kRemovals = requires(const CacheImpl &cache) { cache.removalBatch(); };
+
+    CacheImpl m_cache;
+    TimerWheel<K> m_wheel;
+    Duration m_defaultTtl;
+    RemovalBatch<K, V> m_removed;             // 底层策略本次操作移除的条目
+    RemovalBatch<K, V> *m_forward = nullptr;  // 调用方的批次(collectRemovals)
+
+    static std::int64_t nowNanos() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count();
+    }
+
+    static std::pmr::memory_resource *resourceOf(const CacheImpl &cache) noexcept {
+        if constexpr (requires { cache.resource(); }) {
+            return cache.resource();
+        } else {
+            return std::pmr::get_default_resource();
+        }
+    }
+
+    template<typename Q>
+    [[nodiscard]] bool expired(const Q &key) const {
+        return m_wheel.expired(key, nowNanos());
+    }
+
+    void recordExpiredMiss() {
+        if constexpr (StatsRecordingPolicy<CacheImpl>) m_cache.statsRecorder().recordMiss();
+    }
+
+    // 处理底层策略刚移除的条目:因容量离开的取消登记,cause 非空时改写原因,然后转交调用方的批次或就地析构
+    void settle(std::optional<RemovalCause> cause = std::nullopt) {
+        if constexpr (kRemovals) {
+            struct Clear {
+                RemovalBatch<K, V> &batch;
+
+                ~Clear() { batch.clear(); }
+            } clear{m_removed};
+            for (auto &removal: m_removed) {
+                if (removal.cause == RemovalCause::Capacity) m_wheel.cancel(removal.key);
+                if (cause) removal.cause = *cause;
+                if (m_forward) m_forward->push_back(std::move(removal));
+            }
+        }
+    }
+
+    // 未被及时取消的登记(erase 之外的移除)也会回调,只有仍在策略中的条目才算到期淘汰
+    void expire(const K &key) {
+        if constexpr (StatsRecordingPolicy<CacheImpl>) {
+            if (!m_cache.contains(key)) return;
+            m_cache.statsRecorder().recordEviction(EvictionCause::Expired);
+        }
+        // 策略按 Explicit 移除,这里改写为 Expired
+        m_cache.erase(key);
+        settle(RemovalCause::Expired);
+    }
+
+    // 先登记到期时间再写入策略,这样 key 可以被移入策略
+    template<typename KK, typename VV>
+    void insert(KK &&key, VV &&value, Duration ttl) {
+        cleanUp();
+        if (ttl > Duration::zero()) {
+            m_wheel.schedule(key, nowNanos() + std::chrono::duration_cast<std::chrono::nanoseconds>(ttl).count());
+        } else {
+            m_wheel.cancel(key);
+        }
+        if constexpr (kRemovals) {
+            m_cache.put(std::forward<KK>(key), std::forward<VV>(value));
+            settle();
+        } else {
+            // 拿不到移除的条目,只能检查新条目本身是否被拒绝
+            K stored(key);
+            m_cache.put(std::forward<KK>(key), std::forward<VV>(value));
+            if (!m_cache.contains(stored)) m_wheel.cancel(stored);
+        }
+    }
+
+public:
+    template<typename... Args>
+    explicit ExpiringCache(std::size_t capacity, Duration defaultTtl = Duration::zero(), Args &&... args)
+            : m_cache(capacity, std::forward<Args>(args)...), m_wheel(nowNanos(), resourceOf(m_cache)), m_defaultTtl(defaultTtl) {
+        if constexpr (kRemovals) m_cache.collectRemovals(&m_removed);
+    }
+
+    // 底层策略持有指向 m_removed 的指针
+    ExpiringCache(const ExpiringCache &) = delete;
+
+    ExpiringCache &operator=(const ExpiringCache &) = delete;
+
+    /// 以默认 TTL 插入或更新
+    void put(const K &key, const V &value) {
+        insert(key, value, m_defaultTtl);
+    }
+
+    void put(K &&key, V &&value) {
+        insert(std::move(key), std::move(value), m_defaultTtl);
+    }
+
+    /// 以指定 TTL 插入或更新;ttl <= 0 表示永不过期(会清除原有的到期时间)
+    void put(const K &key, const V &value, Duration ttl) {
+        insert(key, value, ttl);
+    }
+
+    void put(K &&key, V &&value, Duration ttl) {
+        insert(std::move(key), std::move(value), ttl);
+    }
+
+    std::optional<V> get(const K &key) {
+        if (expired(key)) {
+            recordExpiredMiss();
+            return std::nullopt;
+        }
+        return m_cache.get(key);
+    }
+
+    template<LookupKey<K> Q>
+    std::optional<V> get(const Q &key) {
+        if (expired(key)) {
+            recordExpiredMiss();
+            return std::nullopt;
+        }
+        return m_cache.get(key);
+    }
+
+    const V *find(const K &key) {
+        if (expired(key)) {
+            recordExpiredMiss();
+            return nullptr;
+        }
+        return m_cache.find(key);
+    }
+
+    /// 只读查找(仅当底层策略提供 peek 时可用)
+    [[nodiscard]] std::optional<V> peek(const K &key) const
+    requires requires(const CacheImpl &cache) { cache.peek(key); } {
+        if (expired(key)) return std::nullopt;
+        return m_cache.peek(key);
+    }
+
+    template<LookupKey<K> Q>
+    [[nodiscard]] std::optional<V> peek(const Q &key) const
+    requires requires(const CacheImpl &cache) { cache.peek(key); } {
+        if (expired(key)) return std::nullopt;
+        return m_cache.peek(key);
+    }
+
+    /// 与 peek 相同但不复制值(仅当底层策略提供 peekValue 时可用)
+    [[nodiscard]] const V *peekValue(const K &key) const
+    requires requires(const CacheImpl &cache) { cache.peekValue(key); } {
+        if (expired(key)) return nullptr;
+        return m_cache.peekValue(key);
+    }
+
+    template<LookupKey<K> Q>
+    [[nodiscard]] const V *peekValue(const Q &key) const
+    requires requires(const CacheImpl &cache) { cache.peekValue(key); } {
+        if (expired(key)) return nullptr;
+        return m_cache.peekValue(key);
+    }
+
+    /// 记录一次命中(仅当底层策略提供 touch 时可用)
+    void touch(const K &key)
+    requires requires(CacheImpl &cache) { cache.touch(key); } {
+        m_cache.touch(key);
+    }
+
+    void erase(const K &key) {
+        m_cache.erase(key);
+        settle();
+        m_wheel.cancel(key);
+    }
+
+    template<LookupKey<K> Q>
+    void erase(const Q &key) {
+        m_cache.erase(key);
+        settle();
+        m_wheel.cancel(key);
+    }
+
+    void prefetch(const K &key) const {
+        m_cache.prefetch(key);
+    }
+
+    [[nodiscard]] bool contains(const K &key) const {
+        return m_cache.contains(key) && !expired(key);
+    }
+
+    template<LookupKey<K> Q>
+    [[nodiscard]] bool contains(const Q &key) const {
+        return m_cache.contains(key) && !expired(key);
+    }
+
+    [[nodiscard]] std::size_t size() const {
+        return m_cache.size();
+    }
+
+    /// 当前计费总和(仅当底层策略带 Sizer 时可用)
+    [[nodiscard]] std::size_t totalCharge() const
+    requires requires(const CacheImpl &cache) { cache.totalCharge(); } {
+        return m_cache.totalCharge();
+    }
+
+    /// 底层策略的统计器(见 Stats.hpp)
+    [[nodiscard]] auto &statsRecorder() const noexcept
+    requires requires(const CacheImpl &cache) { cache.statsRecorder(); } {
+        return m_cache.statsRecorder();
+    }
+
+    /// 被移除条目的去处(仅当底层策略支持时可用)
+    void collectRemovals(RemovalBatch<K, V> *batch) noexcept
+    requires kRemovals {
+        m_forward = batch;
+    }
+
+    [[nodiscard]] RemovalBatch<K, V> *removalBatch() const noexcept
+    requires kRemovals {
+        return m_forward;
+    }
+
+    /// 底层策略使用的内存资源
+    [[nodiscard]] std::pmr::memory_resource *resource() const noexcept
+    requires requires(const CacheImpl &cache) { cache.resource(); } {
+        return m_cache.resource();
+    }
+
+    /// 删除所有已到期的条目;代价与到期条目数成正比
+    void cleanUp() {
+        m_wheel.advance(nowNanos(), [this](const K &key) { expire(key); });
+    }
+
+    /// 时间轮中登记的到期时间数;底层策略支持 collectRemovals 时不超过 size()
+    [[nodiscard]] std::size_t timerCount() const noexcept {
+        return m_wheel.size();
+    }
+
+    /// 条目的到期时刻;不存在或永不过期时返回空
+    [[nodiscard]] std::optional<typename Clock::time_point> expiration(const K &key) const {
+        auto deadline = m_wheel.deadline(key);
+        if (!deadline || !m_cache.contains(key)) return std::nullopt;
+        return typename Clock::time_point(
+                std::chrono::duration_cast<Duration>(std::chrono::nanoseconds(*deadline)));
+    }
+};
+
+#endif //CACHE_EXPIRINGCACHE_HPP
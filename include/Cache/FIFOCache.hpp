@@ -2,74 +2,229 @@
 #define CACHE_FIFOCACHE_HPP
 
 #include "Cache.hpp"
+#include "HashIndex.hpp"
+#include "Sizer.hpp"
+#include "Removal.hpp"
+#include "Snapshot.hpp"
+#include "Stats.hpp"
 #include <list>
+#include <memory_resource>
 #include <functional>
 #include <stdexcept>
+#include <string>
 #include <type_traits>
+#include <utility>
 
 /// FIFO 策略缓存:按插入顺序淘汰最老元素
-template<typename K, typename V>
-class FIFOCache : public Cache<K, V> {
+/// Index 为 key 索引容器选择器(见 HashIndex.hpp)
+/// Sizer 为条目计费器(见 Sizer.hpp),capacity 是计费总和的上限
+/// Stats 为统计器(见 Stats.hpp),默认 NoStats 不做任何统计
+/// 调用 collectRemovals 后,被淘汰、删除、替换或拒绝的条目移入批次而不是就地析构(见 Removal.hpp)
+/// saveSnapshot/loadSnapshot 保存与恢复条目及插入顺序(见 Snapshot.hpp)
+/// get/erase/contains 另有异构重载(见 KeyTraits.hpp),例如以 std::string_view 查找 std::string key
+/// 所有节点容器从构造时给出的 std::pmr::memory_resource 分配(默认为全局分配器,见 NodePool.hpp)
+template<typename K, typename V, typename Index = StdHashIndex, typename Sizer = UnitSizer, typename Stats = NoStats>
+class FIFOCache : public CacheBase<FIFOCache<K, V, Index, Sizer, Stats>, K, V> {
 private:
     static_assert(
             std::is_default_constructible_v<std::hash<K>>,
             "Key type K must be hashable: provide specialization of std::hash<K> if needed"
     );
-    std::size_t m_capacity;  // 容量,必须 > 0
-    std::list<K> m_order;     // 插入顺序队列
-    std::unordered_map<
+    std::size_t m_capacity;  // 容量(计费预算),必须 > 0
+    std::size_t m_totalCharge = 0;  // 当前计费总和
+    [[no_unique_address]] Sizer m_sizer;
+    [[no_unique_address]] mutable Stats m_stats;
+    using Handle = KeyHandle<Index, K>;
+    using Order = std::pmr::list<typename Handle::type>;
+    Order m_order;     // 插入顺序队列,引用索引中的 key
+    typename Index::template map<
             K,
-            std::pair<V, typename std::list<K>::iterator>
+            std::pair<V, typename Order::iterator>
     > m_map;       // key → (value, 队列节点)
+    RemovalSink<K, V> m_removals;
 
-public:
-    explicit FIFOCache(std::size_t capacity)
-            : m_capacity(capacity) {
-        if (capacity == 0) {
-            throw std::invalid_argument("FIFOCache capacity must be > 0");
+    void evictOldest() {
+        auto it = m_map.find(Handle::get(m_order.front()));
+        m_totalCharge -= m_sizer(it->first, it->second.first);
+        m_order.pop_front();
+        m_removals.erase(m_map, it, it->second.first, RemovalCause::Capacity);
+        m_stats.recordEviction(EvictionCause::Size);
+    }
+
+    template<typename Q>
+    const V *lookup(const Q &key) const {
+        auto it = m_map.find(key);
+        if (it == m_map.end()) {
+            return nullptr;
         }
+        return &it->second.first;
+    }
+
+    template<typename Q>
+    const V *access(const Q &key) {
+        const V *value = lookup(key);
+        if (value != nullptr) m_stats.recordHit();
+        else m_stats.recordMiss();
+        return value;
     }
 
-    void put(const K &key, const V &value) override {
+    template<typename Q>
+    void remove(const Q &key, RemovalCause cause = RemovalCause::Explicit) {
         auto it = m_map.find(key);
-        if (it != m_map.end()) {
-            // 已有则更新,不调整顺序
-            it->second.first = value;
+        if (it == m_map.end()) return;
+        m_totalCharge -= m_sizer(it->first, it->second.first);
+        m_order.erase(it->second.second);
+        m_removals.erase(m_map, it, it->second.first, cause);
+    }
+
+    template<typename KK, typename VV>
+    void insert(KK &&key, VV &&value) {
+        m_stats.recordPut();
+        std::size_t charge = m_sizer(key, value);
+        auto it = m_map.find(key);
+        if (charge > m_capacity) {
+            // 超出整个预算:拒绝,同时丢弃旧值
+            if (it != m_map.end()) remove(key, RemovalCause::Replaced);
+            m_stats.recordEviction(EvictionCause::Rejected);
+            if (m_removals) m_removals.push(std::forward<KK>(key), std::forward<VV>(value), RemovalCause::Capacity);
             return;
         }
-        // 达到容量则淘汰最老元素
-        if (m_map.size() == m_capacity) {
-            K old_key = m_order.front();
-            m_order.pop_front();
-            m_map.erase(old_key);
+        if (it != m_map.end()) {
+            std::size_t old_charge = m_sizer(it->first, it->second.first);
+            if (m_totalCharge - old_charge + charge <= m_capacity) {
+                // 已有则更新,不调整顺序
+                if (m_removals) m_removals.push(it->first, std::move(it->second.first), RemovalCause::Replaced);
+                it->second.first = std::forward<VV>(value);
+                m_totalCharge = m_totalCharge - old_charge + charge;
+                return;
+            }
+            // 更新后超出预算:按新元素重新插入
+            remove(key, RemovalCause::Replaced);
         }
-        // 插入新元素
-        m_order.push_back(key);
-        m_map[key] = {value, std::prev(m_order.end())};
+        // 超出预算则依次淘汰最老元素
+        while (m_totalCharge + charge > m_capacity) evictOldest();
+        // 插入新元素:先进入索引,队列只引用索引中的 key
+        it = m_map.try_emplace(std::forward<KK>(key), std::forward<VV>(value), typename Order::iterator{}).first;
+        try {
+            m_order.push_back(Handle::make(it->first));
+        } catch (...) {
+            m_map.erase(it);
+            throw;
+        }
+        it->second.second = std::prev(m_order.end());
+        m_totalCharge += charge;
     }
 
-    std::optional<V> get(const K &key) override {
-        auto it = m_map.find(key);
-        if (it == m_map.end()) {
-            return std::nullopt;
+public:
+    explicit FIFOCache(std::size_t capacity, Sizer sizer = Sizer{},
+                       std::pmr::memory_resource *resource = std::pmr::get_default_resource())
+            : m_capacity(capacity), m_sizer(std::move(sizer)), m_order(resource), m_map(resource) {
+        if (capacity == 0) {
+            throw std::invalid_argument("FIFOCache capacity must be > 0");
         }
-        return it->second.first;
     }
 
-    void erase(const K &key) override {
-        auto it = m_map.find(key);
-        if (it == m_map.end()) return;
-        m_order.erase(it->second.second);
-        m_map.erase(it);
+    FIFOCache(std::size_t capacity, std::pmr::memory_resource *resource)
+            : FIFOCache(capacity, Sizer{}, resource) {}
+
+    void put(const K &key, const V &value) {
+        insert(key, value);
+    }
+
+    void put(K &&key, V &&value) {
+        insert(std::move(key), std::move(value));
+    }
+
+    std::optional<V> get(const K &key) {
+        return optionalOf(access(key));
+    }
+
+    template<LookupKey<K> Q>
+    std::optional<V> get(const Q &key) {
+        return optionalOf(access(key));
+    }
+
+    const V *find(const K &key) {
+        return access(key);
+    }
+
+    void erase(const K &key) {
+        remove(key);
+    }
+
+    template<LookupKey<K> Q>
+    void erase(const Q &key) {
+        remove(key);
+    }
+
+    void prefetch(const K &key) const {
+        prefetchIndex(m_map, key);
+    }
+
+    [[nodiscard]] bool contains(const K &key) const {
+        return m_map.count(key) != 0;
     }
 
-    [[nodiscard]] bool contains(const K &key) const override {
+    template<LookupKey<K> Q>
+    [[nodiscard]] bool contains(const Q &key) const {
         return m_map.count(key) != 0;
     }
 
-    [[nodiscard]] std::size_t size() const override {
+    [[nodiscard]] std::size_t size() const {
         return m_map.size();
     }
+
+    /// 当前计费总和
+    [[nodiscard]] std::size_t totalCharge() const noexcept {
+        return m_totalCharge;
+    }
+
+    /// 按淘汰顺序复制出所有条目(最早插入的在前);并发装饰器在读锁下调用,序列化在锁外进行
+    [[nodiscard]] SnapshotData<K, V> snapshot() const {
+        SnapshotData<K, V> data{SnapshotPolicy::FIFO, {}};
+        data.entries.reserve(m_order.size());
+        for (const auto &handle: m_order) {
+            auto it = m_map.find(Handle::get(handle));
+            data.entries.push_back({it->first, it->second.first});
+        }
+        return data;
+    }
+
+    /// 按快照顺序插入条目,恢复插入顺序;快照中的条目排在已有条目之后
+    /// 容量小于快照时,最早插入的条目照常被淘汰;快照来自其他策略时抛出 std::runtime_error
+    void restore(SnapshotData<K, V> &&data) {
+        data.expect(SnapshotPolicy::FIFO);
+        for (auto &entry: data.entries) insert(std::move(entry.key), std::move(entry.value));
+    }
+
+    /// 把条目与淘汰状态保存到 path(见 Snapshot.hpp);K 与 V 需要 Serializer
+    void saveSnapshot(const std::string &path) const {
+        writeSnapshot(path, snapshot());
+    }
+
+    /// 从 path 加载快照(见 Snapshot.hpp);文件损坏、版本不符或来自其他策略时抛出 std::runtime_error,缓存不变
+    void loadSnapshot(const std::string &path) {
+        restore(readSnapshot<K, V>(path));
+    }
+
+    /// 被移除条目的去处(见 Removal.hpp);nullptr(默认)表示就地析构
+    void collectRemovals(RemovalBatch<K, V> *batch) noexcept {
+        m_removals.attach(batch);
+    }
+
+    [[nodiscard]] RemovalBatch<K, V> *removalBatch() const noexcept {
+        return m_removals.batch();
+    }
+
+    /// 统计器(见 Stats.hpp)
+    [[nodiscard]] Stats &statsRecorder() const noexcept {
+        return m_stats;
+    }
+
+    /// 节点容器使用的内存资源
+    [[nodiscard]] std::pmr::memory_resource *resource() const noexcept {
+        return m_map.get_allocator().resource();
+    }
 };
 
 #endif //CACHE_FIFOCACHE_HPP
@@ -0,0 +1,621 @@
+#ifndef CACHE_FLATHASHMAP_HPP
+#define CACHE_FLATHASHMAP_HPP
+
+#include "Utility.hpp"
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define CACHE_FLATHASHMAP_SSE2 1
+#endif
+
+/// Swiss table 风格的开放寻址哈希表使用的控制字节
+/// - 0..127:槽位已占用,值为哈希值的低 7 位(H2)
+/// - kFlatEmpty:空槽位
+/// - kFlatDeleted:墓碑
+inline constexpr std::int8_t kFlatEmpty = -128;
+inline constexpr std::int8_t kFlatDeleted = -2;
+
+/// 便携实现:一次比较 8 个控制字节(SWAR),在没有 SIMD 的平台上使用
+/// 返回的掩码中每个匹配字节对应一个最高位,下标需要除以 8
+struct FlatGroupPortable {
+    static constexpr std::size_t kWidth = 8;
+    static constexpr int kShift = 3;
+    static constexpr std::uint64_t kLsbs = 0x0101010101010101ULL;
+    static constexpr std::uint64_t kMsbs = 0x8080808080808080ULL;
+
+    std::uint64_t ctrl = 0;
+
+    explicit FlatGroupPortable(const std::int8_t *p) noexcept {
+        // 逐字节装配以避免依赖字节序,编译器会合并为一次加载
+        for (std::size_t i = 0; i < kWidth; ++i)
+            ctrl |= static_cast<std::uint64_t>(static_cast<std::uint8_t>(p[i])) << (8 * i);
+    }
+
+    /// 控制字节等于 h2 的槽位(可能有假阳性,调用方总会再比较 key)
+    [[nodiscard]] std::uint64_t match(std::int8_t h2) const noexcept {
+        std::uint64_t x = ctrl ^ (kLsbs * static_cast<std::uint8_t>(h2));
+        return (x - kLsbs) & ~x & kMsbs;
+    }
+
+    [[nodiscard]] std::uint64_t matchEmpty() const noexcept {
+        return (ctrl & ~(ctrl << 6)) & kMsbs;
+    }
+
+    [[nodiscard]] std::uint64_t matchEmptyOrDeleted() const noexcept {
+        return ctrl & kMsbs;
+    }
+};
+
+#if defined(__AVX2__)
+/// AVX2 实现:一次比较 32 个控制字节
+struct FlatGroupAvx2 {
+    static constexpr std::size_t kWidth = 32;
+    static constexpr int kShift = 0;
+
+    __m256i ctrl;
+
+    explicit FlatGroupAvx2(const std::int8_t *p) noexcept
+            : ctrl(_mm256_load_si256(reinterpret_cast<const __m256i *>(p))) {}
+
+    [[nodiscard]] std::uint32_t match(std::int8_t h2) const noexcept {
+        return static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_set1_epi8(h2), ctrl)));
+    }
+
+    [[nodiscard]] std::uint32_t matchEmpty() const noexcept {
+        return static_cast<std::uint32_t>(
+                _mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_set1_epi8(kFlatEmpty), ctrl)));
+    }
+
+    [[nodiscard]] std::uint32_t matchEmptyOrDeleted() const noexcept {
+        return static_cast<std::uint32_t>(_mm256_movemask_epi8(ctrl));
+    }
+};
+
+using FlatGroupDefault = FlatGroupAvx2;
+#elif defined(CACHE_FLATHASHMAP_SSE2)
+/// SSE2 实现:一次比较 16 个控制字节
+struct FlatGroupSse2 {
+    static constexpr std::size_t kWidth = 16;
+    static constexpr int kShift = 0;
+
+    __m128i ctrl;
+
+    explicit FlatGroupSse2(const std::int8_t *p) noexcept
+            : ctrl(_mm_load_si128(reinterpret_cast<const __m128i *>(p))) {}
+
+    [[nodiscard]] std::uint32_t match(std::int8_t h2) const noexcept {
+        return static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), ctrl)));
+    }
+
+    [[nodiscard]] std::uint32_t matchEmpty() const noexcept {
+        return static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(kFlatEmpty), ctrl)));
+    }
+
+    [[nodiscard]] std::uint32_t matchEmptyOrDeleted() const noexcept {
+        return static_cast<std::uint32_t>(_mm_movemask_epi8(ctrl));
+    }
+};
+
+using FlatGroupDefault = FlatGroupSse2;
+#else
+using FlatGroupDefault = FlatGroupPortable;
+#endif
+
+/// 扁平开放寻址哈希表(Swiss table 风格)
+/// - 键值对连续存放在槽位数组中,另有一个每槽 1 字节的控制数组
+/// - 查找时按组(Group::kWidth 个槽位)用 SIMD 一次比较全部控制字节,组间做三角探测
+/// - 最大负载因子 7/8(含墓碑);删除时若所在组仍有空位则直接置空,否则留下墓碑
+/// 与 std::unordered_map 的差异:插入可能导致重哈希,此时所有迭代器/引用失效;
+/// 删除不会使其他元素的迭代器失效。value_type 为 std::pair<K, V>,不得修改其中的 key。
+/// 槽位数组与控制数组都经由 Allocator 分配(可用 std::pmr::polymorphic_allocator 指定内存资源)
+template<typename K, typename V,
+        typename Hash = std::hash<K>,
+        typename KeyEqual = std::equal_to<K>,
+        typename Group = FlatGroupDefault,
+        typename Allocator = std::allocator<std::pair<K, V>>>
+class FlatHashMap {
+public:
+    using key_type = K;
+    using mapped_type = V;
+    using value_type = std::pair<K, V>;
+    using size_type = std::size_t;
+    using hasher = Hash;
+    using key_equal = KeyEqual;
+    using allocator_type = Allocator;
+
+private:
+    static constexpr std::size_t kWidth = Group::kWidth;
+
+    struct alignas(kWidth) CtrlBlock {
+        std::int8_t bytes[kWidth];
+    };
+
+    using SlotAlloc = typename std::allocator_traits<Allocator>::template rebind_alloc<value_type>;
+    using CtrlAlloc = typename std::allocator_traits<Allocator>::template rebind_alloc<CtrlBlock>;
+
+    CtrlBlock *m_ctrlBlocks = nullptr;  // m_capacity / kWidth 个
+    std::int8_t *m_ctrl = nullptr;
+    value_type *m_slots = nullptr;
+    std::size_t m_capacity = 0;    // 槽位数,0 或 kWidth 的 2^k 倍
+    std::size_t m_size = 0;
+    std::size_t m_growthLeft = 0;  // 在需要重哈希前还能占用的空槽位数
+    [[no_unique_address]] Hash m_hash;
+    [[no_unique_address]] KeyEqual m_equal;
+    [[no_unique_address]] Allocator m_alloc;
+
+    static constexpr std::size_t kNpos = static_cast<std::size_t>(-1);
+
+    static std::size_t maxLoad(std::size_t capacity) noexcept {
+        return capacity - capacity / 8;
+    }
+
+    template<typename Mask>
+    static std::size_t lowestIndex(Mask mask) noexcept {
+        return static_cast<std::size_t>(std::countr_zero(mask)) >> Group::kShift;
+    }
+
+    /// Hash 与 KeyEqual 都声明 is_transparent 时,查找/删除接受任何可与 K 比较的类型
+    static constexpr bool kTransparent = requires {
+        typename Hash::is_transparent;
+        typename KeyEqual::is_transparent;
+    };
+
+    template<typename Q>
+    [[nodiscard]] std::uint64_t hashOf(const Q &key) const {
+        return mixHash(static_cast<std::uint64_t>(m_hash(key)));
+    }
+
+    static std::int8_t h2(std::uint64_t h) noexcept {
+        return static_cast<std::int8_t>(h & 0x7F);
+    }
+
+    [[nodiscard]] std::size_t groupMask() const noexcept {
+        return m_capacity / kWidth - 1;
+    }
+
+    template<typename Q>
+    [[nodiscard]] std::size_t findIndex(const Q &key, std::uint64_t h) const {
+        if (m_capacity == 0) return kNpos;
+        std::size_t mask = groupMask();
+        std::size_t g = static_cast<std::size_t>(h >> 7) & mask;
+        for (std::size_t step = 1;; ++step) {
+            Group group(m_ctrl + g * kWidth);
+            for (auto m = group.match(h2(h)); m != 0; m &= m - 1) {
+                std::size_t i = g * kWidth + lowestIndex(m);
+                if (m_equal(m_slots[i].first, key)) return i;
+            }
+            if (group.matchEmpty() != 0) return kNpos;
+            g = (g + step) & mask;
+        }
+    }
+
+    [[nodiscard]] std::size_t findInsertSlot(std::uint64_t h) const noexcept {
+        std::size_t mask = groupMask();
+        std::size_t g = static_cast<std::size_t>(h >> 7) & mask;
+        for (std::size_t step = 1;; ++step) {
+            auto m = Group(m_ctrl + g * kWidth).matchEmptyOrDeleted();
+            if (m != 0) return g * kWidth + lowestIndex(m);
+            g = (g + step) & mask;
+        }
+    }
+
+    void destroyAll() noexcept {
+        if (m_capacity == 0) return;
+        if constexpr (!std::is_trivially_destructible_v<value_type>) {
+            for (std::size_t i = 0; i < m_capacity; ++i)
+                if (m_ctrl[i] >= 0) std::destroy_at(m_slots + i);
+        }
+        SlotAlloc(m_alloc).deallocate(m_slots, m_capacity);
+        CtrlAlloc(m_alloc).deallocate(m_ctrlBlocks, m_capacity / kWidth);
+        m_ctrlBlocks = nullptr;
+        m_ctrl = nullptr;
+        m_slots = nullptr;
+        m_capacity = 0;
+        m_size = 0;
+        m_growthLeft = 0;
+    }
+
+    /// 重建到 newCapacity 个槽位,顺带清除所有墓碑
+    void rehash(std::size_t newCapacity) {
+        CtrlAlloc ctrlAlloc(m_alloc);
+        SlotAlloc slotAlloc(m_alloc);
+        CtrlBlock *newBlocks = ctrlAlloc.allocate(newCapacity / kWidth);
+        value_type *newSlots;
+        try {
+            newSlots = slotAlloc.allocate(newCapacity);
+        } catch (...) {
+            ctrlAlloc.deallocate(newBlocks, newCapacity / kWidth);
+            throw;
+        }
+        CtrlBlock *oldBlocks = std::exchange(m_ctrlBlocks, newBlocks);
+        std::int8_t *oldCtrl = std::exchange(m_ctrl, m_ctrlBlocks[0].bytes);
+        value_type *oldSlots = std::exchange(m_slots, newSlots);
+        std::size_t oldCapacity = std::exchange(m_capacity, newCapacity);
+        std::memset(m_ctrl, static_cast<unsigned char>(kFlatEmpty), newCapacity);
+        m_growthLeft = maxLoad(newCapacity) - m_size;
+        for (std::size_t i = 0; i < oldCapacity; ++i) {
+            if (oldCtrl[i] < 0) continue;
+            std::uint64_t h = hashOf(oldSlots[i].first);
+            std::size_t target = findInsertSlot(h);
+            m_ctrl[target] = h2(h);
+            std::construct_at(m_slots + target, std::move(oldSlots[i]));
+            std::destroy_at(oldSlots + i);
+        }
+        if (oldCapacity != 0) {
+            slotAlloc.deallocate(oldSlots, oldCapacity);
+            ctrlAlloc.deallocate(oldBlocks, oldCapacity / kWidth);
+        }
+    }
+
+    /// 为一次插入腾出空间:墓碑较多时原地重建,否则容量翻倍
+    void reserveForInsert() {
+        if (m_growthLeft > 0) return;
+        if (m_capacity == 0) {
+            rehash(kWidth);
+        } else if (m_size * 2 <= maxLoad(m_capacity)) {
+            rehash(m_capacity);
+        } else {
+            rehash(m_capacity * 2);
+        }
+    }
+
+    template<typename KK, typename... Args>
+    std::pair<std::size_t, bool> emplaceIndex(KK &&key, Args &&... args) {
+        std::uint64_t h = hashOf(key);
+        std::size_t i = findIndex(key, h);
+        if (i != kNpos) return {i, false};
+        reserveForInsert();
+        i = findInsertSlot(h);
+        std::construct_at(m_slots + i,
+                          std::piecewise_construct,
+                          std::forward_as_tuple(std::forward<KK>(key)),
+                          std::forward_as_tuple(std::forward<Args>(args)...));
+        if (m_ctrl[i] == kFlatEmpty) --m_growthLeft;
+        m_ctrl[i] = h2(h);
+        ++m_size;
+        return {i, true};
+    }
+
+    /// 接管 other 的存储(本对象须为空);分配器由调用方处理
+    void takeStorage(FlatHashMap &other) noexcept {
+        m_ctrlBlocks = std::exchange(other.m_ctrlBlocks, nullptr);
+        m_ctrl = std::exchange(other.m_ctrl, nullptr);
+        m_slots = std::exchange(other.m_slots, nullptr);
+        m_capacity = std::exchange(other.m_capacity, 0);
+        m_size = std::exchange(other.m_size, 0);
+        m_growthLeft = std::exchange(other.m_growthLeft, 0);
+        m_hash = other.m_hash;
+        m_equal = other.m_equal;
+    }
+
+    void eraseIndex(std::size_t i) {
+        std::destroy_at(m_slots + i);
+        --m_size;
+        // 所在组仍有空位说明没有探测序列越过该组,可以直接置空
+        if (Group(m_ctrl + (i / kWidth) * kWidth).matchEmpty() != 0) {
+            m_ctrl[i] = kFlatEmpty;
+            ++m_growthLeft;
+        } else {
+            m_ctrl[i] = kFlatDeleted;
+        }
+    }
+
+    template<bool Const>
+    class Iterator {
+        friend class FlatHashMap;
+        template<bool> friend class Iterator;
+        using Map = std::conditional_t<Const, const FlatHashMap, FlatHashMap>;
+        Map *m_map = nullptr;
+        std::size_t m_index = 0;
+
+        Iterator(Map *map, std::size_t index) noexcept: m_map(map), m_index(index) {}
+
+        void skipEmpty() noexcept {
+            while (m_index < m_map->m_capacity && m_map->m_ctrl[m_index] < 0) ++m_index;
+        }
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = std::pair<K, V>;
+        using difference_type = std::ptrdiff_t;
+        using reference = std::conditional_t<Const, const value_type &, value_type &>;
+        using pointer = std::conditional_t<Const, const value_type *, value_type *>;
+
+        Iterator() = default;
+
+        // 允许 iterator 隐式转换为 const_iterator
+        template<bool C = Const, typename = std::enable_if_t<C>>
+        Iterator(const Iterator<false> &other) noexcept: m_map(other.m_map), m_index(other.m_index) {}
+
+        reference operator*() const noexcept { return m_map->m_slots[m_index]; }
+
+        pointer operator->() const noexcept { return m_map->m_slots + m_index; }
+
+        Iterator &operator++() noexcept {
+            ++m_index;
+            skipEmpty();
+            return *this;
+        }
+
+        Iterator operator++(int) noexcept {
+            Iterator tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        friend bool operator==(const Iterator &a, const Iterator &b) noexcept {
+            return a.m_index == b.m_index;
+        }
+    };
+
+public:
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+    FlatHashMap() = default;
+
+    explicit FlatHashMap(const Allocator &alloc)
+            : m_alloc(alloc) {}
+
+    explicit FlatHashMap(std::size_t bucketCount, const Allocator &alloc = Allocator())
+            : m_alloc(alloc) {
+        reserve(bucketCount);
+    }
+
+    FlatHashMap(const FlatHashMap &other)
+            : m_hash(other.m_hash), m_equal(other.m_equal),
+              m_alloc(std::allocator_traits<Allocator>::select_on_container_copy_construction(other.m_alloc)) {
+        reserve(other.size());
+        for (const auto &kv: other) emplaceIndex(kv.first, kv.second);
+    }
+
+    FlatHashMap(FlatHashMap &&other) noexcept
+            : m_ctrlBlocks(std::exchange(other.m_ctrlBlocks, nullptr)),
+              m_ctrl(std::exchange(other.m_ctrl, nullptr)),
+              m_slots(std::exchange(other.m_slots, nullptr)),
+              m_capacity(std::exchange(other.m_capacity, 0)),
+              m_size(std::exchange(other.m_size, 0)),
+              m_growthLeft(std::exchange(other.m_growthLeft, 0)),
+              m_hash(other.m_hash),
+              m_equal(other.m_equal),
+              m_alloc(other.m_alloc) {}
+
+    /// 与标准容器一致地遵循分配器的传播规则:不传播时(如 std::pmr::polymorphic_allocator)
+    /// 保留本对象的分配器,元素复制到本对象的内存资源中;失败时本对象保持不变
+    FlatHashMap &operator=(const FlatHashMap &other) {
+        if (this == &other) return *this;
+        constexpr bool kPropagate = std::allocator_traits<Allocator>::propagate_on_container_copy_assignment::value;
+        FlatHashMap copy(kPropagate ? other.m_alloc : m_alloc);
+        copy.m_hash = other.m_hash;
+        copy.m_equal = other.m_equal;
+        copy.reserve(other.size());
+        for (const auto &kv: other) copy.emplaceIndex(kv.first, kv.second);
+        destroyAll();
+        if constexpr (kPropagate) m_alloc = other.m_alloc;
+        takeStorage(copy);
+        return *this;
+    }
+
+    /// 分配器传播或两者相等时直接接管存储;否则逐个移动元素到本对象的内存资源中,other 随后被清空
+    FlatHashMap &operator=(FlatHashMap &&other) noexcept(
+            std::allocator_traits<Allocator>::propagate_on_container_move_assignment::value ||
+            std::allocator_traits<Allocator>::is_always_equal::value) {
+        if (this == &other) return *this;
+        using Traits = std::allocator_traits<Allocator>;
+        if constexpr (Traits::propagate_on_container_move_assignment::value) {
+            destroyAll();
+            m_alloc = std::move(other.m_alloc);
+            takeStorage(other);
+        } else {
+            if (Traits::is_always_equal::value || m_alloc == other.m_alloc) {
+                destroyAll();
+                takeStorage(other);
+                return *this;
+            }
+            FlatHashMap moved(m_alloc);
+            moved.m_hash = other.m_hash;
+            moved.m_equal = other.m_equal;
+            moved.reserve(other.size());
+            for (auto &kv: other) moved.emplaceIndex(std::move_if_noexcept(kv.first), std::move_if_noexcept(kv.second));
+            destroyAll();
+            takeStorage(moved);
+            other.clear();
+        }
+        return *this;
+    }
+
+    ~FlatHashMap() {
+        destroyAll();
+    }
+
+    [[nodiscard]] allocator_type get_allocator() const noexcept {
+        return m_alloc;
+    }
+
+    void swap(FlatHashMap &other) noexcept {
+        using std::swap;
+        swap(m_ctrlBlocks, other.m_ctrlBlocks);
+        swap(m_ctrl, other.m_ctrl);
+        swap(m_slots, other.m_slots);
+        swap(m_capacity, other.m_capacity);
+        swap(m_size, other.m_size);
+        swap(m_growthLeft, other.m_growthLeft);
+        swap(m_hash, other.m_hash);
+        swap(m_equal, other.m_equal);
+        // 与标准容器一致:分配器不传播时要求两者相等
+        if constexpr (std::allocator_traits<Allocator>::propagate_on_container_swap::value)
+            swap(m_alloc, other.m_alloc);
+    }
+
+    iterator begin() noexcept {
+        iterator it(this, 0);
+        if (m_capacity != 0) it.skipEmpty();
+        return it;
+    }
+
+    iterator end() noexcept { return iterator(this, m_capacity); }
+
+    const_iterator begin() const noexcept {
+        const_iterator it(this, 0);
+        if (m_capacity != 0) it.skipEmpty();
+        return it;
+    }
+
+    const_iterator end() const noexcept { return const_iterator(this, m_capacity); }
+
+    [[nodiscard]] bool empty() const noexcept { return m_size == 0; }
+
+    [[nodiscard]] std::size_t size() const noexcept { return m_size; }
+
+    /// 当前槽位数
+    [[nodiscard]] std::size_t capacity() const noexcept { return m_capacity; }
+
+    void clear() noexcept { destroyAll(); }
+
+    /// 预留空间,保证再插入到 count 个元素前不发生重哈希
+    void reserve(std::size_t count) {
+        if (count <= m_size && m_capacity != 0) return;
+        std::size_t capacity = m_capacity == 0 ? kWidth : m_capacity;
+        while (maxLoad(capacity) < count) capacity *= 2;
+        if (capacity != m_capacity) rehash(capacity);
+    }
+
+    /// 预取 key 首个探测分组的控制字节与槽位,供批量查找在真正访问前隐藏内存延迟
+    template<typename Q = K>
+    void prefetch(const Q &key) const {
+        if (m_capacity == 0) return;
+        std::size_t g = static_cast<std::size_t>(hashOf(key) >> 7) & groupMask();
+        prefetchRead(m_ctrl + g * kWidth);
+        prefetchRead(m_slots + g * kWidth);
+    }
+
+    iterator find(const K &key) {
+        std::size_t i = findIndex(key, hashOf(key));
+        return i == kNpos ? end() : iterator(this, i);
+    }
+
+    const_iterator find(const K &key) const {
+        std::size_t i = findIndex(key, hashOf(key));
+        return i == kNpos ? end() : const_iterator(this, i);
+    }
+
+    [[nodiscard]] bool contains(const K &key) const {
+        return findIndex(key, hashOf(key)) != kNpos;
+    }
+
+    [[nodiscard]] std::size_t count(const K &key) const {
+        return contains(key) ? 1 : 0;
+    }
+
+    template<typename... Args>
+    std::pair<iterator, bool> try_emplace(const K &key, Args &&... args) {
+        auto [i, inserted] = emplaceIndex(key, std::forward<Args>(args)...);
+        return {iterator(this, i), inserted};
+    }
+
+    template<typename... Args>
+    std::pair<iterator, bool> try_emplace(K &&key, Args &&... args) {
+        auto [i, inserted] = emplaceIndex(std::move(key), std::forward<Args>(args)...);
+        return {iterator(this, i), inserted};
+    }
+
+    template<typename... Args>
+    std::pair<iterator, bool> emplace(Args &&... args) {
+        value_type kv(std::forward<Args>(args)...);
+        return try_emplace(std::move(kv.first), std::move(kv.second));
+    }
+
+    std::pair<iterator, bool> insert(const value_type &kv) {
+        return try_emplace(kv.first, kv.second);
+    }
+
+    V &operator[](const K &key) {
+        return try_emplace(key).first->second;
+    }
+
+    V &operator[](K &&key) {
+        return try_emplace(std::move(key)).first->second;
+    }
+
+    V &at(const K &key) {
+        auto it = find(key);
+        if (it == end()) throw std::out_of_range("FlatHashMap::at: key not found");
+        return it->second;
+    }
+
+    const V &at(const K &key) const {
+        auto it = find(key);
+        if (it == end()) throw std::out_of_range("FlatHashMap::at: key not found");
+        return it->second;
+    }
+
+    /// 删除迭代器指向的元素,返回下一个元素
+    iterator erase(const_iterator pos) {
+        eraseIndex(pos.m_index);
+        iterator next(this, pos.m_index);
+        ++next;
+        return next;
+    }
+
+    iterator erase(iterator pos) {
+        return erase(const_iterator(pos));
+    }
+
+    std::size_t erase(const K &key) {
+        std::size_t i = findIndex(key, hashOf(key));
+        if (i == kNpos) return 0;
+        eraseIndex(i);
+        return 1;
+    }
+
+    /// 异构查找/删除(仅当 Hash 与 KeyEqual 都透明时可用),不构造 K
+    template<typename Q>
+    requires kTransparent
+    iterator find(const Q &key) {
+        std::size_t i = findIndex(key, hashOf(key));
+        return i == kNpos ? end() : iterator(this, i);
+    }
+
+    template<typename Q>
+    requires kTransparent
+    const_iterator find(const Q &key) const {
+        std::size_t i = findIndex(key, hashOf(key));
+        return i == kNpos ? end() : const_iterator(this, i);
+    }
+
+    template<typename Q>
+    requires kTransparent
+    [[nodiscard]] bool contains(const Q &key) const {
+        return findIndex(key, hashOf(key)) != kNpos;
+    }
+
+    template<typename Q>
+    requires kTransparent
+    [[nodiscard]] std::size_t count(const Q &key) const {
+        return contains(key) ? 1 : 0;
+    }
+
+    template<typename Q>
+    requires (kTransparent && !std::is_convertible_v<const Q &, const_iterator>)
+    std::size_t erase(const Q &key) {
+        std::size_t i = findIndex(key, hashOf(key));
+        if (i == kNpos) return 0;
+        eraseIndex(i);
+        return 1;
+    }
+};
+
+#endif //CACHE_FLATHASHMAP_HPP
@@ -0,0 +1,116 @@
+#ifndef CACHE_FREQUENCYSKETCH_HPP
+#define CACHE_FREQUENCYSKETCH_HPP
+
+#include "Utility.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+/// TinyLFU 使用的近似频率统计:4 位 count-min sketch + doorkeeper 布隆过滤器
+/// - 每个 uint64_t 打包 16 个 4 位计数器,计数上限 15;每个 key 映射到 4 行,估计值取最小
+/// - 首次出现的 key 只写入 doorkeeper,第二次起才进入 sketch,过滤掉大量只出现一次的 key
+/// - 累计 sampleSize(= 10 × 容量)次计数后执行一次老化:所有计数器减半,doorkeeper 清空,
+///   使频率统计只反映最近一段时间的访问
+/// 内存占用与容量成正比,与历史上出现过的 key 数量无关
+template<typename K>
+class FrequencySketch {
+private:
+    static constexpr std::uint64_t kResetMask = 0x7777777777777777ULL;
+    static constexpr int kDepth = 4;
+
+    std::vector<std::uint64_t> m_table;      // count-min sketch
+    std::vector<std::uint64_t> m_doorkeeper; // 布隆过滤器位图
+    std::size_t m_tableMask;
+    std::size_t m_doorkeeperMask;            // 以位为单位
+    std::size_t m_sampleSize;
+    std::size_t m_additions = 0;
+
+    static std::size_t ceilPowerOfTwo(std::size_t n) {
+        std::size_t p = 1;
+        while (p < n) p <<= 1;
+        return p;
+    }
+
+    static std::uint64_t hashOf(const K &key) {
+        return mixHash(static_cast<std::uint64_t>(std::hash<K>{}(key)));
+    }
+
+    // 第 i 个探测位置:双重哈希 h1 + i * h2
+    static std::uint64_t probe(std::uint64_t h, int i) {
+        std::uint64_t h2 = (h >> 32) | 1;
+        return h + static_cast<std::uint64_t>(i) * h2;
+    }
+
+    [[nodiscard]] unsigned counterAt(std::uint64_t h, int row) const {
+        std::uint64_t p = probe(h, row);
+        std::size_t word = static_cast<std::size_t>(p) & m_tableMask;
+        unsigned shift = static_cast<unsigned>((p >> 58) & 15u) << 2;
+        return static_cast<unsigned>((m_table[word] >> shift) & 0xFu);
+    }
+
+    bool incrementAt(std::uint64_t h, int row) {
+        std::uint64_t p = probe(h, row);
+        std::size_t word = static_cast<std::size_t>(p) & m_tableMask;
+        unsigned shift = static_cast<unsigned>((p >> 58) & 15u) << 2;
+        if (((m_table[word] >> shift) & 0xFu) == 0xFu) return false;
+        m_table[word] += std::uint64_t{1} << shift;
+        return true;
+    }
+
+    // 返回 key 此前是否已在 doorkeeper 中,并将其加入
+    bool doorkeeperPut(std::uint64_t h) {
+        bool present = true;
+        for (int i = 0; i < 2; ++i) {
+            std::size_t bit = static_cast<std::size_t>(probe(h ^ 0x9e3779b97f4a7c15ULL, i)) & m_doorkeeperMask;
+            std::uint64_t mask = std::uint64_t{1} << (bit & 63);
+            if ((m_doorkeeper[bit >> 6] & mask) == 0) {
+                present = false;
+                m_doorkeeper[bit >> 6] |= mask;
+            }
+        }
+        return present;
+    }
+
+    [[nodiscard]] bool doorkeeperContains(std::uint64_t h) const {
+        for (int i = 0; i < 2; ++i) {
+            std::size_t bit = static_cast<std::size_t>(probe(h ^ 0x9e3779b97f4a7c15ULL, i)) & m_doorkeeperMask;
+            if ((m_doorkeeper[bit >> 6] & (std::uint64_t{1} << (bit & 63))) == 0) return false;
+        }
+        return true;
+    }
+
+    void reset() {
+        for (auto &word: m_table) word = (word >> 1) & kResetMask;
+        std::fill(m_doorkeeper.begin(), m_doorkeeper.end(), 0);
+        m_additions /= 2;
+    }
+
+public:
+    explicit FrequencySketch(std::size_t capacity)
+            : m_table(ceilPowerOfTwo(std::max<std::size_t>(capacity, 8))),
+              m_doorkeeper(ceilPowerOfTwo(std::max<std::size_t>(capacity, 64)) / 8),
+              m_tableMask(m_table.size() - 1),
+              m_doorkeeperMask(m_doorkeeper.size() * 64 - 1),
+              m_sampleSize(10 * std::max<std::size_t>(capacity, 1)) {}
+
+    /// 记录一次访问
+    void increment(const K &key) {
+        std::uint64_t h = hashOf(key);
+        if (!doorkeeperPut(h)) return;
+        bool added = false;
+        for (int row = 0; row < kDepth; ++row) added |= incrementAt(h, row);
+        if (added && ++m_additions >= m_sampleSize) reset();
+    }
+
+    /// 估计访问频率(0..16)
+    [[nodiscard]] unsigned frequency(const K &key) const {
+        std::uint64_t h = hashOf(key);
+        unsigned freq = 15;
+        for (int row = 0; row < kDepth; ++row) freq = std::min(freq, counterAt(h, row));
+        return freq + (doorkeeperContains(h) ? 1u : 0u);
+    }
+};
+
+#endif //CACHE_FREQUENCYSKETCH_HPP
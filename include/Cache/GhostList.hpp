@@ -0,0 +1,84 @@
+#ifndef CACHE_GHOSTLIST_HPP
+#define CACHE_GHOSTLIST_HPP
+
+#include "FlatHashMap.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory_resource>
+#include <utility>
+
+/// 幽灵队列:只记录已被淘汰元素的 key 哈希,按进入顺序先进先出
+/// 供 ARC(B1/B2)与 S3-FIFO(ghost 队列)判断"最近是否被淘汰过"
+/// - 哈希 -> 序号 的扁平索引负责成员判断;双端队列按序号记录先后顺序
+/// - 中间删除只在索引中进行,队列里留下的过期项在出队时跳过,
+///   过期项过多时整体压缩,所有操作均摊 O(1)
+/// 每个幽灵项约占 30 字节,不保存 key 本身;哈希碰撞只会造成极少量误判
+class GhostList {
+private:
+    using Index = FlatHashMap<std::uint64_t, std::uint64_t, std::hash<std::uint64_t>, std::equal_to<std::uint64_t>,
+            FlatGroupDefault, std::pmr::polymorphic_allocator<std::pair<std::uint64_t, std::uint64_t>>>;
+    using Queue = std::pmr::deque<std::pair<std::uint64_t, std::uint64_t>>;
+
+    Index m_index;  // hash -> 序号
+    Queue m_queue;  // (hash, 序号),front 最老
+    std::uint64_t m_nextSeq = 0;
+
+    [[nodiscard]] bool isLive(const std::pair<std::uint64_t, std::uint64_t> &item) const {
+        auto it = m_index.find(item.first);
+        return it != m_index.end() && it->second == item.second;
+    }
+
+    void compactIfNeeded() {
+        if (m_queue.size() <= 2 * m_index.size() + 32) return;
+        Queue live(m_queue.get_allocator());
+        for (const auto &item: m_queue)
+            if (isLive(item)) live.push_back(item);
+        m_queue.swap(live);
+    }
+
+public:
+    explicit GhostList(std::pmr::memory_resource *resource = std::pmr::get_default_resource())
+            : m_index(resource), m_queue(resource) {}
+
+    [[nodiscard]] bool contains(std::uint64_t hash) const {
+        return m_index.contains(hash);
+    }
+
+    /// 加入队尾;已存在时移到队尾
+    void pushBack(std::uint64_t hash) {
+        std::uint64_t seq = m_nextSeq++;
+        m_index[hash] = seq;
+        m_queue.emplace_back(hash, seq);
+        compactIfNeeded();
+    }
+
+    /// 删除指定哈希,返回是否存在
+    bool erase(std::uint64_t hash) {
+        if (m_index.erase(hash) == 0) return false;
+        compactIfNeeded();
+        return true;
+    }
+
+    /// 删除最老的一项;队列为空时无操作
+    void popFront() {
+        while (!m_queue.empty()) {
+            auto item = m_queue.front();
+            m_queue.pop_front();
+            if (isLive(item)) {
+                m_index.erase(item.first);
+                return;
+            }
+        }
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept {
+        return m_index.size();
+    }
+
+    [[nodiscard]] bool empty() const noexcept {
+        return m_index.empty();
+    }
+};
+
+#endif //CACHE_GHOSTLIST_HPP
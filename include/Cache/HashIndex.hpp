@@ -0,0 +1,71 @@
+#ifndef CACHE_HASHINDEX_HPP
+#define CACHE_HASHINDEX_HPP
+
+#include "FlatHashMap.hpp"
+#include "KeyTraits.hpp"
+#include <memory_resource>
+#include <type_traits>
+#include <unordered_map>
+
+/// 各策略 key 索引所用的容器选择器,作为策略的 Index 模板参数传入
+/// 选择器需提供成员别名模板 map<K, V>,以及 kStableKeys:索引中 key 的地址在插入/删除其他元素时是否保持不变
+/// 两种索引都使用 KeyHash<K> / KeyEqual,字符串 key 支持以 std::string_view 等类型异构查找
+/// 两种索引都经由 std::pmr::polymorphic_allocator 分配,以策略构造时给出的 memory_resource 构造(见 NodePool.hpp)
+/// 注意:FlatHashIndex 在插入时可能重哈希,各策略都不会跨插入持有索引迭代器
+
+/// 基于节点的 std::unordered_map(默认)
+struct StdHashIndex {
+    template<typename K, typename V>
+    using map = std::pmr::unordered_map<K, V, KeyHash<K>, KeyEqual>;
+
+    static constexpr bool kStableKeys = true;
+};
+
+/// 扁平开放寻址表 FlatHashMap(SIMD 分组探测)
+struct FlatHashIndex {
+    template<typename K, typename V>
+    using map = FlatHashMap<K, V, KeyHash<K>, KeyEqual, FlatGroupDefault,
+            std::pmr::polymorphic_allocator<std::pair<K, V>>>;
+
+    static constexpr bool kStableKeys = false;
+};
+
+/// 策略的次级结构(插入顺序队列、频率链表、随机数组等)中引用 key 的方式
+/// 索引中 key 的地址稳定时只保存指向它的指针,避免再复制一份 key;否则保存副本
+template<typename Index, typename K>
+struct KeyHandle {
+    using type = std::conditional_t<Index::kStableKeys, const K *, K>;
+
+    /// indexKey 必须是索引中保存的那份 key
+    static type make(const K &indexKey) {
+        if constexpr (Index::kStableKeys) return &indexKey;
+        else return indexKey;
+    }
+
+    static const K &get(const type &handle) noexcept {
+        if constexpr (Index::kStableKeys) return *handle;
+        else return handle;
+    }
+};
+
+/// 删除索引中 it 指向的条目,并把其中的 key 移出返回;value 中需要的部分应在此之前移走
+/// std::unordered_map 删除时要重新哈希 key,因此先摘下节点再移动;FlatHashMap 按槽位删除,可以直接移动
+template<typename Map>
+typename Map::key_type takeKey(Map &map, typename Map::iterator it) {
+    if constexpr (requires { map.extract(it); }) {
+        auto node = map.extract(it);
+        return std::move(node.key());
+    } else {
+        typename Map::key_type key = std::move(it->first);
+        map.erase(it);
+        return key;
+    }
+}
+
+/// 预取 key 在索引中的位置;std::unordered_map 不暴露桶地址,此时无操作
+template<typename Map, typename Q>
+inline void prefetchIndex(const Map &map, const Q &key) {
+    if constexpr (requires { map.prefetch(key); }) map.prefetch(key);
+}
+
+#endif //CACHE_HASHINDEX_HPP
@@ -0,0 +1,140 @@
+#ifndef CACHE_HYBRIDCACHE_HPP
+#define CACHE_HYBRIDCACHE_HPP
+
+#include "Cache.hpp"
+#include "LRUCache.hpp"
+#include "RegionStore.hpp"
+#include "Removal.hpp"
+#include <concepts>
+#include <cstddef>
+#include <optional>
+#include <utility>
+
+/// 两层缓存:Memory 策略为 DRAM 层,被它淘汰的条目写入本地文件上的 RegionStore(见 RegionStore.hpp)
+/// - 淘汰经由 collectRemovals 截获(见 Removal.hpp):原因为 Capacity 的条目(包括计费超过整个预算而被拒绝的)
+///   写入文件层,被删除或替换的旧值直接丢弃
+/// - get 未命中 DRAM 时查文件层,命中则从文件层取出并提升回 DRAM(这可能把别的条目挤到文件层)
+/// - 同一个 key 任何时刻只在一层中;put 会先删除文件层中的旧版本
+/// - K 与 V 需要 Serializer(见 Snapshot.hpp)
+/// - Memory 提供 peek/touch 时(LRUCache、LFUCache、ARCCache 等),HybridCache 同样提供:peek 只读两层,
+///   touch 在 DRAM 中记录访问或从文件层提升,因此放进 ConcurrentCache 后读操作只持读锁;
+///   否则 get 会修改两层,声明 kExclusiveGet,ConcurrentCache 对它的读操作改持写锁
+/// 例:HybridCache<std::string, Blob> cache(RegionStoreOptions{"/mnt/nvme/cache.bin"}, 100000);
+template<typename K, typename V, typename Memory = LRUCache<K, V>>
+class HybridCache : public CacheBase<HybridCache<K, V, Memory>, K, V> {
+private:
+    static_assert(CachePolicy<Memory, K, V>, "Memory must satisfy CachePolicy");
+    static_assert(requires(Memory &memory, RemovalBatch<K, V> *batch) { memory.collectRemovals(batch); },
+                  "Memory must support collectRemovals so that evictions can be spilled");
+
+    // Memory 能把查找与记录访问分开(peek/touch,见 ConcurrentCache.hpp 中的 BufferedAccessPolicy)
+    static constexpr bool kSplitAccess = requires(const Memory &constMemory, Memory &memory, const K &key) {
+        { constMemory.peek(key) } -> std::same_as<std::optional<V>>;
+        memory.touch(key);
+    };
+
+    Memory m_memory;
+    RegionStore<K, V> m_store;
+    RemovalBatch<K, V> m_evicted;  // 一次操作中 DRAM 层移除的条目
+
+    /// 把 DRAM 层刚淘汰的条目写入文件层,其余移除的条目就地丢弃
+    void spill() {
+        struct Clear {
+            RemovalBatch<K, V> &batch;
+
+            ~Clear() { batch.clear(); }
+        } clear{m_evicted};
+        for (auto &removal: m_evicted) {
+            if (removal.cause == RemovalCause::Capacity) m_store.insert(removal.key, removal.value);
+        }
+    }
+
+    /// 从文件层取出 key 并放回 DRAM;返回取出的值
+    std::optional<V> promote(const K &key) {
+        auto value = m_store.take(key);
+        if (!value) return std::nullopt;
+        m_memory.put(key, *value);
+        spill();
+        return value;
+    }
+
+public:
+    static constexpr bool kExclusiveGet = !kSplitAccess;
+
+    /// store 为文件层的布局,其余参数原样转发给 Memory 的构造函数(通常是 DRAM 层的容量)
+    template<typename... Args>
+    explicit HybridCache(RegionStoreOptions store, Args &&... memoryArgs)
+            : m_memory(std::forward<Args>(memoryArgs)...), m_store(std::move(store)) {
+        m_memory.collectRemovals(&m_evicted);
+    }
+
+    void put(const K &key, const V &value) {
+        m_store.erase(key);
+        m_memory.put(key, value);
+        spill();
+    }
+
+    void put(K &&key, V &&value) {
+        m_store.erase(key);
+        m_memory.put(std::move(key), std::move(value));
+        spill();
+    }
+
+    std::optional<V> get(const K &key) {
+        if (auto hit = m_memory.get(key)) return hit;
+        return promote(key);
+    }
+
+    /// 返回指向 DRAM 层中值的指针;命中文件层时先提升
+    const V *find(const K &key) {
+        if (const V *value = m_memory.find(key)) return value;
+        if (!promote(key)) return nullptr;
+        return m_memory.find(key);
+    }
+
+    /// 只读查找,不调整顺序也不提升:先查 DRAM 层,再读文件层;供并发装饰器在读锁下调用
+    [[nodiscard]] std::optional<V> peek(const K &key) const
+    requires kSplitAccess {
+        if (auto hit = m_memory.peek(key)) return hit;
+        return m_store.lookup(key);
+    }
+
+    /// 记录一次访问:在 DRAM 层中调整顺序,或从文件层提升
+    void touch(const K &key)
+    requires kSplitAccess {
+        if (m_memory.contains(key)) m_memory.touch(key);
+        else promote(key);
+    }
+
+    void erase(const K &key) {
+        m_memory.erase(key);
+        m_store.erase(key);
+        m_evicted.clear();
+    }
+
+    void prefetch(const K &key) const {
+        m_memory.prefetch(key);
+    }
+
+    /// 文件层只查内存索引(见 RegionStore::contains)
+    [[nodiscard]] bool contains(const K &key) const {
+        return m_memory.contains(key) || m_store.contains(key);
+    }
+
+    /// 两层的条目数之和
+    [[nodiscard]] std::size_t size() const {
+        return m_memory.size() + m_store.size();
+    }
+
+    /// DRAM 层;直接修改它会绕过文件层
+    [[nodiscard]] const Memory &memory() const noexcept {
+        return m_memory;
+    }
+
+    /// 文件层
+    [[nodiscard]] const RegionStore<K, V> &store() const noexcept {
+        return m_store;
+    }
+};
+
+#endif //CACHE_HYBRIDCACHE_HPP
@@ -0,0 +1,38 @@
+#ifndef CACHE_KEYTRAITS_HPP
+#define CACHE_KEYTRAITS_HPP
+
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <string_view>
+
+/// 各策略索引使用的 key 哈希器
+/// 默认即 std::hash<K>;为自定义类型特化 std::hash<K> 依然有效
+/// 需要异构查找的 key 类型可以特化 KeyHash<K> 并声明 is_transparent
+template<typename K>
+struct KeyHash : std::hash<K> {};
+
+/// 字符串:透明哈希,可直接对 std::string_view / const char* 计算,且与 std::hash<std::string> 结果相同
+template<typename CharT, typename Traits, typename Alloc>
+struct KeyHash<std::basic_string<CharT, Traits, Alloc>> {
+    using is_transparent = void;
+
+    std::size_t operator()(std::basic_string_view<CharT, Traits> key) const noexcept {
+        return std::hash<std::basic_string_view<CharT, Traits>>{}(key);
+    }
+};
+
+/// 各策略索引使用的 key 比较器;std::equal_to<> 本身即透明
+using KeyEqual = std::equal_to<>;
+
+/// Q 可以在不构造 K 的情况下用于查找:KeyHash<K> 是透明的,且 Q 可哈希、可与 K 比较
+/// 例如 K = std::string 时,Q 可以是 std::string_view 或 const char*
+template<typename Q, typename K>
+concept LookupKey = requires { typename KeyHash<K>::is_transparent; }
+                    && requires(const Q &query, const K &key) {
+    { KeyHash<K>{}(query) } -> std::convertible_to<std::size_t>;
+    { key == query } -> std::convertible_to<bool>;
+};
+
+#endif //CACHE_KEYTRAITS_HPP
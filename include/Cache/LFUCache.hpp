@@ -2,71 +2,63 @@
 #define CACHE_LFUCACHE_HPP
 
 #include "Cache.hpp"
+#include "HashIndex.hpp"
+#include "Sizer.hpp"
+#include "Removal.hpp"
+#include "Snapshot.hpp"
+#include "Stats.hpp"
+#include <algorithm>
 #include <cstddef>
+#include <limits>
 #include <list>
+#include <memory_resource>
 #include <unordered_map>
 #include <stdexcept>
+#include <string>
 #include <functional>
 #include <type_traits>
+#include <utility>
+#include <vector>
 
 /// LFU 策略缓存:访问频率最低淘汰,频率相同时按最近插入顺序
 /// 容量 > 0
 /// 异常安全:在调整频率列表时保证状态一致性
-template<typename K, typename V>
-class LFUCache : public Cache<K, V> {
+/// Index 为 key 索引容器选择器(见 HashIndex.hpp)
+/// Sizer 为条目计费器(见 Sizer.hpp),capacity 是计费总和的上限
+/// Stats 为统计器(见 Stats.hpp),默认 NoStats 不做任何统计
+/// 调用 collectRemovals 后,被淘汰、删除、替换或拒绝的条目移入批次而不是就地析构(见 Removal.hpp)
+/// saveSnapshot/loadSnapshot 保存与恢复条目及其访问频率(见 Snapshot.hpp)
+/// get/peek/erase/contains 另有异构重载(见 KeyTraits.hpp)
+/// 所有节点容器从构造时给出的 std::pmr::memory_resource 分配(默认为全局分配器,见 NodePool.hpp)
+template<typename K, typename V, typename Index = StdHashIndex, typename Sizer = UnitSizer, typename Stats = NoStats>
+class LFUCache : public CacheBase<LFUCache<K, V, Index, Sizer, Stats>, K, V> {
 private:
     static_assert(
             std::is_default_constructible_v<std::hash<K>>,
             "Key type K must be hashable: provide specialization of std::hash<K> if needed"
     );
+    using Handle = KeyHandle<Index, K>;
+    using KeyList = std::pmr::list<typename Handle::type>;  // 引用索引中的 key
     // 节点信息:存储值、访问频率和在频率链表中的迭代器位置
     struct Node {
         V val;
         int freq;
-        std::list<K>::iterator iter; // 在对应频率链表中的位置
+        typename KeyList::iterator iter; // 在对应频率链表中的位置
     };
-    std::size_t m_capacity;  // 缓存容量
+    std::size_t m_capacity;  // 缓存容量(计费预算)
+    std::size_t m_totalCharge = 0;  // 当前计费总和
+    [[no_unique_address]] Sizer m_sizer;
+    [[no_unique_address]] mutable Stats m_stats;
     int m_min_freq = 0; // 当前最小频率
-    std::unordered_map<K, Node> m_nodes;     // key -> Node 映射
-    std::unordered_map<int, std::list<K>> m_freq_list;  // 频率 -> keys 列表
-public:
-    explicit LFUCache(std::size_t capacity)
-            : m_capacity(capacity) {
-        if (capacity == 0) throw std::invalid_argument("LRUCache capacity must be > 0");
-    }
-
-    void put(const K &key, const V &value) override {
-        if (m_capacity == 0) return; // 零容量直接返回
-        auto it = m_nodes.find(key);
-        if (it != m_nodes.end()) {
-            // 如果已有该 key,更新其值并提升频率
-            it->second.val = value;
-            get(key); // 调用 get 逻辑,提升频率并更新位置
-            return;
-        }
-        // 如果已达容量上限,淘汰最少使用的节点
-        if (m_nodes.size() >= m_capacity) {
-            auto &lst = m_freq_list[m_min_freq];       // 最小频率对应的列表
-            K old_key = lst.front();                 // 列表头为最久未使用
-            lst.pop_front();                         // 从列表中移除
-            m_nodes.erase(old_key);                  // 从节点映射中移除
-        }
-        // 插入新节点,初始频率为 1
-        m_min_freq = 1;                              // 重置最小频率
-        auto &lst = m_freq_list[m_min_freq];                  // 获取频率为 1 的列表
-        lst.push_back(key);                         // 将 key 加入列表尾
-        // 在节点映射中创建新 Node
-        m_nodes[key] = {value, m_min_freq, std::prev(lst.end())};
-    }
+    typename Index::template map<K, Node> m_nodes;     // key -> Node 映射
+    std::pmr::unordered_map<int, KeyList> m_freq_list;  // 频率 -> keys 列表
+    RemovalSink<K, V> m_removals;
 
-    std::optional<V> get(const K &key) override {
-        auto it = m_nodes.find(key);
-        if (it == m_nodes.end())
-            return std::nullopt;
-
-        int freq = it->second.freq;
+    // 将节点从当前频率列表移到 freq + 1 列表的尾部;key 必须是索引中的那份
+    void promote(const K &key, Node &node) {
+        int freq = node.freq;
         auto &old_freq_list = m_freq_list[freq];
-        old_freq_list.erase(it->second.iter);        // 从旧频率列表中移除
+        old_freq_list.erase(node.iter);              // 从旧频率列表中移除
 
         // 如果移除后列表为空且该频率为最小频率,则删除该列表并更新 m_min_freq
         if (old_freq_list.empty() && freq == m_min_freq) {
@@ -77,17 +69,74 @@ public:
         // 将 key 插入到新频率列表
         int new_freq = freq + 1;
         auto &new_freq_list = m_freq_list[new_freq];
-        new_freq_list.push_back(key);                 // 加入列表尾
-        it->second.freq = new_freq;                   // 更新频率
-        it->second.iter = std::prev(new_freq_list.end()); // 更新迭代器位置
+        new_freq_list.push_back(Handle::make(key));   // 加入列表尾
+        node.freq = new_freq;                         // 更新频率
+        node.iter = std::prev(new_freq_list.end());   // 更新迭代器位置
+    }
+
+    // 淘汰一个访问频率最低的节点
+    void evictOne() {
+        auto fit = m_freq_list.find(m_min_freq);
+        if (fit == m_freq_list.end() || fit->second.empty()) {
+            // m_min_freq 已过期(删除或连续淘汰清空了该列表):重新找最小的非空频率
+            m_min_freq = std::numeric_limits<int>::max();
+            for (const auto &[freq, keys]: m_freq_list)
+                if (!keys.empty() && freq < m_min_freq) m_min_freq = freq;
+            fit = m_freq_list.find(m_min_freq);
+        }
+        auto &lst = fit->second;                     // 最小频率对应的列表
+        auto nit = m_nodes.find(Handle::get(lst.front()));  // 列表头为最久未使用
+        m_totalCharge -= m_sizer(nit->first, nit->second.val);
+        lst.pop_front();                             // 从列表中移除
+        m_removals.erase(m_nodes, nit, nit->second.val, RemovalCause::Capacity);  // 从节点映射中移除
+        if (lst.empty()) m_freq_list.erase(fit);
+        m_stats.recordEviction(EvictionCause::Size);
+    }
 
-        return it->second.val;
+    // 插入一个 key 不在缓存中的新节点,频率为 freq;超出预算则先依次淘汰最少使用的节点
+    template<typename KK, typename VV>
+    void emplaceNode(KK &&key, VV &&value, int freq, std::size_t charge) {
+        while (m_totalCharge + charge > m_capacity) evictOne();
+        if (m_nodes.empty() || freq < m_min_freq) m_min_freq = freq;
+        auto &lst = m_freq_list[freq];
+        // 先在节点映射中创建新 Node,频率列表只引用其中的 key
+        auto nit = m_nodes.try_emplace(std::forward<KK>(key), Node{std::forward<VV>(value), freq, typename KeyList::iterator{}}).first;
+        try {
+            lst.push_back(Handle::make(nit->first));  // 将 key 加入列表尾
+        } catch (...) {
+            m_nodes.erase(nit);
+            throw;
+        }
+        nit->second.iter = std::prev(lst.end());
+        m_totalCharge += charge;
+    }
+
+    template<typename Q>
+    const V *lookup(const Q &key) const {
+        auto it = m_nodes.find(key);
+        if (it == m_nodes.end())
+            return nullptr;
+        return &it->second.val;
     }
 
-    void erase(const K &key) override {
+    template<typename Q>
+    const V *access(const Q &key) {
+        auto it = m_nodes.find(key);
+        if (it == m_nodes.end()) {
+            m_stats.recordMiss();
+            return nullptr;
+        }
+        m_stats.recordHit();
+        promote(it->first, it->second);
+        return &it->second.val;
+    }
+
+    template<typename Q>
+    void remove(const Q &key, RemovalCause cause = RemovalCause::Explicit) {
         auto it = m_nodes.find(key);
         if (it == m_nodes.end()) return;              // 不存在直接返回
 
+        m_totalCharge -= m_sizer(it->first, it->second.val);
         auto &freq_list = m_freq_list[it->second.freq];
         freq_list.erase(it->second.iter);             // 从列表中移除
         // 如果移除后列表为空且该频率为最小频率,则删除该列表
@@ -95,16 +144,190 @@ public:
             m_freq_list.erase(it->second.freq);
             // m_min_freq 不用立即调整
         }
-        m_nodes.erase(it);                             // 从节点映射中移除
+        m_removals.erase(m_nodes, it, it->second.val, cause);  // 从节点映射中移除
+    }
+    template<typename KK, typename VV>
+    void insert(KK &&key, VV &&value) {
+        m_stats.recordPut();
+        std::size_t charge = m_sizer(key, value);
+        auto it = m_nodes.find(key);
+        if (charge > m_capacity) {
+            // 超出整个预算:拒绝,同时丢弃旧值
+            if (it != m_nodes.end()) remove(key, RemovalCause::Replaced);
+            m_stats.recordEviction(EvictionCause::Rejected);
+            if (m_removals) m_removals.push(std::forward<KK>(key), std::forward<VV>(value), RemovalCause::Capacity);
+            return;
+        }
+        if (it != m_nodes.end()) {
+            std::size_t old_charge = m_sizer(it->first, it->second.val);
+            if (m_totalCharge - old_charge + charge <= m_capacity) {
+                // 如果已有该 key,更新其值并提升频率
+                if (m_removals) m_removals.push(it->first, std::move(it->second.val), RemovalCause::Replaced);
+                it->second.val = std::forward<VV>(value);
+                m_totalCharge = m_totalCharge - old_charge + charge;
+                promote(it->first, it->second); // 提升频率并更新位置
+                return;
+            }
+            // 更新后超出预算:按新元素重新插入,频率重新计数
+            remove(key, RemovalCause::Replaced);
+        }
+        // 插入新节点,初始频率为 1
+        emplaceNode(std::forward<KK>(key), std::forward<VV>(value), 1, charge);
+    }
+
+public:
+    explicit LFUCache(std::size_t capacity, Sizer sizer = Sizer{},
+                      std::pmr::memory_resource *resource = std::pmr::get_default_resource())
+            : m_capacity(capacity), m_sizer(std::move(sizer)), m_nodes(resource), m_freq_list(resource) {
+        if (capacity == 0) throw std::invalid_argument("LRUCache capacity must be > 0");
+    }
+
+    LFUCache(std::size_t capacity, std::pmr::memory_resource *resource)
+            : LFUCache(capacity, Sizer{}, resource) {}
+
+    void put(const K &key, const V &value) {
+        insert(key, value);
+    }
+
+    void put(K &&key, V &&value) {
+        insert(std::move(key), std::move(value));
+    }
+
+    std::optional<V> get(const K &key) {
+        return optionalOf(access(key));
     }
 
-    [[nodiscard]] bool contains(const K &key) const override {
+    template<LookupKey<K> Q>
+    std::optional<V> get(const Q &key) {
+        return optionalOf(access(key));
+    }
+
+    const V *find(const K &key) {
+        return access(key);
+    }
+
+    /// 只读查找,不提升频率;供并发装饰器在读锁下调用
+    [[nodiscard]] std::optional<V> peek(const K &key) const {
+        return optionalOf(lookup(key));
+    }
+
+    template<LookupKey<K> Q>
+    [[nodiscard]] std::optional<V> peek(const Q &key) const {
+        return optionalOf(lookup(key));
+    }
+
+    /// 与 peek 相同,但返回指向缓存内值的指针而不复制
+    [[nodiscard]] const V *peekValue(const K &key) const {
+        return lookup(key);
+    }
+
+    template<LookupKey<K> Q>
+    [[nodiscard]] const V *peekValue(const Q &key) const {
+        return lookup(key);
+    }
+
+    /// 记录一次访问:提升频率;key 不存在时无操作
+    void touch(const K &key) {
+        auto it = m_nodes.find(key);
+        if (it == m_nodes.end()) return;
+        promote(it->first, it->second);
+    }
+
+    void erase(const K &key) {
+        remove(key);
+    }
+
+    template<LookupKey<K> Q>
+    void erase(const Q &key) {
+        remove(key);
+    }
+
+    void prefetch(const K &key) const {
+        prefetchIndex(m_nodes, key);
+    }
+
+    [[nodiscard]] bool contains(const K &key) const {
+        return m_nodes.count(key) != 0;
+    }
+
+    template<LookupKey<K> Q>
+    [[nodiscard]] bool contains(const Q &key) const {
         return m_nodes.count(key) != 0;
     }
 
-    [[nodiscard]] std::size_t size() const override {
+    [[nodiscard]] std::size_t size() const {
         return m_nodes.size();
     }
+
+    /// 当前计费总和
+    [[nodiscard]] std::size_t totalCharge() const noexcept {
+        return m_totalCharge;
+    }
+
+    /// 按淘汰顺序复制出所有条目:频率低的在前,同频率内最早进入的在前;meta 为访问频率
+    /// 并发装饰器在读锁下调用,序列化在锁外进行
+    [[nodiscard]] SnapshotData<K, V> snapshot() const {
+        SnapshotData<K, V> data{SnapshotPolicy::LFU, {}};
+        data.entries.reserve(m_nodes.size());
+        std::vector<int> freqs;
+        freqs.reserve(m_freq_list.size());
+        for (const auto &[freq, keys]: m_freq_list) freqs.push_back(freq);
+        std::sort(freqs.begin(), freqs.end());
+        for (int freq: freqs) {
+            for (const auto &handle: m_freq_list.find(freq)->second) {
+                auto it = m_nodes.find(Handle::get(handle));
+                data.entries.push_back({it->first, it->second.val, static_cast<std::uint64_t>(freq)});
+            }
+        }
+        return data;
+    }
+
+    /// 按快照顺序插入条目并恢复各自的访问频率;已有的同 key 条目被替换
+    /// 容量小于快照时,频率最低的条目照常被淘汰;快照来自其他策略时抛出 std::runtime_error
+    void restore(SnapshotData<K, V> &&data) {
+        data.expect(SnapshotPolicy::LFU);
+        for (auto &entry: data.entries) {
+            m_stats.recordPut();
+            remove(entry.key, RemovalCause::Replaced);
+            std::size_t charge = m_sizer(entry.key, entry.value);
+            if (charge > m_capacity) {
+                m_stats.recordEviction(EvictionCause::Rejected);
+                if (m_removals) m_removals.push(std::move(entry.key), std::move(entry.value), RemovalCause::Capacity);
+                continue;
+            }
+            int freq = static_cast<int>(std::clamp<std::uint64_t>(entry.meta, 1, std::numeric_limits<int>::max()));
+            emplaceNode(std::move(entry.key), std::move(entry.value), freq, charge);
+        }
+    }
+
+    /// 把条目与淘汰状态保存到 path(见 Snapshot.hpp);K 与 V 需要 Serializer
+    void saveSnapshot(const std::string &path) const {
+        writeSnapshot(path, snapshot());
+    }
+
+    /// 从 path 加载快照(见 Snapshot.hpp);文件损坏、版本不符或来自其他策略时抛出 std::runtime_error,缓存不变
+    void loadSnapshot(const std::string &path) {
+        restore(readSnapshot<K, V>(path));
+    }
+
+    /// 被移除条目的去处(见 Removal.hpp);nullptr(默认)表示就地析构
+    void collectRemovals(RemovalBatch<K, V> *batch) noexcept {
+        m_removals.attach(batch);
+    }
+
+    [[nodiscard]] RemovalBatch<K, V> *removalBatch() const noexcept {
+        return m_removals.batch();
+    }
+
+    /// 统计器(见 Stats.hpp)
+    [[nodiscard]] Stats &statsRecorder() const noexcept {
+        return m_stats;
+    }
+
+    /// 节点容器使用的内存资源
+    [[nodiscard]] std::pmr::memory_resource *resource() const noexcept {
+        return m_nodes.get_allocator().resource();
+    }
 };
 
 #endif //CACHE_LFUCACHE_HPP
@@ -2,77 +2,253 @@
 #define CACHE_LRUCACHE_HPP
 
 #include "Cache.hpp"
+#include "HashIndex.hpp"
+#include "Sizer.hpp"
+#include "Removal.hpp"
+#include "Snapshot.hpp"
+#include "Stats.hpp"
 #include <list>
+#include <memory_resource>
 #include <functional>
+#include <string>
 #include <type_traits>
+#include <utility>
 
 /// LRU 策略缓存:最近最少使用淘汰
 /// 容量 > 0
 /// 异常安全:插入失败时回滚
-template<typename K, typename V>
-class LRUCache : public Cache<K, V> {
+/// Index 为 key 索引容器选择器(见 HashIndex.hpp)
+/// Sizer 为条目计费器(见 Sizer.hpp),capacity 是计费总和的上限
+/// Stats 为统计器(见 Stats.hpp),默认 NoStats 不做任何统计
+/// 调用 collectRemovals 后,被淘汰、删除、替换或拒绝的条目移入批次而不是就地析构(见 Removal.hpp)
+/// saveSnapshot/loadSnapshot 保存与恢复条目及访问顺序(见 Snapshot.hpp)
+/// get/peek/erase/contains 另有异构重载(见 KeyTraits.hpp)
+/// 所有节点容器从构造时给出的 std::pmr::memory_resource 分配(默认为全局分配器,见 NodePool.hpp)
+template<typename K, typename V, typename Index = StdHashIndex, typename Sizer = UnitSizer, typename Stats = NoStats>
+class LRUCache : public CacheBase<LRUCache<K, V, Index, Sizer, Stats>, K, V> {
 private:
     static_assert(
             std::is_default_constructible_v<std::hash<K>>,
             "Key type K must be hashable: provide specialization of std::hash<K> if needed"
     );
-    std::size_t m_capacity;
-    std::list<std::pair<K, V>> m_list;   // MRU at back, LRU at front
-    std::unordered_map<
+    std::size_t m_capacity;          // 计费预算
+    std::size_t m_totalCharge = 0;   // 当前计费总和
+    [[no_unique_address]] Sizer m_sizer;
+    [[no_unique_address]] mutable Stats m_stats;
+    std::pmr::list<std::pair<K, V>> m_list;   // MRU at back, LRU at front
+    typename Index::template map<
             K,
-            typename std::list<std::pair<K, V>>::iterator
+            typename std::pmr::list<std::pair<K, V>>::iterator
     > m_map;  // key -> iterator into m_list
+    RemovalSink<K, V> m_removals;
 
-public:
-    explicit LRUCache(std::size_t capacity)
-            : m_capacity(capacity) {
-        if (capacity == 0) throw std::invalid_argument("LRUCache capacity must be > 0");
-    }
-
-    void put(const K &key, const V &value) override {
-        auto it = m_map.find(key);
-        if (it != m_map.end()) {
-            // update value and move to back
-            it->second->second = value;
-            m_list.splice(m_list.end(), m_list, it->second);
-            return;
-        }
-        if (m_list.size() >= m_capacity) {
+    void evictWhileOver() {
+        while (m_totalCharge > m_capacity) {
             auto &lru = m_list.front();
+            m_totalCharge -= m_sizer(lru.first, lru.second);
             m_map.erase(lru.first);
+            if (m_removals) m_removals.push(std::move(lru.first), std::move(lru.second), RemovalCause::Capacity);
             m_list.pop_front();
+            m_stats.recordEviction(EvictionCause::Size);
         }
-        // insert new entry at back
-        m_list.emplace_back(key, value);
-        auto lit = m_list.end();
-        --lit;
-        m_map[key] = lit;
     }
 
-    std::optional<V> get(const K &key) override {
+    template<typename Q>
+    const V *access(const Q &key) {
         auto it = m_map.find(key);
-        if (it == m_map.end())
-            return std::nullopt;
+        if (it == m_map.end()) {
+            m_stats.recordMiss();
+            return nullptr;
+        }
+        m_stats.recordHit();
         // move to back and return value
         auto lit = it->second;
         m_list.splice(m_list.end(), m_list, lit);
-        return lit->second;
+        return &lit->second;
+    }
+
+    template<typename Q>
+    const V *lookup(const Q &key) const {
+        auto it = m_map.find(key);
+        if (it == m_map.end())
+            return nullptr;
+        return &it->second->second;
     }
 
-    void erase(const K &key) override {
+    template<typename Q>
+    void remove(const Q &key, RemovalCause cause = RemovalCause::Explicit) {
         auto it = m_map.find(key);
         if (it == m_map.end()) return;
-        m_list.erase(it->second);
+        auto lit = it->second;
+        m_totalCharge -= m_sizer(lit->first, lit->second);
         m_map.erase(it);
+        if (m_removals) m_removals.push(std::move(lit->first), std::move(lit->second), cause);
+        m_list.erase(lit);
+    }
+
+    template<typename KK, typename VV>
+    void insert(KK &&key, VV &&value) {
+        m_stats.recordPut();
+        std::size_t charge = m_sizer(key, value);
+        auto it = m_map.find(key);
+        if (charge > m_capacity) {
+            // larger than the whole budget: reject and drop the stale value
+            if (it != m_map.end()) remove(key, RemovalCause::Replaced);
+            m_stats.recordEviction(EvictionCause::Rejected);
+            if (m_removals) m_removals.push(std::forward<KK>(key), std::forward<VV>(value), RemovalCause::Capacity);
+            return;
+        }
+        if (it != m_map.end()) {
+            // update value and move to back; the MRU entry is evicted last
+            auto lit = it->second;
+            m_totalCharge = m_totalCharge - m_sizer(lit->first, lit->second) + charge;
+            if (m_removals) m_removals.push(lit->first, std::move(lit->second), RemovalCause::Replaced);
+            lit->second = std::forward<VV>(value);
+            m_list.splice(m_list.end(), m_list, lit);
+            evictWhileOver();
+            return;
+        }
+        m_totalCharge += charge;
+        evictWhileOver();
+        // insert new entry at back
+        m_list.emplace_back(std::forward<KK>(key), std::forward<VV>(value));
+        auto lit = m_list.end();
+        --lit;
+        m_map[lit->first] = lit;
+    }
+
+public:
+    explicit LRUCache(std::size_t capacity, Sizer sizer = Sizer{},
+                      std::pmr::memory_resource *resource = std::pmr::get_default_resource())
+            : m_capacity(capacity), m_sizer(std::move(sizer)), m_list(resource), m_map(resource) {
+        if (capacity == 0) throw std::invalid_argument("LRUCache capacity must be > 0");
+    }
+
+    LRUCache(std::size_t capacity, std::pmr::memory_resource *resource)
+            : LRUCache(capacity, Sizer{}, resource) {}
+
+    void put(const K &key, const V &value) {
+        insert(key, value);
+    }
+
+    void put(K &&key, V &&value) {
+        insert(std::move(key), std::move(value));
+    }
+
+    std::optional<V> get(const K &key) {
+        return optionalOf(access(key));
+    }
+
+    template<LookupKey<K> Q>
+    std::optional<V> get(const Q &key) {
+        return optionalOf(access(key));
     }
 
-    [[nodiscard]] bool contains(const K &key) const override {
+    const V *find(const K &key) {
+        return access(key);
+    }
+
+    /// 只读查找,不调整顺序;供并发装饰器在读锁下调用
+    [[nodiscard]] std::optional<V> peek(const K &key) const {
+        return optionalOf(lookup(key));
+    }
+
+    template<LookupKey<K> Q>
+    [[nodiscard]] std::optional<V> peek(const Q &key) const {
+        return optionalOf(lookup(key));
+    }
+
+    /// 与 peek 相同,但返回指向缓存内值的指针而不复制
+    [[nodiscard]] const V *peekValue(const K &key) const {
+        return lookup(key);
+    }
+
+    template<LookupKey<K> Q>
+    [[nodiscard]] const V *peekValue(const Q &key) const {
+        return lookup(key);
+    }
+
+    /// 记录一次访问:移到队尾;key 不存在时无操作
+    void touch(const K &key) {
+        auto it = m_map.find(key);
+        if (it == m_map.end()) return;
+        m_list.splice(m_list.end(), m_list, it->second);
+    }
+
+    void erase(const K &key) {
+        remove(key);
+    }
+
+    template<LookupKey<K> Q>
+    void erase(const Q &key) {
+        remove(key);
+    }
+
+    void prefetch(const K &key) const {
+        prefetchIndex(m_map, key);
+    }
+
+    [[nodiscard]] bool contains(const K &key) const {
         return m_map.count(key) != 0;
     }
 
-    [[nodiscard]] std::size_t size() const override {
+    template<LookupKey<K> Q>
+    [[nodiscard]] bool contains(const Q &key) const {
+        return m_map.count(key) != 0;
+    }
+
+    [[nodiscard]] std::size_t size() const {
         return m_map.size();
     }
+
+    /// 当前计费总和
+    [[nodiscard]] std::size_t totalCharge() const noexcept {
+        return m_totalCharge;
+    }
+
+    /// 按淘汰顺序复制出所有条目(最久未使用的在前);并发装饰器在读锁下调用,序列化在锁外进行
+    [[nodiscard]] SnapshotData<K, V> snapshot() const {
+        SnapshotData<K, V> data{SnapshotPolicy::LRU, {}};
+        data.entries.reserve(m_list.size());
+        for (const auto &[key, value]: m_list) data.entries.push_back({key, value});
+        return data;
+    }
+
+    /// 按快照顺序插入条目,恢复访问顺序;快照中的条目视为比已有条目更近被访问
+    /// 容量小于快照时,最久未使用的条目照常被淘汰;快照来自其他策略时抛出 std::runtime_error
+    void restore(SnapshotData<K, V> &&data) {
+        data.expect(SnapshotPolicy::LRU);
+        for (auto &entry: data.entries) insert(std::move(entry.key), std::move(entry.value));
+    }
+
+    /// 把条目与淘汰状态保存到 path(见 Snapshot.hpp);K 与 V 需要 Serializer
+    void saveSnapshot(const std::string &path) const {
+        writeSnapshot(path, snapshot());
+    }
+
+    /// 从 path 加载快照(见 Snapshot.hpp);文件损坏、版本不符或来自其他策略时抛出 std::runtime_error,缓存不变
+    void loadSnapshot(const std::string &path) {
+        restore(readSnapshot<K, V>(path));
+    }
+
+    /// 被移除条目的去处(见 Removal.hpp);nullptr(默认)表示就地析构
+    void collectRemovals(RemovalBatch<K, V> *batch) noexcept {
+        m_removals.attach(batch);
+    }
+
+    [[nodiscard]] RemovalBatch<K, V> *removalBatch() const noexcept {
+        return m_removals.batch();
+    }
+
+    /// 统计器(见 Stats.hpp)
+    [[nodiscard]] Stats &statsRecorder() const noexcept {
+        return m_stats;
+    }
+
+    /// 节点容器使用的内存资源
+    [[nodiscard]] std::pmr::memory_resource *resource() const noexcept {
+        return m_map.get_allocator().resource();
+    }
 };
 
 #endif //CACHE_LRUCACHE_HPP
@@ -0,0 +1,112 @@
+#ifndef CACHE_MAPPEDFILE_HPP
+#define CACHE_MAPPEDFILE_HPP
+
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/// 只读内存映射文件:内容按需由操作系统换入,不必整体读进内存,适合流式读取数 GB 的文件
+/// POSIX 下为 mmap(并提示顺序访问),Windows 下为 CreateFileMapping;打开或映射失败时抛出 std::runtime_error
+/// 空文件合法,data() 为 nullptr、size() 为 0
+class MappedFile {
+private:
+    const char *m_data = nullptr;
+    std::size_t m_size = 0;
+
+    void release() noexcept {
+        if (m_data == nullptr) return;
+#if defined(_WIN32)
+        UnmapViewOfFile(m_data);
+#else
+        munmap(const_cast<char *>(m_data), m_size);
+#endif
+        m_data = nullptr;
+        m_size = 0;
+    }
+
+public:
+    explicit MappedFile(const std::string &path) {
+#if defined(_WIN32)
+        HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                  FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file == INVALID_HANDLE_VALUE) throw std::runtime_error("MappedFile: cannot open " + path);
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(file, &size)) {
+            CloseHandle(file);
+            throw std::runtime_error("MappedFile: cannot stat " + path);
+        }
+        m_size = static_cast<std::size_t>(size.QuadPart);
+        if (m_size > 0) {
+            HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (mapping != nullptr) {
+                m_data = static_cast<const char *>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+                CloseHandle(mapping);
+            }
+        }
+        CloseHandle(file);
+        if (m_size > 0 && m_data == nullptr) throw std::runtime_error("MappedFile: cannot map " + path);
+#else
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) throw std::runtime_error("MappedFile: cannot open " + path);
+        struct stat st{};
+        if (::fstat(fd, &st) != 0) {
+            ::close(fd);
+            throw std::runtime_error("MappedFile: cannot stat " + path);
+        }
+        m_size = static_cast<std::size_t>(st.st_size);
+        if (m_size > 0) {
+            void *addr = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (addr == MAP_FAILED) {
+                ::close(fd);
+                throw std::runtime_error("MappedFile: cannot map " + path);
+            }
+            ::madvise(addr, m_size, MADV_SEQUENTIAL);
+            m_data = static_cast<const char *>(addr);
+        }
+        ::close(fd);
+#endif
+    }
+
+    MappedFile(const MappedFile &) = delete;
+
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    MappedFile(MappedFile &&other) noexcept
+            : m_data(std::exchange(other.m_data, nullptr)), m_size(std::exchange(other.m_size, 0)) {}
+
+    MappedFile &operator=(MappedFile &&other) noexcept {
+        if (this != &other) {
+            release();
+            m_data = std::exchange(other.m_data, nullptr);
+            m_size = std::exchange(other.m_size, 0);
+        }
+        return *this;
+    }
+
+    ~MappedFile() {
+        release();
+    }
+
+    [[nodiscard]] const char *data() const noexcept {
+        return m_data;
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept {
+        return m_size;
+    }
+};
+
+#endif //CACHE_MAPPEDFILE_HPP
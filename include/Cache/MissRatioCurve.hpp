@@ -0,0 +1,188 @@
+#ifndef CACHE_MISSRATIOCURVE_HPP
+#define CACHE_MISSRATIOCURVE_HPP
+
+#include "Utility.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <queue>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/// LRU 的 miss-ratio curve:容量 -> 未命中率
+/// 由 MissRatioCurveBuilder 一遍扫描 trace 得到
+class MissRatioCurve {
+private:
+    std::vector<std::pair<std::uint64_t, double>> m_hits;  // (栈距离, 栈距离 <= 它的访问所占的比例),按距离升序
+    std::uint64_t m_references = 0;
+
+public:
+    MissRatioCurve() = default;
+
+    MissRatioCurve(std::vector<std::pair<std::uint64_t, double>> cumulativeHits, std::uint64_t references)
+            : m_hits(std::move(cumulativeHits)), m_references(references) {}
+
+    /// 容量为 capacity(条目数)的 LRU 的命中率
+    [[nodiscard]] double hitRatio(std::size_t capacity) const noexcept {
+        auto it = std::upper_bound(m_hits.begin(), m_hits.end(), capacity,
+                                   [](std::size_t c, const auto &point) { return c < point.first; });
+        if (it == m_hits.begin()) return 0.0;
+        return std::clamp(std::prev(it)->second, 0.0, 1.0);
+    }
+
+    [[nodiscard]] double missRatio(std::size_t capacity) const noexcept {
+        return 1.0 - hitRatio(capacity);
+    }
+
+    /// 扫描过的访问总数(含未被采样的)
+    [[nodiscard]] std::uint64_t references() const noexcept {
+        return m_references;
+    }
+
+    /// 出现过的最大栈距离;容量超过它之后曲线不再下降
+    [[nodiscard]] std::uint64_t maxDistance() const noexcept {
+        return m_hits.empty() ? 0 : m_hits.back().first;
+    }
+};
+
+/// 一遍扫描计算 LRU 的 miss-ratio curve
+/// - Mattson 栈距离:一次访问的栈距离 = 自上次访问该 key 以来访问过的不同 key 数 + 1,
+///   容量为 c 的 LRU 命中当且仅当栈距离 <= c,因此一遍扫描即可得到所有容量下的命中率
+/// - 每个 key 记录最近一次访问的时间戳,树状数组统计"仍是各自 key 最近一次访问"的时间戳,
+///   栈距离即上次时间戳之后的计数,每次访问 O(log n);时间戳数超过跟踪的 key 数两倍时重新编号,
+///   内存因此只与跟踪的 key 数成正比,而与 trace 长度无关
+/// - SHARDS 空间采样:只跟踪 hash(key) 低于阈值的 key(采样率 R),栈距离按 1/R 放大,
+///   每次采样到的访问代表 1/R 次访问;结束时把采样数与期望值的差额计入最小距离(SHARDS-adj)
+/// - 给出 maxSampledKeys 时为定长版本:跟踪的 key 超过上限后,淘汰哈希值最大的 key 并把阈值降到它,
+///   内存有固定上界,适合 key 数未知的超大 trace
+class MissRatioCurveBuilder {
+private:
+    static constexpr std::uint64_t kHashSpace = std::uint64_t{1} << 56;
+
+    std::uint64_t m_threshold;        // 采样阈值:mixHash(key) >> 8 < m_threshold 的 key 被跟踪
+    std::size_t m_maxSampledKeys;     // 0 表示不限
+    std::uint64_t m_references = 0;
+    double m_sampledWeight = 0;       // 采样到的访问的权重和
+    double m_coldWeight = 0;          // 首次访问(冷未命中)的权重和
+    std::map<std::uint64_t, double> m_histogram;  // 放大后的栈距离 -> 权重
+    std::unordered_map<std::uint64_t, std::uint64_t> m_lastAccess;  // key -> 时间戳(从 1 开始)
+    std::vector<std::int64_t> m_tree{0};  // 树状数组,下标从 1 开始
+    std::priority_queue<std::pair<std::uint64_t, std::uint64_t>> m_byHash;  // 定长版本:(哈希, key)
+
+    static std::uint64_t lowbit(std::uint64_t i) noexcept {
+        return i & (~i + 1);
+    }
+
+    [[nodiscard]] std::int64_t prefix(std::uint64_t i) const noexcept {
+        std::int64_t sum = 0;
+        for (; i > 0; i -= lowbit(i)) sum += m_tree[i];
+        return sum;
+    }
+
+    void add(std::uint64_t i, std::int64_t delta) noexcept {
+        for (; i < m_tree.size(); i += lowbit(i)) m_tree[i] += delta;
+    }
+
+    // 在末尾追加一个计数为 1 的时间戳:新节点覆盖 (i - lowbit(i), i]
+    std::uint64_t append() {
+        std::uint64_t i = m_tree.size();
+        m_tree.push_back(1 + prefix(i - 1) - prefix(i - lowbit(i)));
+        return i;
+    }
+
+    // 按最近访问顺序把存活的时间戳重新编号为 1..n,全为 1 的树状数组节点值即 lowbit(i)
+    void compact() {
+        std::vector<std::pair<std::uint64_t, std::uint64_t>> order;  // (时间戳, key)
+        order.reserve(m_lastAccess.size());
+        for (const auto &[key, stamp]: m_lastAccess) order.emplace_back(stamp, key);
+        std::sort(order.begin(), order.end());
+        m_tree.assign(order.size() + 1, 0);
+        for (std::uint64_t i = 1; i <= order.size(); ++i) {
+            m_tree[i] = static_cast<std::int64_t>(lowbit(i));
+            m_lastAccess[order[i - 1].second] = i;
+        }
+    }
+
+    [[nodiscard]] double rate() const noexcept {
+        return static_cast<double>(m_threshold) / static_cast<double>(kHashSpace);
+    }
+
+    void shrink() {
+        while (m_lastAccess.size() > m_maxSampledKeys && !m_byHash.empty()) {
+            auto [hash, key] = m_byHash.top();
+            m_byHash.pop();
+            auto it = m_lastAccess.find(key);
+            add(it->second, -1);
+            m_lastAccess.erase(it);
+            m_threshold = hash;
+        }
+    }
+
+public:
+    /// sampleRate ∈ (0, 1];1 为精确计算
+    explicit MissRatioCurveBuilder(double sampleRate = 1.0, std::size_t maxSampledKeys = 0)
+            : m_threshold(static_cast<std::uint64_t>(std::clamp(sampleRate, 0.0, 1.0) * static_cast<double>(kHashSpace))),
+              m_maxSampledKeys(maxSampledKeys) {
+        if (!(sampleRate > 0.0) || sampleRate > 1.0)
+            throw std::invalid_argument("MissRatioCurveBuilder sample rate must be in (0, 1]");
+        m_threshold = std::max<std::uint64_t>(1, m_threshold);
+    }
+
+    /// 记录一次访问
+    void access(std::uint64_t key) {
+        ++m_references;
+        std::uint64_t hash = mixHash(key) >> 8;
+        if (hash >= m_threshold) return;
+        double weight = 1.0 / rate();
+        m_sampledWeight += weight;
+        auto it = m_lastAccess.find(key);
+        if (it == m_lastAccess.end()) {
+            m_coldWeight += weight;
+            it = m_lastAccess.emplace(key, 0).first;
+            if (m_maxSampledKeys > 0) m_byHash.emplace(hash, key);
+        } else {
+            auto newer = static_cast<std::uint64_t>(static_cast<std::int64_t>(m_lastAccess.size()) - prefix(it->second));
+            auto distance = static_cast<std::uint64_t>(static_cast<double>(newer + 1) * weight);
+            m_histogram[std::max<std::uint64_t>(1, distance)] += weight;
+            add(it->second, -1);
+        }
+        it->second = append();
+        if (m_maxSampledKeys > 0 && m_lastAccess.size() > m_maxSampledKeys) shrink();
+        if (m_tree.size() > 2 * m_lastAccess.size() + 1024) compact();
+    }
+
+    /// 当前的采样率(定长版本会随 key 数增长而下降)
+    [[nodiscard]] double sampleRate() const noexcept {
+        return rate();
+    }
+
+    /// 正在跟踪的 key 数
+    [[nodiscard]] std::size_t trackedKeys() const noexcept {
+        return m_lastAccess.size();
+    }
+
+    [[nodiscard]] MissRatioCurve build() const {
+        double total = static_cast<double>(m_references);
+        if (total == 0) return {};
+        // SHARDS-adj:采样到的访问数与期望值的差额计入最小距离
+        double adjustment = total - m_sampledWeight;
+        std::vector<std::pair<std::uint64_t, double>> points;
+        points.reserve(m_histogram.size() + 1);
+        double cumulative = 0;
+        bool adjusted = false;
+        for (const auto &[distance, weight]: m_histogram) {
+            cumulative += weight;
+            if (!adjusted) {
+                cumulative += adjustment;
+                adjusted = true;
+            }
+            points.emplace_back(distance, cumulative / total);
+        }
+        return {std::move(points), m_references};
+    }
+};
+
+#endif //CACHE_MISSRATIOCURVE_HPP
@@ -0,0 +1,135 @@
+#ifndef CACHE_NODEPOOL_HPP
+#define CACHE_NODEPOOL_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <memory_resource>
+#include <mutex>
+#include <new>
+
+/// 不加锁的互斥量占位,供单线程使用的 BasicNodePoolResource
+struct NullMutex {
+    void lock() noexcept {}
+
+    void unlock() noexcept {}
+};
+
+/// 定长节点池:为缓存的链表/哈希表节点提供 std::pmr::memory_resource
+/// - 不超过 256 字节的请求按 16 字节粒度归入大小类,每个大小类维护一条空闲链表
+/// - 空闲链表耗尽时向上游申请一整块,块中节点数从 16 起倍增到 1024;释放的节点回到空闲链表,
+///   只在 release() 或析构时归还上游,稳态淘汰/插入因此不访问全局分配器
+/// - 更大或对齐要求更高的请求(如哈希表的桶数组)直接转给上游
+/// 必须比所有使用它的缓存活得久;Mutex 为 NullMutex 时不是线程安全的
+template<typename Mutex>
+class BasicNodePoolResource : public std::pmr::memory_resource {
+private:
+    static constexpr std::size_t kGranularity = 16;
+    static constexpr std::size_t kMaxBlock = 256;
+    static constexpr std::size_t kClasses = kMaxBlock / kGranularity;
+    static constexpr std::size_t kMinChunkBlocks = 16;
+    static constexpr std::size_t kMaxChunkBlocks = 1024;
+    static constexpr std::size_t kAlignment = alignof(std::max_align_t);
+
+    struct FreeBlock {
+        FreeBlock *next;
+    };
+
+    // 位于每个块的开头,把所有块串起来以便 release()
+    struct Chunk {
+        Chunk *next;
+        std::size_t bytes;
+    };
+    static constexpr std::size_t kHeader = (sizeof(Chunk) + kAlignment - 1) / kAlignment * kAlignment;
+
+    struct SizeClass {
+        FreeBlock *free = nullptr;
+        std::size_t nextChunkBlocks = kMinChunkBlocks;
+    };
+
+    std::pmr::memory_resource *m_upstream;
+    Chunk *m_chunks = nullptr;
+    std::array<SizeClass, kClasses> m_classes{};
+    Mutex m_mutex;
+
+    static bool pooled(std::size_t bytes, std::size_t alignment) noexcept {
+        return bytes <= kMaxBlock && alignment <= kAlignment;
+    }
+
+    static std::size_t classOf(std::size_t bytes) noexcept {
+        return bytes == 0 ? 0 : (bytes - 1) / kGranularity;
+    }
+
+    void refill(SizeClass &sizeClass, std::size_t blockSize) {
+        std::size_t blocks = sizeClass.nextChunkBlocks;
+        std::size_t bytes = kHeader + blocks * blockSize;
+        void *raw = m_upstream->allocate(bytes, kAlignment);
+        m_chunks = ::new(raw) Chunk{m_chunks, bytes};
+        std::byte *base = static_cast<std::byte *>(raw) + kHeader;
+        for (std::size_t i = blocks; i-- > 0;) {
+            sizeClass.free = ::new(base + i * blockSize) FreeBlock{sizeClass.free};
+        }
+        sizeClass.nextChunkBlocks = std::min(blocks * 2, kMaxChunkBlocks);
+    }
+
+protected:
+    void *do_allocate(std::size_t bytes, std::size_t alignment) override {
+        if (!pooled(bytes, alignment)) return m_upstream->allocate(bytes, alignment);
+        std::size_t index = classOf(bytes);
+        std::lock_guard lock(m_mutex);
+        SizeClass &sizeClass = m_classes[index];
+        if (sizeClass.free == nullptr) refill(sizeClass, (index + 1) * kGranularity);
+        FreeBlock *block = sizeClass.free;
+        sizeClass.free = block->next;
+        return block;
+    }
+
+    void do_deallocate(void *p, std::size_t bytes, std::size_t alignment) override {
+        if (!pooled(bytes, alignment)) {
+            m_upstream->deallocate(p, bytes, alignment);
+            return;
+        }
+        std::lock_guard lock(m_mutex);
+        SizeClass &sizeClass = m_classes[classOf(bytes)];
+        sizeClass.free = ::new(p) FreeBlock{sizeClass.free};
+    }
+
+    [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override {
+        return this == &other;
+    }
+
+public:
+    explicit BasicNodePoolResource(std::pmr::memory_resource *upstream = std::pmr::get_default_resource())
+            : m_upstream(upstream) {}
+
+    BasicNodePoolResource(const BasicNodePoolResource &) = delete;
+
+    BasicNodePoolResource &operator=(const BasicNodePoolResource &) = delete;
+
+    ~BasicNodePoolResource() override {
+        release();
+    }
+
+    /// 把所有块归还上游;调用时不得仍有节点在使用
+    void release() {
+        std::lock_guard lock(m_mutex);
+        while (m_chunks != nullptr) {
+            Chunk *chunk = m_chunks;
+            m_chunks = chunk->next;
+            m_upstream->deallocate(chunk, chunk->bytes, kAlignment);
+        }
+        m_classes = {};
+    }
+
+    [[nodiscard]] std::pmr::memory_resource *upstream_resource() const noexcept {
+        return m_upstream;
+    }
+};
+
+/// 单线程节点池:供单个缓存独占(包括被 ConcurrentCache 包装的缓存,其分配都在写锁内)
+using NodePoolResource = BasicNodePoolResource<NullMutex>;
+
+/// 加锁的节点池:供多个缓存或 ShardedConcurrentCache 的各分片共享
+using SynchronizedNodePoolResource = BasicNodePoolResource<std::mutex>;
+
+#endif //CACHE_NODEPOOL_HPP
@@ -0,0 +1,85 @@
+#ifndef CACHE_ORDERING_HPP
+#define CACHE_ORDERING_HPP
+
+#include <cstdint>
+#include <iterator>
+
+/// ComposedCache 的淘汰顺序选择器,作为 Ordering 模板参数传入
+/// 选择器需提供成员类模板 policy<List>,List 为条目链表(std::pmr::list),条目带有一个 std::uint8_t mark 字段;
+/// 新条目总是追加在 back,policy 提供:
+/// - inserted(list, it):新条目已追加
+/// - accessed(list, it):一次命中
+/// - victim(list) -> iterator:选出下一个淘汰对象(不删除,可修改 mark);list 非空
+/// - erasing(list, it):条目即将被删除(淘汰或 erase)
+/// 各函数均在写锁下调用,不需要原子操作
+
+/// LRU:命中移到 back,淘汰 front
+struct LRUOrdering {
+    template<typename List>
+    class policy {
+    public:
+        using iterator = typename List::iterator;
+
+        void inserted(List &, iterator) noexcept {}
+
+        void accessed(List &list, iterator it) noexcept { list.splice(list.end(), list, it); }
+
+        iterator victim(List &list) noexcept { return list.begin(); }
+
+        void erasing(List &, iterator) noexcept {}
+    };
+};
+
+/// FIFO:按插入顺序淘汰,命中不调整顺序
+struct FIFOOrdering {
+    template<typename List>
+    class policy {
+    public:
+        using iterator = typename List::iterator;
+
+        void inserted(List &, iterator) noexcept {}
+
+        void accessed(List &, iterator) noexcept {}
+
+        iterator victim(List &list) noexcept { return list.begin(); }
+
+        void erasing(List &, iterator) noexcept {}
+    };
+};
+
+/// SIEVE:命中只置 mark;指针从最老的条目向较新的条目移动,跳过并清除带 mark 的条目
+struct SIEVEOrdering {
+    template<typename List>
+    class policy {
+    public:
+        using iterator = typename List::iterator;
+
+    private:
+        iterator m_hand{};
+        bool m_hasHand = false;
+
+    public:
+        void inserted(List &, iterator) noexcept {}
+
+        void accessed(List &, iterator it) noexcept { it->mark = 1; }
+
+        iterator victim(List &list) noexcept {
+            iterator it = m_hasHand ? m_hand : list.begin();
+            while (it->mark) {
+                it->mark = 0;
+                if (++it == list.end()) it = list.begin();
+            }
+            m_hand = it;
+            m_hasHand = true;
+            return it;
+        }
+
+        void erasing(List &list, iterator it) noexcept {
+            if (!m_hasHand || m_hand != it) return;
+            m_hand = std::next(it);
+            m_hasHand = m_hand != list.end();
+        }
+    };
+};
+
+#endif //CACHE_ORDERING_HPP
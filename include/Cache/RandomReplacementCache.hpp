@@ -2,85 +2,232 @@
 #define CACHE_RANDOMREPLACEMENTCACHE_HPP
 
 #include "Cache.hpp"
+#include "Eviction.hpp"
+#include "HashIndex.hpp"
+#include "Sizer.hpp"
+#include "Removal.hpp"
+#include "Stats.hpp"
+#include <memory_resource>
 #include <vector>
-#include <unordered_map>
 #include <random>
 #include <stdexcept>
 #include <type_traits>
+#include <utility>
 
 /// 随机替换策略缓存:当容量满时,随机淘汰一个元素
 /// 要求 K 可哈希
+/// Index 为 key 索引容器选择器(见 HashIndex.hpp)
+/// Sizer 为条目计费器(见 Sizer.hpp),capacity 是计费总和的上限
+/// Stats 为统计器(见 Stats.hpp),默认 NoStats 不做任何统计
+/// Eviction 为淘汰选择器(见 Eviction.hpp):默认 UniformEviction 均匀随机淘汰;
+/// SampledEviction<Rank, Samples, PoolSize> 抽样若干条目并按上次访问、访问次数或剩余 TTL 淘汰最差的一个,
+/// 命中只写条目自己的元数据(relaxed 原子写),get 仍可在读锁下并发调用
+/// 例:RandomReplacementCache<K, V, StdHashIndex, UnitSizer, NoStats, SampledEviction<LeastRecentlyUsed>>
+/// 调用 collectRemovals 后,被淘汰、删除、替换或拒绝的条目移入批次而不是就地析构(见 Removal.hpp)
+/// get/erase/contains 另有异构重载(见 KeyTraits.hpp)
+/// 所有节点容器从构造时给出的 std::pmr::memory_resource 分配(默认为全局分配器,见 NodePool.hpp)
 
-template<typename K, typename V>
-class RandomReplacementCache : public Cache<K, V> {
+template<typename K, typename V, typename Index = StdHashIndex, typename Sizer = UnitSizer, typename Stats = NoStats,
+        typename Eviction = UniformEviction>
+class RandomReplacementCache : public CacheBase<RandomReplacementCache<K, V, Index, Sizer, Stats, Eviction>, K, V> {
 private:
     static_assert(
             std::is_default_constructible_v<std::hash<K>>,
             "Key type K must be hashable: provide specialization of std::hash<K> if needed"
     );
-    std::size_t m_capacity;
-    std::vector<K> m_keys;                              // 用于随机访问的 key 列表
-    std::unordered_map<K, std::pair<V, std::size_t>> m_map; // key -> (value, index in m_keys)
+    std::size_t m_capacity;                             // 计费预算
+    std::size_t m_totalCharge = 0;                      // 当前计费总和
+    [[no_unique_address]] Sizer m_sizer;
+    [[no_unique_address]] mutable Stats m_stats;
+    using Handle = KeyHandle<Index, K>;
+    std::pmr::vector<typename Handle::type> m_keys;          // 用于随机访问的 key 列表,引用索引中的 key
+    typename Index::template map<K, std::pair<V, std::size_t>> m_map; // key -> (value, index in m_keys)
     mutable std::mt19937 m_gen;                         // 随机数引擎
-public:
-    explicit RandomReplacementCache(std::size_t capacity)
-            : m_capacity(capacity),
-              m_gen(std::random_device{}()) {
-        if (capacity == 0)
-            throw std::invalid_argument("RandomCache capacity must be > 0");
-        m_keys.reserve(capacity);  // 预先分配,避免扩容开销
+    [[no_unique_address]] typename Eviction::template policy<K, V> m_eviction;  // 与 m_keys 一一对应的访问信息
+    RemovalSink<K, V> m_removals;
+
+    // 删除索引中的元素:先用最后一个元素填补它在 m_keys 中的位置,再从索引中移除
+    template<typename It>
+    void removeAt(It it, RemovalCause cause) {
+        m_totalCharge -= m_sizer(it->first, it->second.first);
+        std::size_t idx = it->second.second;
+        m_eviction.removed(idx);
+        if (idx + 1 != m_keys.size()) {
+            m_keys[idx] = std::move(m_keys.back());
+            m_map.find(Handle::get(m_keys[idx]))->second.second = idx;
+        }
+        m_keys.pop_back();
+        m_removals.erase(m_map, it, it->second.first, cause);
     }
 
-    void put(const K &key, const V &value) override {
+    void evictRandom() {
+        // 由淘汰选择器挑选下标(默认均匀随机)
+        std::size_t idx = m_eviction.victim(m_keys.size(), m_gen, [this](std::size_t i) {
+            auto it = m_map.find(Handle::get(m_keys[i]));
+            return std::pair<const K &, const V &>(it->first, it->second.first);
+        });
+        removeAt(m_map.find(Handle::get(m_keys[idx])), RemovalCause::Capacity);
+        m_stats.recordEviction(EvictionCause::Size);
+    }
+
+    // 命中时只向淘汰选择器记录访问,可在读锁下并发执行
+    template<typename Q>
+    const V *lookup(const Q &key) {
         auto it = m_map.find(key);
-        if (it != m_map.end()) {
-            // 已存在:仅更新值
-            it->second.first = value;
+        if (it == m_map.end())
+            return nullptr;
+        m_eviction.accessed(it->second.second);
+        return &it->second.first;
+    }
+
+    template<typename Q>
+    const V *access(const Q &key) {
+        const V *value = lookup(key);
+        if (value != nullptr) m_stats.recordHit();
+        else m_stats.recordMiss();
+        return value;
+    }
+
+    template<typename Q>
+    void remove(const Q &key, RemovalCause cause = RemovalCause::Explicit) {
+        auto it = m_map.find(key);
+        if (it != m_map.end()) removeAt(it, cause);
+    }
+
+    template<typename KK, typename VV>
+    void insert(KK &&key, VV &&value) {
+        m_stats.recordPut();
+        std::size_t charge = m_sizer(key, value);
+        auto it = m_map.find(key);
+        if (charge > m_capacity) {
+            // 超出整个预算:拒绝,同时丢弃旧值
+            if (it != m_map.end()) remove(key, RemovalCause::Replaced);
+            m_stats.recordEviction(EvictionCause::Rejected);
+            if (m_removals) m_removals.push(std::forward<KK>(key), std::forward<VV>(value), RemovalCause::Capacity);
             return;
         }
-        if (m_map.size() >= m_capacity) {
-            // 随机选择一个下标淘汰
-            std::uniform_int_distribution<std::size_t> dist(0, m_keys.size() - 1);
-            std::size_t idx = dist(m_gen);
-            K evict = m_keys[idx];
-            // 用最后一个元素填补 idx,然后 pop_back
-            K last = m_keys.back();
-            m_keys[idx] = last;
-            m_map[last].second = idx;
-            m_keys.pop_back();
-            m_map.erase(evict);
+        if (it != m_map.end()) {
+            std::size_t old_charge = m_sizer(it->first, it->second.first);
+            if (m_totalCharge - old_charge + charge <= m_capacity) {
+                // 已存在:仅更新值
+                if (m_removals) m_removals.push(it->first, std::move(it->second.first), RemovalCause::Replaced);
+                it->second.first = std::forward<VV>(value);
+                m_totalCharge = m_totalCharge - old_charge + charge;
+                m_eviction.accessed(it->second.second);
+                return;
+            }
+            // 更新后超出预算:按新元素重新插入
+            remove(key, RemovalCause::Replaced);
+        }
+        while (m_totalCharge + charge > m_capacity) evictRandom();
+        // 插入新元素:先进入索引,m_keys 只引用索引中的 key
+        it = m_map.try_emplace(std::forward<KK>(key), std::forward<VV>(value), m_keys.size()).first;
+        try {
+            m_keys.push_back(Handle::make(it->first));
+            try {
+                m_eviction.inserted();
+            } catch (...) {
+                m_keys.pop_back();
+                throw;
+            }
+        } catch (...) {
+            m_map.erase(it);
+            throw;
         }
-        // 插入新元素
-        m_keys.push_back(key);
-        m_map.emplace(key, std::make_pair(value, m_keys.size() - 1));
+        m_totalCharge += charge;
     }
 
-    std::optional<V> get(const K &key) override {
-        auto it = m_map.find(key);
-        if (it == m_map.end())
-            return std::nullopt;
-        return it->second.first;
+public:
+    explicit RandomReplacementCache(std::size_t capacity, Sizer sizer = Sizer{},
+                                    std::pmr::memory_resource *resource = std::pmr::get_default_resource())
+            : m_capacity(capacity),
+              m_sizer(std::move(sizer)),
+              m_keys(resource),
+              m_map(resource),
+              m_gen(std::random_device{}()),
+              m_eviction(resource) {
+        if (capacity == 0)
+            throw std::invalid_argument("RandomCache capacity must be > 0");
+        // 按条目计数时预先分配,避免扩容开销;按字节计费时 capacity 不代表条目数
+        if constexpr (std::is_same_v<Sizer, UnitSizer>) {
+            m_keys.reserve(capacity);
+            m_eviction.reserve(capacity);
+        }
     }
 
-    void erase(const K &key) override {
-        auto it = m_map.find(key);
-        if (it == m_map.end()) return;
-        // 删除时同样用最后一个元素填补空位
-        std::size_t idx = it->second.second;
-        K last = m_keys.back();
-        m_keys[idx] = last;
-        m_map[last].second = idx;
-        m_keys.pop_back();
-        m_map.erase(it);
+    RandomReplacementCache(std::size_t capacity, std::pmr::memory_resource *resource)
+            : RandomReplacementCache(capacity, Sizer{}, resource) {}
+
+    void put(const K &key, const V &value) {
+        insert(key, value);
+    }
+
+    void put(K &&key, V &&value) {
+        insert(std::move(key), std::move(value));
+    }
+
+    std::optional<V> get(const K &key) {
+        return optionalOf(access(key));
+    }
+
+    template<LookupKey<K> Q>
+    std::optional<V> get(const Q &key) {
+        return optionalOf(access(key));
+    }
+
+    const V *find(const K &key) {
+        return access(key);
+    }
+
+    void erase(const K &key) {
+        remove(key);
+    }
+
+    template<LookupKey<K> Q>
+    void erase(const Q &key) {
+        remove(key);
     }
 
-    [[nodiscard]] bool contains(const K &key) const override {
+    void prefetch(const K &key) const {
+        prefetchIndex(m_map, key);
+    }
+
+    [[nodiscard]] bool contains(const K &key) const {
+        return m_map.count(key) != 0;
+    }
+
+    template<LookupKey<K> Q>
+    [[nodiscard]] bool contains(const Q &key) const {
         return m_map.count(key) != 0;
     }
 
-    [[nodiscard]] std::size_t size() const override {
+    [[nodiscard]] std::size_t size() const {
         return m_map.size();
     }
+
+    /// 当前计费总和
+    [[nodiscard]] std::size_t totalCharge() const noexcept {
+        return m_totalCharge;
+    }
+
+    /// 被移除条目的去处(见 Removal.hpp);nullptr(默认)表示就地析构
+    void collectRemovals(RemovalBatch<K, V> *batch) noexcept {
+        m_removals.attach(batch);
+    }
+
+    [[nodiscard]] RemovalBatch<K, V> *removalBatch() const noexcept {
+        return m_removals.batch();
+    }
+
+    /// 统计器(见 Stats.hpp)
+    [[nodiscard]] Stats &statsRecorder() const noexcept {
+        return m_stats;
+    }
+
+    /// 节点容器使用的内存资源
+    [[nodiscard]] std::pmr::memory_resource *resource() const noexcept {
+        return m_map.get_allocator().resource();
+    }
 };
 
 #endif //CACHE_RANDOMREPLACEMENTCACHE_HPP
@@ -0,0 +1,222 @@
+#ifndef CACHE_REGIONSTORE_HPP
+#define CACHE_REGIONSTORE_HPP
+
+#include "BlockFile.hpp"
+#include "HashIndex.hpp"
+#include "KeyTraits.hpp"
+#include "Snapshot.hpp"
+#include "Utility.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+/// RegionStore 的文件布局:文件被切成 regionCount 个 regionSize 字节的区域,循环写入
+struct RegionStoreOptions {
+    std::string path;                        // 文件路径;构造时创建或截断
+    std::size_t regionSize = std::size_t{1} << 20;
+    std::size_t regionCount = 64;            // >= 2;文件大小为 regionSize * regionCount
+    std::size_t alignment = 4096;            // 写入的起点与长度按此对齐;regionSize 必须是它的整数倍
+};
+
+struct RegionStoreStats {
+    std::uint64_t regionsWritten = 0;        // 写出的区域数(每个区域一次写入)
+    std::uint64_t bytesWritten = 0;          // 写出的字节数(含对齐填充)
+    std::uint64_t reclaimedEntries = 0;      // 区域被回收时随之丢弃的条目数
+    std::uint64_t rejectedEntries = 0;       // 编码后超过一个区域而未被保存的条目数
+};
+
+/// 基于本地文件的日志结构二级缓存存储(如 NVMe 上的文件),由 HybridCache 作为 DRAM 之后的第二层使用
+/// - 写入:条目由 Serializer(见 Snapshot.hpp)编码后追加到内存中的当前区域,区域写满时按对齐长度一次写出,
+///   小对象的随机写因此合并为整区域的顺序写
+/// - 回收:区域按 FIFO 循环复用,开始写一个区域前丢弃其中所有仍有效的条目,不做压缩、不搬移数据
+/// - 索引:内存中只保存 key 的 64 位指纹 -> (区域, 偏移, 长度),每个条目十几字节,不保存 key 本身;
+///   读出时比较磁盘上的完整 key,指纹碰撞只会让较早的条目被覆盖(contains 在碰撞时可能误报)
+/// - 每条记录带有校验和,读出时校验失败按未命中处理
+/// - 内容只在进程生命周期内有效:索引不落盘,重启后从空文件开始
+/// - lookup/contains 是 const 的,只读内存与 pread,可以在没有写者时并发调用
+template<typename K, typename V>
+class RegionStore {
+private:
+    struct Location {
+        std::uint32_t region;
+        std::uint32_t offset;  // 记录在区域内的偏移
+        std::uint32_t length;  // 记录总长(含记录头)
+    };
+
+    struct AlignedDelete {
+        std::size_t alignment;
+
+        void operator()(char *p) const noexcept {
+            ::operator delete[](p, std::align_val_t(alignment));
+        }
+    };
+
+    // 记录头:负载长度 u32 | 负载校验和低 32 位 u32;负载为 key 与 value 的编码
+    static constexpr std::size_t kRecordHeader = 8;
+
+    std::size_t m_regionSize;
+    std::size_t m_regionCount;
+    std::size_t m_alignment;
+    BlockFile m_file;
+    std::unique_ptr<char[], AlignedDelete> m_buffer;  // 当前区域的内容,写满后才落盘
+    std::uint32_t m_current = 0;                      // 当前写入的区域
+    std::size_t m_used = 0;                           // 当前区域已用字节
+    std::vector<std::vector<std::uint64_t>> m_regionKeys;  // 每个区域写入过的指纹,回收时据此清理索引
+    typename FlatHashIndex::template map<std::uint64_t, Location> m_index;
+    SnapshotWriter m_encoder;
+    RegionStoreStats m_stats;
+
+    static std::uint64_t fingerprint(const K &key) noexcept {
+        return mixHash(static_cast<std::uint64_t>(KeyHash<K>{}(key)));
+    }
+
+    static RegionStoreOptions validate(RegionStoreOptions options) {
+        if (options.alignment == 0 || options.regionSize == 0 || options.regionSize % options.alignment != 0)
+            throw std::invalid_argument("RegionStore region size must be a positive multiple of the alignment");
+        if (options.regionSize > 0xffffffffu || options.regionSize <= kRecordHeader)
+            throw std::invalid_argument("RegionStore region size must be in (8, 4GiB]");
+        if (options.regionCount < 2 || options.regionCount > 0xffffffffu)
+            throw std::invalid_argument("RegionStore needs at least 2 regions");
+        return options;
+    }
+
+    explicit RegionStore(const RegionStoreOptions &options, int)
+            : m_regionSize(options.regionSize), m_regionCount(options.regionCount), m_alignment(options.alignment),
+              m_file(options.path, static_cast<std::uint64_t>(options.regionSize) * options.regionCount),
+              m_buffer(static_cast<char *>(::operator new[](options.regionSize, std::align_val_t(options.alignment))),
+                       AlignedDelete{options.alignment}),
+              m_regionKeys(options.regionCount) {}
+
+    [[nodiscard]] std::uint64_t offsetOf(std::uint32_t region) const noexcept {
+        return static_cast<std::uint64_t>(region) * m_regionSize;
+    }
+
+    // 丢弃区域中仍被索引引用的条目
+    void reclaim(std::uint32_t region) {
+        for (std::uint64_t fp: m_regionKeys[region]) {
+            auto it = m_index.find(fp);
+            if (it == m_index.end() || it->second.region != region) continue;
+            m_index.erase(it);
+            ++m_stats.reclaimedEntries;
+        }
+        m_regionKeys[region].clear();
+    }
+
+    // 把当前区域按对齐长度写出,然后回收下一个区域并开始写它
+    void advance() {
+        std::size_t bytes = (m_used + m_alignment - 1) / m_alignment * m_alignment;
+        std::memset(m_buffer.get() + m_used, 0, bytes - m_used);
+        m_file.write(m_buffer.get(), bytes, offsetOf(m_current));
+        ++m_stats.regionsWritten;
+        m_stats.bytesWritten += bytes;
+        m_current = static_cast<std::uint32_t>((m_current + 1) % m_regionCount);
+        m_used = 0;
+        reclaim(m_current);
+    }
+
+    [[nodiscard]] std::optional<V> read(const K &key, const Location &location) const {
+        std::vector<char> record(location.length);
+        if (location.region == m_current) {
+            std::memcpy(record.data(), m_buffer.get() + location.offset, location.length);
+        } else {
+            m_file.read(record.data(), location.length, offsetOf(location.region) + location.offset);
+        }
+        std::uint32_t size;
+        std::uint32_t checksum;
+        std::memcpy(&size, record.data(), sizeof(size));
+        std::memcpy(&checksum, record.data() + sizeof(size), sizeof(checksum));
+        if (size + kRecordHeader != location.length) return std::nullopt;
+        SnapshotChecksum actual;
+        actual.update(record.data() + kRecordHeader, size);
+        if (static_cast<std::uint32_t>(actual.value()) != checksum) return std::nullopt;
+        SnapshotReader in(record.data() + kRecordHeader, size);
+        K stored = Serializer<K>::read(in);
+        if (!(stored == key)) return std::nullopt;
+        return Serializer<V>::read(in);
+    }
+
+public:
+    /// 参数不合法时抛出 std::invalid_argument,文件无法创建时抛出 std::runtime_error
+    explicit RegionStore(RegionStoreOptions options)
+            : RegionStore(validate(std::move(options)), 0) {}
+
+    RegionStore(const RegionStore &) = delete;
+
+    RegionStore &operator=(const RegionStore &) = delete;
+
+    /// 保存 key 的值,替换之前保存的版本;编码后超过一个区域时不保存并返回 false
+    bool insert(const K &key, const V &value) {
+        m_encoder.clear();
+        Serializer<K>::write(m_encoder, key);
+        Serializer<V>::write(m_encoder, value);
+        const auto &payload = m_encoder.buffer();
+        std::uint64_t fp = fingerprint(key);
+        std::size_t length = kRecordHeader + payload.size();
+        if (length > m_regionSize) {
+            m_index.erase(fp);
+            ++m_stats.rejectedEntries;
+            return false;
+        }
+        if (m_used + length > m_regionSize) advance();
+        auto size = static_cast<std::uint32_t>(payload.size());
+        auto checksum = static_cast<std::uint32_t>(m_encoder.checksum());
+        char *out = m_buffer.get() + m_used;
+        std::memcpy(out, &size, sizeof(size));
+        std::memcpy(out + sizeof(size), &checksum, sizeof(checksum));
+        std::memcpy(out + kRecordHeader, payload.data(), payload.size());
+        Location location{m_current, static_cast<std::uint32_t>(m_used), static_cast<std::uint32_t>(length)};
+        auto [it, inserted] = m_index.try_emplace(fp, location);
+        if (!inserted) it->second = location;
+        m_regionKeys[m_current].push_back(fp);
+        m_used += length;
+        return true;
+    }
+
+    /// 读出 key 的值;不存在、校验失败或指纹碰撞时返回 std::nullopt
+    [[nodiscard]] std::optional<V> lookup(const K &key) const {
+        auto it = m_index.find(fingerprint(key));
+        if (it == m_index.end()) return std::nullopt;
+        return read(key, it->second);
+    }
+
+    /// 读出 key 的值并把它从存储中删除(提升回 DRAM 时使用)
+    std::optional<V> take(const K &key) {
+        auto it = m_index.find(fingerprint(key));
+        if (it == m_index.end()) return std::nullopt;
+        auto value = read(key, it->second);
+        if (value) m_index.erase(it);
+        return value;
+    }
+
+    /// 删除 key;磁盘上的数据随区域回收一起丢弃
+    bool erase(const K &key) {
+        return m_index.erase(fingerprint(key)) != 0;
+    }
+
+    /// 只查内存索引,不读盘
+    [[nodiscard]] bool contains(const K &key) const {
+        return m_index.find(fingerprint(key)) != m_index.end();
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept {
+        return m_index.size();
+    }
+
+    /// 文件总字节数
+    [[nodiscard]] std::uint64_t capacityBytes() const noexcept {
+        return static_cast<std::uint64_t>(m_regionSize) * m_regionCount;
+    }
+
+    [[nodiscard]] const RegionStoreStats &stats() const noexcept {
+        return m_stats;
+    }
+};
+
+#endif //CACHE_REGIONSTORE_HPP
@@ -0,0 +1,71 @@
+#ifndef CACHE_REMOVAL_HPP
+#define CACHE_REMOVAL_HPP
+
+#include "HashIndex.hpp"
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
+/// 条目被移除的原因
+/// 与 EvictionCause(见 Stats.hpp)不同,这里覆盖所有离开缓存的值,包括显式删除与被新值替换的旧值
+enum class RemovalCause : std::uint8_t {
+    Capacity,  // 为腾出容量/预算而淘汰,或新条目被拒绝(计费超过整个预算、未通过准入)
+    Explicit,  // erase
+    Expired,   // TTL 到期后被清理
+    Replaced   // put 覆盖了同一 key 的旧值
+};
+
+/// 一个被移除的条目:key 与 value 从缓存中移出,由持有者决定何时析构
+template<typename K, typename V>
+struct Removal {
+    K key;
+    V value;
+    RemovalCause cause;
+};
+
+template<typename K, typename V>
+using RemovalBatch = std::vector<Removal<K, V>>;
+
+/// 移除监听器:ConcurrentCache 在释放锁之后逐个调用,可以取走 value(如把脏数据写回后端)
+template<typename K, typename V>
+using RemovalListener = std::function<void(const K &, V &&, RemovalCause)>;
+
+/// 策略内部使用:未设置批次时(默认)被移除的条目就地析构,否则移入批次
+/// 策略必须先把条目从自己的结构中摘下(或至少不再需要其中的 key/value)再调用 push
+template<typename K, typename V>
+class RemovalSink {
+private:
+    RemovalBatch<K, V> *m_batch = nullptr;
+
+public:
+    void attach(RemovalBatch<K, V> *batch) noexcept {
+        m_batch = batch;
+    }
+
+    [[nodiscard]] RemovalBatch<K, V> *batch() const noexcept {
+        return m_batch;
+    }
+
+    explicit operator bool() const noexcept {
+        return m_batch != nullptr;
+    }
+
+    template<typename KK, typename VV>
+    void push(KK &&key, VV &&value, RemovalCause cause) {
+        m_batch->emplace_back(std::forward<KK>(key), std::forward<VV>(value), cause);
+    }
+
+    /// 删除索引 map 中 it 指向的条目,value 为该条目的值;设置了批次时 key 与 value 移入批次
+    template<typename Map>
+    void erase(Map &map, typename Map::iterator it, V &value, RemovalCause cause) {
+        if (!m_batch) {
+            map.erase(it);
+            return;
+        }
+        V moved = std::move(value);
+        m_batch->emplace_back(takeKey(map, it), std::move(moved), cause);
+    }
+};
+
+#endif //CACHE_REMOVAL_HPP
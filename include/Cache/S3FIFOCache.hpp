@@ -0,0 +1,237 @@
+#ifndef CACHE_S3FIFOCACHE_HPP
+#define CACHE_S3FIFOCACHE_HPP
+
+#include "Cache.hpp"
+#include "GhostList.hpp"
+#include "HashIndex.hpp"
+#include "Removal.hpp"
+#include "Stats.hpp"
+#include "Utility.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory_resource>
+#include <stdexcept>
+#include <type_traits>
+
+/// S3-FIFO 策略缓存:三个 FIFO 队列
+/// - small(约 10% 容量):新 key 先进入这里,过滤只访问一次的 key
+/// - main(约 90% 容量):small 中被再次访问过的元素,以及最近刚被淘汰过(命中 ghost)的 key
+/// - ghost:从 small 淘汰的 key 哈希,数量不超过 main 的容量
+/// 每个元素带 2 位访问频率(0..3),命中只做一次 relaxed 原子写,从不调整顺序;
+/// main 淘汰时频率 > 0 的元素频率减一后重新插入队头
+/// get 可以在读锁下并发调用
+/// 容量 > 0;Index 为 key 索引容器选择器(见 HashIndex.hpp)
+/// Stats 为统计器(见 Stats.hpp),默认 NoStats 不做任何统计
+/// 调用 collectRemovals 后,被淘汰、删除、替换或拒绝的条目移入批次而不是就地析构(见 Removal.hpp)
+/// get/erase/contains 另有异构重载(见 KeyTraits.hpp)
+/// 所有节点容器从构造时给出的 std::pmr::memory_resource 分配(默认为全局分配器,见 NodePool.hpp)
+template<typename K, typename V, typename Index = StdHashIndex, typename Stats = NoStats>
+class S3FIFOCache : public CacheBase<S3FIFOCache<K, V, Index, Stats>, K, V> {
+private:
+    static_assert(
+            std::is_default_constructible_v<std::hash<K>>,
+            "Key type K must be hashable: provide specialization of std::hash<K> if needed"
+    );
+    static constexpr std::uint8_t kMaxFreq = 3;
+
+    struct Entry {
+        K key;
+        V value;
+        std::atomic<std::uint8_t> freq{0};
+        bool inMain = false;
+
+        template<typename KK, typename VV>
+        Entry(KK &&k, VV &&v, bool main) : key(std::forward<KK>(k)), value(std::forward<VV>(v)), inMain(main) {}
+    };
+    using List = std::pmr::list<Entry>;  // front 为队头(最新),back 为队尾(最老)
+
+    std::size_t m_capacity;
+    std::size_t m_smallCapacity;
+    std::size_t m_mainCapacity;
+    List m_small;
+    List m_main;
+    GhostList m_ghost;
+    typename Index::template map<K, typename List::iterator> m_map;
+    [[no_unique_address]] mutable Stats m_stats;
+    RemovalSink<K, V> m_removals;
+
+    static std::uint64_t hashOf(const K &key) {
+        return mixHash(static_cast<std::uint64_t>(std::hash<K>{}(key)));
+    }
+
+    static void recordAccess(Entry &entry) {
+        auto freq = entry.freq.load(std::memory_order_relaxed);
+        if (freq < kMaxFreq) entry.freq.store(static_cast<std::uint8_t>(freq + 1), std::memory_order_relaxed);
+    }
+
+    void remove(List &list, typename List::iterator it) {
+        m_map.erase(it->key);
+        if (m_removals) m_removals.push(std::move(it->key), std::move(it->value), RemovalCause::Capacity);
+        list.erase(it);
+        m_stats.recordEviction(EvictionCause::Size);
+    }
+
+    // main 队尾:频率 > 0 的元素降频后重新入队,直到淘汰一个
+    void evictMain() {
+        for (;;) {
+            auto tail = std::prev(m_main.end());
+            auto freq = tail->freq.load(std::memory_order_relaxed);
+            if (freq == 0) {
+                remove(m_main, tail);
+                return;
+            }
+            tail->freq.store(static_cast<std::uint8_t>(freq - 1), std::memory_order_relaxed);
+            m_main.splice(m_main.begin(), m_main, tail);
+        }
+    }
+
+    // small 队尾:被再次访问过的元素移入 main,否则淘汰并记入 ghost
+    void evictSmall() {
+        while (!m_small.empty()) {
+            auto tail = std::prev(m_small.end());
+            if (tail->freq.load(std::memory_order_relaxed) > 0) {
+                tail->freq.store(0, std::memory_order_relaxed);
+                tail->inMain = true;
+                m_main.splice(m_main.begin(), m_small, tail);
+                if (m_main.size() > m_mainCapacity) {
+                    evictMain();
+                    return;
+                }
+            } else {
+                m_ghost.pushBack(hashOf(tail->key));
+                if (m_ghost.size() > m_mainCapacity) m_ghost.popFront();
+                remove(m_small, tail);
+                return;
+            }
+        }
+        evictMain();
+    }
+
+    void evict() {
+        if (m_small.size() >= m_smallCapacity || m_main.empty()) evictSmall();
+        else evictMain();
+    }
+
+    template<typename Q>
+    const V *access(const Q &key) {
+        auto it = m_map.find(key);
+        if (it == m_map.end()) {
+            m_stats.recordMiss();
+            return nullptr;
+        }
+        m_stats.recordHit();
+        recordAccess(*it->second);
+        return &it->second->value;
+    }
+
+    template<typename KK, typename VV>
+    void insert(KK &&key, VV &&value) {
+        m_stats.recordPut();
+        auto it = m_map.find(key);
+        if (it != m_map.end()) {
+            // 更新视为一次访问
+            if (m_removals) m_removals.push(it->first, std::move(it->second->value), RemovalCause::Replaced);
+            it->second->value = std::forward<VV>(value);
+            recordAccess(*it->second);
+            return;
+        }
+        if (m_map.size() >= m_capacity) evict();
+        List &target = m_ghost.erase(hashOf(key)) ? m_main : m_small;
+        target.emplace_front(std::forward<KK>(key), std::forward<VV>(value), &target == &m_main);
+        m_map[target.front().key] = target.begin();
+    }
+
+    template<typename Q>
+    void remove(const Q &key) {
+        auto it = m_map.find(key);
+        if (it == m_map.end()) return;
+        auto lit = it->second;
+        m_map.erase(it);
+        if (m_removals) m_removals.push(std::move(lit->key), std::move(lit->value), RemovalCause::Explicit);
+        (lit->inMain ? m_main : m_small).erase(lit);
+    }
+
+public:
+    explicit S3FIFOCache(std::size_t capacity, std::pmr::memory_resource *resource = std::pmr::get_default_resource())
+            : m_capacity(capacity),
+              m_smallCapacity(std::max<std::size_t>(1, capacity / 10)),
+              m_mainCapacity(capacity - std::min(capacity, m_smallCapacity)),
+              m_small(resource),
+              m_main(resource),
+              m_ghost(resource),
+              m_map(resource) {
+        if (capacity == 0) throw std::invalid_argument("S3FIFOCache capacity must be > 0");
+    }
+
+    void put(const K &key, const V &value) {
+        insert(key, value);
+    }
+
+    void put(K &&key, V &&value) {
+        insert(std::move(key), std::move(value));
+    }
+
+    std::optional<V> get(const K &key) {
+        return optionalOf(access(key));
+    }
+
+    template<LookupKey<K> Q>
+    std::optional<V> get(const Q &key) {
+        return optionalOf(access(key));
+    }
+
+    const V *find(const K &key) {
+        return access(key);
+    }
+
+    void erase(const K &key) {
+        remove(key);
+    }
+
+    template<LookupKey<K> Q>
+    void erase(const Q &key) {
+        remove(key);
+    }
+
+    void prefetch(const K &key) const {
+        prefetchIndex(m_map, key);
+    }
+
+    [[nodiscard]] bool contains(const K &key) const {
+        return m_map.count(key) != 0;
+    }
+
+    template<LookupKey<K> Q>
+    [[nodiscard]] bool contains(const Q &key) const {
+        return m_map.count(key) != 0;
+    }
+
+    [[nodiscard]] std::size_t size() const {
+        return m_map.size();
+    }
+
+    /// 被移除条目的去处(见 Removal.hpp);nullptr(默认)表示就地析构
+    void collectRemovals(RemovalBatch<K, V> *batch) noexcept {
+        m_removals.attach(batch);
+    }
+
+    [[nodiscard]] RemovalBatch<K, V> *removalBatch() const noexcept {
+        return m_removals.batch();
+    }
+
+    /// 统计器(见 Stats.hpp)
+    [[nodiscard]] Stats &statsRecorder() const noexcept {
+        return m_stats;
+    }
+
+    /// 节点容器使用的内存资源
+    [[nodiscard]] std::pmr::memory_resource *resource() const noexcept {
+        return m_map.get_allocator().resource();
+    }
+};
+
+#endif //CACHE_S3FIFOCACHE_HPP
@@ -0,0 +1,184 @@
+#ifndef CACHE_SIEVECACHE_HPP
+#define CACHE_SIEVECACHE_HPP
+
+#include "Cache.hpp"
+#include "HashIndex.hpp"
+#include "Removal.hpp"
+#include "Stats.hpp"
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <memory_resource>
+#include <stdexcept>
+#include <type_traits>
+
+/// SIEVE 策略缓存
+/// - 新元素插入队头;命中只把 visited 位置 1,从不调整顺序
+/// - 淘汰时"指针"从上次停下的位置向队头方向扫描:visited 的元素清零后跳过,
+///   遇到第一个未访问的元素即淘汰,到达队头后回到队尾继续
+/// get 除了一次 relaxed 原子写之外不修改任何状态,可以在读锁下并发调用
+/// 容量 > 0;Index 为 key 索引容器选择器(见 HashIndex.hpp)
+/// Stats 为统计器(见 Stats.hpp),默认 NoStats 不做任何统计
+/// 调用 collectRemovals 后,被淘汰、删除、替换或拒绝的条目移入批次而不是就地析构(见 Removal.hpp)
+/// get/erase/contains 另有异构重载(见 KeyTraits.hpp)
+/// 所有节点容器从构造时给出的 std::pmr::memory_resource 分配(默认为全局分配器,见 NodePool.hpp)
+template<typename K, typename V, typename Index = StdHashIndex, typename Stats = NoStats>
+class SIEVECache : public CacheBase<SIEVECache<K, V, Index, Stats>, K, V> {
+private:
+    static_assert(
+            std::is_default_constructible_v<std::hash<K>>,
+            "Key type K must be hashable: provide specialization of std::hash<K> if needed"
+    );
+    struct Entry {
+        K key;
+        V value;
+        std::atomic<bool> visited{false};
+
+        template<typename KK, typename VV>
+        Entry(KK &&k, VV &&v) : key(std::forward<KK>(k)), value(std::forward<VV>(v)) {}
+    };
+    using List = std::pmr::list<Entry>;  // front 为队头(最新),back 为队尾(最老)
+
+    std::size_t m_capacity;
+    List m_list;
+    typename List::iterator m_hand;  // end() 表示从队尾开始
+    typename Index::template map<K, typename List::iterator> m_map;
+    [[no_unique_address]] mutable Stats m_stats;
+    RemovalSink<K, V> m_removals;
+
+    // 指针向队头方向移动一格;越过队头时回到"从队尾开始"
+    typename List::iterator towardHead(typename List::iterator it) {
+        return it == m_list.begin() ? m_list.end() : std::prev(it);
+    }
+
+    void evict() {
+        auto it = m_hand == m_list.end() ? std::prev(m_list.end()) : m_hand;
+        while (it->visited.load(std::memory_order_relaxed)) {
+            it->visited.store(false, std::memory_order_relaxed);
+            it = towardHead(it);
+            if (it == m_list.end()) it = std::prev(m_list.end());
+        }
+        m_hand = towardHead(it);
+        m_map.erase(it->key);
+        if (m_removals) m_removals.push(std::move(it->key), std::move(it->value), RemovalCause::Capacity);
+        m_list.erase(it);
+        m_stats.recordEviction(EvictionCause::Size);
+    }
+
+    template<typename Q>
+    const V *access(const Q &key) {
+        auto it = m_map.find(key);
+        if (it == m_map.end()) {
+            m_stats.recordMiss();
+            return nullptr;
+        }
+        m_stats.recordHit();
+        it->second->visited.store(true, std::memory_order_relaxed);
+        return &it->second->value;
+    }
+
+    template<typename KK, typename VV>
+    void insert(KK &&key, VV &&value) {
+        m_stats.recordPut();
+        auto it = m_map.find(key);
+        if (it != m_map.end()) {
+            // 更新视为一次访问
+            if (m_removals) m_removals.push(it->first, std::move(it->second->value), RemovalCause::Replaced);
+            it->second->value = std::forward<VV>(value);
+            it->second->visited.store(true, std::memory_order_relaxed);
+            return;
+        }
+        if (m_list.size() >= m_capacity) evict();
+        m_list.emplace_front(std::forward<KK>(key), std::forward<VV>(value));
+        m_map[m_list.front().key] = m_list.begin();
+    }
+
+    template<typename Q>
+    void remove(const Q &key) {
+        auto it = m_map.find(key);
+        if (it == m_map.end()) return;
+        auto lit = it->second;
+        if (lit == m_hand) m_hand = towardHead(lit);
+        m_map.erase(it);
+        if (m_removals) m_removals.push(std::move(lit->key), std::move(lit->value), RemovalCause::Explicit);
+        m_list.erase(lit);
+    }
+
+public:
+    explicit SIEVECache(std::size_t capacity, std::pmr::memory_resource *resource = std::pmr::get_default_resource())
+            : m_capacity(capacity),
+              m_list(resource),
+              m_hand(m_list.end()),
+              m_map(resource) {
+        if (capacity == 0) throw std::invalid_argument("SIEVECache capacity must be > 0");
+    }
+
+    void put(const K &key, const V &value) {
+        insert(key, value);
+    }
+
+    void put(K &&key, V &&value) {
+        insert(std::move(key), std::move(value));
+    }
+
+    std::optional<V> get(const K &key) {
+        return optionalOf(access(key));
+    }
+
+    template<LookupKey<K> Q>
+    std::optional<V> get(const Q &key) {
+        return optionalOf(access(key));
+    }
+
+    const V *find(const K &key) {
+        return access(key);
+    }
+
+    void erase(const K &key) {
+        remove(key);
+    }
+
+    template<LookupKey<K> Q>
+    void erase(const Q &key) {
+        remove(key);
+    }
+
+    void prefetch(const K &key) const {
+        prefetchIndex(m_map, key);
+    }
+
+    [[nodiscard]] bool contains(const K &key) const {
+        return m_map.count(key) != 0;
+    }
+
+    template<LookupKey<K> Q>
+    [[nodiscard]] bool contains(const Q &key) const {
+        return m_map.count(key) != 0;
+    }
+
+    [[nodiscard]] std::size_t size() const {
+        return m_map.size();
+    }
+
+    /// 被移除条目的去处(见 Removal.hpp);nullptr(默认)表示就地析构
+    void collectRemovals(RemovalBatch<K, V> *batch) noexcept {
+        m_removals.attach(batch);
+    }
+
+    [[nodiscard]] RemovalBatch<K, V> *removalBatch() const noexcept {
+        return m_removals.batch();
+    }
+
+    /// 统计器(见 Stats.hpp)
+    [[nodiscard]] Stats &statsRecorder() const noexcept {
+        return m_stats;
+    }
+
+    /// 节点容器使用的内存资源
+    [[nodiscard]] std::pmr::memory_resource *resource() const noexcept {
+        return m_map.get_allocator().resource();
+    }
+};
+
+#endif //CACHE_SIEVECACHE_HPP
@@ -0,0 +1,19 @@
+#ifndef CACHE_SIZER_HPP
+#define CACHE_SIZER_HPP
+
+#include <cstddef>
+
+/// 条目计费器:策略的 Sizer 模板参数,返回 (key, value) 占用的预算,
+/// 策略保证所有条目的计费总和不超过构造时给定的 capacity
+/// - 同一对 (key, value) 必须总是返回相同的计费:淘汰/删除时会重新计算而不是逐条保存
+/// - 计费大于 capacity 的条目会被直接拒绝
+///
+/// 默认计费器:每个条目计 1,此时 capacity 就是条目数上限
+struct UnitSizer {
+    template<typename K, typename V>
+    constexpr std::size_t operator()(const K &, const V &) const noexcept {
+        return 1;
+    }
+};
+
+#endif //CACHE_SIZER_HPP
@@ -0,0 +1,140 @@
+#ifndef CACHE_SLABFIFOCACHE_HPP
+#define CACHE_SLABFIFOCACHE_HPP
+
+#include "Cache.hpp"
+#include "SlabStorage.hpp"
+#include "Removal.hpp"
+#include "Stats.hpp"
+#include <functional>
+#include <type_traits>
+#include <utility>
+
+/// FIFO 策略缓存(定长槽位实现):语义与 FIFOCache 相同
+/// key 只保存一份,条目以 32 位下标按插入顺序链接,稳态下 put/get 不做堆分配
+/// Stats 为统计器(见 Stats.hpp),默认 NoStats 不做任何统计
+/// 调用 collectRemovals 后,被淘汰、删除、替换或拒绝的条目移入批次而不是就地析构(见 Removal.hpp)
+/// get/erase/contains 另有异构重载(见 KeyTraits.hpp)
+template<typename K, typename V, typename Stats = NoStats>
+class SlabFIFOCache : public CacheBase<SlabFIFOCache<K, V, Stats>, K, V> {
+private:
+    static_assert(
+            std::is_default_constructible_v<std::hash<K>>,
+            "Key type K must be hashable: provide specialization of std::hash<K> if needed"
+    );
+    using Storage = SlabStorage<K, V>;
+    [[no_unique_address]] mutable Stats m_stats;
+    Storage m_slab;  // front 为最老元素
+    RemovalSink<K, V> m_removals;
+
+    void removeAt(typename Storage::Index i, RemovalCause cause) {
+        if (m_removals) m_removals.push(std::move(m_slab.key(i)), std::move(m_slab.value(i)), cause);
+        m_slab.remove(i);
+    }
+
+    template<typename Q>
+    const V *lookup(const Q &key) const {
+        auto i = m_slab.find(key);
+        if (i == Storage::kNil)
+            return nullptr;
+        return &m_slab.value(i);
+    }
+
+    template<typename Q>
+    const V *access(const Q &key) {
+        const V *value = lookup(key);
+        if (value != nullptr) m_stats.recordHit();
+        else m_stats.recordMiss();
+        return value;
+    }
+
+    template<typename Q>
+    void remove(const Q &key) {
+        auto i = m_slab.find(key);
+        if (i != Storage::kNil) removeAt(i, RemovalCause::Explicit);
+    }
+
+    template<typename KK, typename VV>
+    void insert(KK &&key, VV &&value) {
+        m_stats.recordPut();
+        auto i = m_slab.find(key);
+        if (i != Storage::kNil) {
+            // 已有则更新,不调整顺序
+            if (m_removals) m_removals.push(m_slab.key(i), std::move(m_slab.value(i)), RemovalCause::Replaced);
+            m_slab.value(i) = std::forward<VV>(value);
+            return;
+        }
+        // 达到容量则淘汰最老元素
+        if (m_slab.full()) {
+            removeAt(m_slab.front(), RemovalCause::Capacity);
+            m_stats.recordEviction(EvictionCause::Size);
+        }
+        m_slab.pushBack(std::forward<KK>(key), std::forward<VV>(value));
+    }
+
+public:
+    explicit SlabFIFOCache(std::size_t capacity)
+            : m_slab(capacity) {}
+
+    void put(const K &key, const V &value) {
+        insert(key, value);
+    }
+
+    void put(K &&key, V &&value) {
+        insert(std::move(key), std::move(value));
+    }
+
+    std::optional<V> get(const K &key) {
+        return optionalOf(access(key));
+    }
+
+    template<LookupKey<K> Q>
+    std::optional<V> get(const Q &key) {
+        return optionalOf(access(key));
+    }
+
+    const V *find(const K &key) {
+        return access(key);
+    }
+
+    void erase(const K &key) {
+        remove(key);
+    }
+
+    template<LookupKey<K> Q>
+    void erase(const Q &key) {
+        remove(key);
+    }
+
+    void prefetch(const K &key) const {
+        m_slab.prefetch(key);
+    }
+
+    [[nodiscard]] bool contains(const K &key) const {
+        return m_slab.find(key) != Storage::kNil;
+    }
+
+    template<LookupKey<K> Q>
+    [[nodiscard]] bool contains(const Q &key) const {
+        return m_slab.find(key) != Storage::kNil;
+    }
+
+    [[nodiscard]] std::size_t size() const {
+        return m_slab.size();
+    }
+
+    /// 被移除条目的去处(见 Removal.hpp);nullptr(默认)表示就地析构
+    void collectRemovals(RemovalBatch<K, V> *batch) noexcept {
+        m_removals.attach(batch);
+    }
+
+    [[nodiscard]] RemovalBatch<K, V> *removalBatch() const noexcept {
+        return m_removals.batch();
+    }
+
+    /// 统计器(见 Stats.hpp)
+    [[nodiscard]] Stats &statsRecorder() const noexcept {
+        return m_stats;
+    }
+};
+
+#endif //CACHE_SLABFIFOCACHE_HPP
@@ -0,0 +1,175 @@
+#ifndef CACHE_SLABSTORAGE_HPP
+#define CACHE_SLABSTORAGE_HPP
+
+#include "KeyTraits.hpp"
+#include "Utility.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+
+/// 定长槽位存储:LRU/FIFO 等"单链顺序"策略共用的底层容器
+/// - 所有条目放在构造时一次性分配的数组中,以 32 位下标组成双向链表(front 最老,back 最新)
+/// - key 索引是同样预分配的开放寻址表(线性探测 + 后移删除),负载因子 <= 0.5
+/// - 被删除/淘汰的槽位进入空闲链表复用,稳态下 put/get 不做任何堆分配
+/// 容量上限为 2^31 - 1
+template<typename K, typename V>
+class SlabStorage {
+public:
+    using Index = std::uint32_t;
+    static constexpr Index kNil = std::numeric_limits<Index>::max();
+
+private:
+    struct Node {
+        std::optional<std::pair<K, V>> entry;
+        Index prev = kNil;
+        Index next = kNil;  // 空闲槽位复用 next 组成空闲链表
+        std::uint32_t hash = 0;
+    };
+
+    std::size_t m_capacity;
+    std::size_t m_size = 0;
+    std::unique_ptr<Node[]> m_nodes;
+    std::unique_ptr<Index[]> m_buckets;  // 开放寻址表,保存槽位下标
+    std::size_t m_mask;
+    Index m_head = kNil;  // 最老
+    Index m_tail = kNil;  // 最新
+    Index m_free = 0;     // 空闲链表头
+
+    template<typename Q>
+    static std::uint32_t hashOf(const Q &key) {
+        return static_cast<std::uint32_t>(mixHash(static_cast<std::uint64_t>(KeyHash<K>{}(key))) >> 32);
+    }
+
+    static std::size_t bucketCount(std::size_t capacity) {
+        std::size_t count = 2;
+        while (count < capacity * 2) count <<= 1;
+        return count;
+    }
+
+    void link(Index i) {
+        Node &node = m_nodes[i];
+        node.prev = m_tail;
+        node.next = kNil;
+        if (m_tail != kNil) m_nodes[m_tail].next = i;
+        else m_head = i;
+        m_tail = i;
+    }
+
+    void unlink(Index i) {
+        Node &node = m_nodes[i];
+        if (node.prev != kNil) m_nodes[node.prev].next = node.next;
+        else m_head = node.next;
+        if (node.next != kNil) m_nodes[node.next].prev = node.prev;
+        else m_tail = node.prev;
+    }
+
+    // 删除 i 所在的桶,并把后续探测链上的元素前移,保持查找无需墓碑
+    void unindex(Index i) {
+        std::size_t hole = m_nodes[i].hash & m_mask;
+        while (m_buckets[hole] != i) hole = (hole + 1) & m_mask;
+        std::size_t j = hole;
+        for (;;) {
+            j = (j + 1) & m_mask;
+            Index moved = m_buckets[j];
+            if (moved == kNil) break;
+            std::size_t home = m_nodes[moved].hash & m_mask;
+            if (((j - home) & m_mask) >= ((j - hole) & m_mask)) {
+                m_buckets[hole] = moved;
+                hole = j;
+            }
+        }
+        m_buckets[hole] = kNil;
+    }
+
+public:
+    explicit SlabStorage(std::size_t capacity)
+            : m_capacity(capacity) {
+        if (capacity == 0)
+            throw std::invalid_argument("SlabStorage capacity must be > 0");
+        if (capacity > std::numeric_limits<Index>::max() / 2)
+            throw std::invalid_argument("SlabStorage capacity must be < 2^31");
+        m_nodes = std::make_unique<Node[]>(capacity);
+        for (std::size_t i = 0; i + 1 < capacity; ++i)
+            m_nodes[i].next = static_cast<Index>(i + 1);
+        std::size_t buckets = bucketCount(capacity);
+        m_buckets = std::make_unique<Index[]>(buckets);
+        for (std::size_t i = 0; i < buckets; ++i) m_buckets[i] = kNil;
+        m_mask = buckets - 1;
+    }
+
+    /// 预取 key 的首个探测桶
+    template<typename Q>
+    void prefetch(const Q &key) const noexcept {
+        prefetchRead(&m_buckets[hashOf(key) & m_mask]);
+    }
+
+    /// 查找 key 所在槽位,不存在返回 kNil;Q 为 K 或满足 LookupKey<Q, K> 的类型
+    template<typename Q>
+    [[nodiscard]] Index find(const Q &key) const {
+        std::uint32_t h = hashOf(key);
+        for (std::size_t b = h & m_mask;; b = (b + 1) & m_mask) {
+            Index i = m_buckets[b];
+            if (i == kNil) return kNil;
+            if (m_nodes[i].hash == h && m_nodes[i].entry->first == key) return i;
+        }
+    }
+
+    /// 在链表尾部插入新条目;调用方保证 key 不存在且未满
+    /// K 或 V 的构造抛出异常时存储保持不变,槽位仍在空闲链表中
+    template<typename KK, typename VV>
+    Index pushBack(KK &&key, VV &&value) {
+        Index i = m_free;
+        Node &node = m_nodes[i];
+        std::uint32_t hash = hashOf(key);  // key 随后可能被移走
+        node.entry.emplace(std::forward<KK>(key), std::forward<VV>(value));
+        // 构造成功之后才取出槽位并建立索引
+        m_free = node.next;
+        node.hash = hash;
+        std::size_t b = node.hash & m_mask;
+        while (m_buckets[b] != kNil) b = (b + 1) & m_mask;
+        m_buckets[b] = i;
+        link(i);
+        ++m_size;
+        return i;
+    }
+
+    /// 移除槽位 i 上的条目并回收槽位
+    void remove(Index i) {
+        unindex(i);
+        unlink(i);
+        Node &node = m_nodes[i];
+        node.entry.reset();
+        node.next = m_free;
+        m_free = i;
+        --m_size;
+    }
+
+    /// 把槽位 i 移到链表尾部
+    void moveToBack(Index i) {
+        if (i == m_tail) return;
+        unlink(i);
+        link(i);
+    }
+
+    [[nodiscard]] Index front() const noexcept { return m_head; }
+
+    /// remove 只按保存的哈希解除索引,因此可以在 remove(i) 之前把 key 移走
+    [[nodiscard]] K &key(Index i) { return m_nodes[i].entry->first; }
+
+    [[nodiscard]] V &value(Index i) { return m_nodes[i].entry->second; }
+
+    [[nodiscard]] const V &value(Index i) const { return m_nodes[i].entry->second; }
+
+    [[nodiscard]] std::size_t size() const noexcept { return m_size; }
+
+    [[nodiscard]] std::size_t capacity() const noexcept { return m_capacity; }
+
+    [[nodiscard]] bool full() const noexcept { return m_size == m_capacity; }
+};
+
+#endif //CACHE_SLABSTORAGE_HPP
@@ -0,0 +1,363 @@
+#ifndef CACHE_SNAPSHOT_HPP
+#define CACHE_SNAPSHOT_HPP
+
+#include "MappedFile.hpp"
+#include "Utility.hpp"
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/// 快照所属的策略;加载时必须与目标策略一致,否则淘汰状态没有意义
+/// 目前只有 LRUCache、LFUCache、FIFOCache、WeightedCache(及其上的 ConcurrentCache)支持快照,
+/// 其余策略没有 saveSnapshot/loadSnapshot
+enum class SnapshotPolicy : std::uint32_t {
+    LRU = 1,
+    LFU = 2,
+    FIFO = 3,
+    Weighted = 4
+};
+
+/// 快照中的一个条目;meta 为策略私有的淘汰状态(LFU 为访问频率,其余为 0)
+template<typename K, typename V>
+struct SnapshotEntry {
+    K key;
+    V value;
+    std::uint64_t meta = 0;
+};
+
+/// 策略的淘汰状态:条目按淘汰顺序排列,最先被淘汰的在前
+/// 按这个顺序重新插入即可恢复 LRU/FIFO 的顺序;容量变小时先丢弃的也正是最先会被淘汰的条目
+template<typename K, typename V>
+struct SnapshotData {
+    SnapshotPolicy policy;
+    std::vector<SnapshotEntry<K, V>> entries;
+
+    /// 快照来自其他策略时抛出 std::runtime_error
+    void expect(SnapshotPolicy expected) const {
+        if (policy != expected) throw std::runtime_error("snapshot was taken from a different cache policy");
+    }
+};
+
+/// 与分块方式无关的 64 位校验和:按 8 字节字折叠,不足一个字的部分留到下一次 update
+class SnapshotChecksum {
+private:
+    std::uint64_t m_state = 0x243f6a8885a308d3ULL;
+    std::uint64_t m_pending = 0;
+    unsigned m_pendingBytes = 0;
+    std::uint64_t m_length = 0;
+
+    void fold(std::uint64_t word) noexcept {
+        m_state = mixHash(m_state ^ word) + 0x9e3779b97f4a7c15ULL;
+    }
+
+public:
+    void update(const char *data, std::size_t size) noexcept {
+        m_length += size;
+        while (size > 0 && m_pendingBytes > 0) {
+            m_pending |= static_cast<std::uint64_t>(static_cast<unsigned char>(*data++)) << (8 * m_pendingBytes);
+            --size;
+            if (++m_pendingBytes == 8) {
+                fold(m_pending);
+                m_pending = 0;
+                m_pendingBytes = 0;
+            }
+        }
+        for (; size >= 8; data += 8, size -= 8) {
+            std::uint64_t word = 0;
+            for (unsigned i = 0; i < 8; ++i)
+                word |= static_cast<std::uint64_t>(static_cast<unsigned char>(data[i])) << (8 * i);
+            fold(word);
+        }
+        for (; size > 0; --size) {
+            m_pending |= static_cast<std::uint64_t>(static_cast<unsigned char>(*data++)) << (8 * m_pendingBytes);
+            ++m_pendingBytes;
+        }
+    }
+
+    [[nodiscard]] std::uint64_t value() const noexcept {
+        return mixHash(m_state ^ m_pending ^ mixHash(m_length));
+    }
+};
+
+/// Serializer 的输出:带缓冲地写入流,同时累计校验和
+/// 不指定流时所有字节都留在缓冲区中,由 buffer() 取出(RegionStore 以此编码单条记录)
+class SnapshotWriter {
+private:
+    std::ostream *m_out = nullptr;
+    std::vector<char> m_buffer;
+    SnapshotChecksum m_checksum;
+    std::uint64_t m_bytes = 0;
+
+public:
+    SnapshotWriter() = default;
+
+    explicit SnapshotWriter(std::ostream &out) : m_out(&out) {
+        m_buffer.reserve(std::size_t{1} << 16);
+    }
+
+    void write(const void *data, std::size_t size) {
+        const char *bytes = static_cast<const char *>(data);
+        m_checksum.update(bytes, size);
+        m_bytes += size;
+        if (m_out != nullptr && m_buffer.size() + size > m_buffer.capacity()) {
+            flush();
+            if (size >= m_buffer.capacity()) {
+                m_out->write(bytes, static_cast<std::streamsize>(size));
+                return;
+            }
+        }
+        m_buffer.insert(m_buffer.end(), bytes, bytes + size);
+    }
+
+    void flush() {
+        if (m_out == nullptr) return;
+        m_out->write(m_buffer.data(), static_cast<std::streamsize>(m_buffer.size()));
+        m_buffer.clear();
+    }
+
+    /// 丢弃缓冲区并重新开始计算校验和,保留已分配的内存
+    void clear() noexcept {
+        m_buffer.clear();
+        m_checksum = {};
+        m_bytes = 0;
+    }
+
+    /// 尚未写入流的字节;不指定流时即全部输出
+    [[nodiscard]] const std::vector<char> &buffer() const noexcept {
+        return m_buffer;
+    }
+
+    [[nodiscard]] std::uint64_t bytes() const noexcept {
+        return m_bytes;
+    }
+
+    [[nodiscard]] std::uint64_t checksum() const noexcept {
+        return m_checksum.value();
+    }
+};
+
+/// 从内存映射的快照中按顺序读取;越界时抛出 std::runtime_error
+class SnapshotReader {
+private:
+    const char *m_pos;
+    const char *m_end;
+
+public:
+    SnapshotReader(const char *data, std::size_t size) noexcept : m_pos(data), m_end(data + size) {}
+
+    void read(void *data, std::size_t size) {
+        if (static_cast<std::size_t>(m_end - m_pos) < size) throw std::runtime_error("snapshot is truncated");
+        std::memcpy(data, m_pos, size);
+        m_pos += size;
+    }
+
+    [[nodiscard]] std::size_t remaining() const noexcept {
+        return static_cast<std::size_t>(m_end - m_pos);
+    }
+};
+
+/// 平凡可复制的类类型按原始字节序列化前须显式声明:特化为 std::true_type
+/// 只有不含指针、引用语义成员(std::string_view、std::span 等)的类型才能这样声明,
+/// 否则写出的是地址,重启后读回的是悬空指针
+template<typename T>
+struct SnapshotBitwise : std::false_type {};
+
+/// 可以按原始字节序列化的类型:算术类型、枚举,以及声明了 SnapshotBitwise 的平凡可复制类型;指针永远不行
+template<typename T>
+concept BitwiseSerializable = std::is_trivially_copyable_v<T> && !std::is_pointer_v<T> &&
+                              !std::is_member_pointer_v<T> && !std::is_null_pointer_v<T> &&
+                              (std::is_arithmetic_v<T> || std::is_enum_v<T> || SnapshotBitwise<T>::value);
+
+/// 序列化 traits:为 K 与 V 提供 write(SnapshotWriter&, const T&) 与 read(SnapshotReader&) -> T
+/// 内置:BitwiseSerializable 类型(按原始字节)、std::basic_string、std::vector 与 std::pair;其他类型需要特化
+/// 未特化的类型(包括指针、std::string_view 等视图)没有定义,使用时编译失败
+template<typename T>
+struct Serializer;
+
+/// T 有可用的 Serializer;容器与 std::pair 要求其元素满足它,含视图的组合类型因此同样被拒绝
+template<typename T>
+concept Serializable = requires(SnapshotWriter &out, SnapshotReader &in, const T &value) {
+    Serializer<T>::write(out, value);
+    { Serializer<T>::read(in) } -> std::same_as<T>;
+};
+
+template<BitwiseSerializable T>
+struct Serializer<T> {
+    static void write(SnapshotWriter &out, const T &value) {
+        out.write(&value, sizeof(T));
+    }
+
+    static T read(SnapshotReader &in) {
+        std::array<unsigned char, sizeof(T)> bytes;
+        in.read(bytes.data(), sizeof(T));
+        return std::bit_cast<T>(bytes);
+    }
+};
+
+template<typename CharT, typename Traits, typename Alloc>
+struct Serializer<std::basic_string<CharT, Traits, Alloc>> {
+    static void write(SnapshotWriter &out, const std::basic_string<CharT, Traits, Alloc> &value) {
+        Serializer<std::uint64_t>::write(out, value.size());
+        out.write(value.data(), value.size() * sizeof(CharT));
+    }
+
+    static std::basic_string<CharT, Traits, Alloc> read(SnapshotReader &in) {
+        auto size = Serializer<std::uint64_t>::read(in);
+        if (size > in.remaining() / sizeof(CharT)) throw std::runtime_error("snapshot is truncated");
+        std::basic_string<CharT, Traits, Alloc> value(static_cast<std::size_t>(size), CharT{});
+        in.read(value.data(), value.size() * sizeof(CharT));
+        return value;
+    }
+};
+
+template<Serializable T, typename Alloc>
+struct Serializer<std::vector<T, Alloc>> {
+    static void write(SnapshotWriter &out, const std::vector<T, Alloc> &value) {
+        Serializer<std::uint64_t>::write(out, value.size());
+        for (const auto &element: value) Serializer<T>::write(out, element);
+    }
+
+    static std::vector<T, Alloc> read(SnapshotReader &in) {
+        auto size = Serializer<std::uint64_t>::read(in);
+        if (size > in.remaining()) throw std::runtime_error("snapshot is truncated");
+        std::vector<T, Alloc> value;
+        value.reserve(static_cast<std::size_t>(size));
+        for (std::uint64_t i = 0; i < size; ++i) value.push_back(Serializer<T>::read(in));
+        return value;
+    }
+};
+
+template<Serializable A, Serializable B>
+struct Serializer<std::pair<A, B>> {
+    static void write(SnapshotWriter &out, const std::pair<A, B> &value) {
+        Serializer<A>::write(out, value.first);
+        Serializer<B>::write(out, value.second);
+    }
+
+    static std::pair<A, B> read(SnapshotReader &in) {
+        A first = Serializer<A>::read(in);
+        return {std::move(first), Serializer<B>::read(in)};
+    }
+};
+
+/// 快照文件格式(版本 1),所有整数为本机字节序:
+///   magic "CLSNAP\0\0" | version u32 | 字节序标记 u32 | policy u32 | 保留 u32
+///   | 条目数 u64 | 负载字节数 u64 | 负载校验和 u64 | 负载
+/// 负载为依次排列的 (meta u64, key, value),key 与 value 由 Serializer 编码
+/// 字节序标记不同(另一种架构写出的快照)或版本不同时拒绝加载
+namespace snapshot_detail {
+    inline constexpr char kMagic[8] = {'C', 'L', 'S', 'N', 'A', 'P', 0, 0};
+    inline constexpr std::uint32_t kVersion = 1;
+    inline constexpr std::uint32_t kByteOrder = 0x01020304;
+    inline constexpr std::size_t kHeaderSize = 48;
+
+    struct Header {
+        std::uint32_t version;
+        std::uint32_t byteOrder;
+        std::uint32_t policy;
+        std::uint64_t entries;
+        std::uint64_t payloadBytes;
+        std::uint64_t checksum;
+    };
+
+    inline void writeHeader(std::ofstream &out, const Header &header) {
+        std::uint32_t reserved = 0;
+        out.write(kMagic, sizeof(kMagic));
+        out.write(reinterpret_cast<const char *>(&header.version), sizeof(header.version));
+        out.write(reinterpret_cast<const char *>(&header.byteOrder), sizeof(header.byteOrder));
+        out.write(reinterpret_cast<const char *>(&header.policy), sizeof(header.policy));
+        out.write(reinterpret_cast<const char *>(&reserved), sizeof(reserved));
+        out.write(reinterpret_cast<const char *>(&header.entries), sizeof(header.entries));
+        out.write(reinterpret_cast<const char *>(&header.payloadBytes), sizeof(header.payloadBytes));
+        out.write(reinterpret_cast<const char *>(&header.checksum), sizeof(header.checksum));
+    }
+
+    inline Header readHeader(const MappedFile &file) {
+        if (file.size() < kHeaderSize || std::memcmp(file.data(), kMagic, sizeof(kMagic)) != 0)
+            throw std::runtime_error("not a cache snapshot");
+        Header header{};
+        SnapshotReader in(file.data() + sizeof(kMagic), kHeaderSize - sizeof(kMagic));
+        std::uint32_t reserved;
+        in.read(&header.version, sizeof(header.version));
+        in.read(&header.byteOrder, sizeof(header.byteOrder));
+        in.read(&header.policy, sizeof(header.policy));
+        in.read(&reserved, sizeof(reserved));
+        in.read(&header.entries, sizeof(header.entries));
+        in.read(&header.payloadBytes, sizeof(header.payloadBytes));
+        in.read(&header.checksum, sizeof(header.checksum));
+        if (header.version != kVersion) throw std::runtime_error("unsupported snapshot version");
+        if (header.byteOrder != kByteOrder) throw std::runtime_error("snapshot was written with another byte order");
+        if (header.payloadBytes != file.size() - kHeaderSize) throw std::runtime_error("snapshot is truncated");
+        return header;
+    }
+} // namespace snapshot_detail
+
+/// 把快照写入 path:先写到 path.tmp,完成后再改名,中途失败不会留下半个快照;I/O 失败时抛出 std::runtime_error
+template<typename K, typename V>
+void writeSnapshot(const std::string &path, const SnapshotData<K, V> &data) {
+    using namespace snapshot_detail;
+    std::string temporary = path + ".tmp";
+    try {
+        std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+        if (!out) throw std::runtime_error("cannot create snapshot " + temporary);
+        Header header{kVersion, kByteOrder, static_cast<std::uint32_t>(data.policy), data.entries.size(), 0, 0};
+        writeHeader(out, header);
+        SnapshotWriter writer(out);
+        for (const auto &entry: data.entries) {
+            Serializer<std::uint64_t>::write(writer, entry.meta);
+            Serializer<K>::write(writer, entry.key);
+            Serializer<V>::write(writer, entry.value);
+        }
+        writer.flush();
+        header.payloadBytes = writer.bytes();
+        header.checksum = writer.checksum();
+        out.seekp(0);
+        writeHeader(out, header);
+        out.close();
+        if (!out) throw std::runtime_error("cannot write snapshot " + temporary);
+        std::filesystem::rename(temporary, path);
+    } catch (...) {
+        std::error_code ignored;
+        std::filesystem::remove(temporary, ignored);
+        throw;
+    }
+}
+
+/// 通过内存映射读取快照;先校验整个负载的校验和再反序列化,损坏的文件不会被部分加载
+/// 文件不存在、格式/版本不符、校验和不匹配或数据截断时抛出 std::runtime_error
+template<typename K, typename V>
+SnapshotData<K, V> readSnapshot(const std::string &path) {
+    using namespace snapshot_detail;
+    MappedFile file(path);
+    Header header = readHeader(file);
+    const char *payload = file.data() + kHeaderSize;
+    SnapshotChecksum checksum;
+    checksum.update(payload, header.payloadBytes);
+    if (checksum.value() != header.checksum) throw std::runtime_error("snapshot checksum mismatch");
+
+    SnapshotData<K, V> data{static_cast<SnapshotPolicy>(header.policy), {}};
+    if (header.entries > header.payloadBytes) throw std::runtime_error("snapshot is truncated");
+    data.entries.reserve(static_cast<std::size_t>(header.entries));
+    SnapshotReader in(payload, header.payloadBytes);
+    for (std::uint64_t i = 0; i < header.entries; ++i) {
+        auto meta = Serializer<std::uint64_t>::read(in);
+        K key = Serializer<K>::read(in);
+        V value = Serializer<V>::read(in);
+        data.entries.push_back({std::move(key), std::move(value), meta});
+    }
+    if (in.remaining() != 0) throw std::runtime_error("snapshot has trailing data");
+    return data;
+}
+
+#endif //CACHE_SNAPSHOT_HPP
@@ -0,0 +1,302 @@
+#ifndef CACHE_STATS_HPP
+#define CACHE_STATS_HPP
+
+#include "Utility.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+
+/// 缓存统计:策略的 Stats 模板参数,默认 NoStats(所有记录都是空操作,编译后不留痕迹)
+/// 统计器需提供 kEnabled 以及下列记录接口,均为 noexcept:
+/// - recordHit() / recordMiss() / recordPut():get/find 命中与未命中、put 调用次数
+/// - recordEviction(cause):策略因容量淘汰或拒绝条目、ExpiringCache 清理到期条目时调用
+/// - recordLockWait(wait) / recordLatency(operation, latency):由 ConcurrentCache 在持锁操作上调用
+/// 启用的统计器另需提供 snapshot(),策略的 stats()(见 Cache.hpp)据此汇总
+///
+/// 条目离开缓存的原因;显式 erase 与更新不算淘汰
+enum class EvictionCause : std::uint8_t {
+    Size,      // 为腾出预算而淘汰
+    Rejected,  // 新条目被拒绝:计费超过整个预算,或未通过准入
+    Expired    // TTL 到期后被清理
+};
+
+inline constexpr std::size_t kEvictionCauses = 3;
+
+/// 带延迟直方图的操作;Other 只记录等锁时间
+enum class TimedOperation : std::uint8_t {
+    Get,
+    Put,
+    Load,  // getOrLoad/refresh 中 loader 的一次加载(含写回)
+    Other
+};
+
+inline constexpr std::size_t kTimedOperations = 3;
+
+/// 延迟直方图的桶数:桶 0 为 0ns,桶 i 覆盖 [2^(i-1), 2^i) ns,最后一个桶收纳所有 >= 2^30 ns(约 1s)的延迟
+inline constexpr std::size_t kLatencyBuckets = 32;
+
+/// 延迟直方图快照
+struct LatencySnapshot {
+    std::array<std::uint64_t, kLatencyBuckets> buckets{};
+
+    /// 桶 i 的上界
+    static constexpr std::chrono::nanoseconds bucketUpperBound(std::size_t i) noexcept {
+        return std::chrono::nanoseconds(i == 0 ? 0 : std::int64_t{1} << i);
+    }
+
+    [[nodiscard]] std::uint64_t count() const noexcept {
+        std::uint64_t total = 0;
+        for (auto n: buckets) total += n;
+        return total;
+    }
+
+    /// 分位数 q ∈ [0, 1] 所在桶的上界;误差不超过 2 倍。没有样本时返回 0
+    [[nodiscard]] std::chrono::nanoseconds percentile(double q) const noexcept {
+        std::uint64_t total = count();
+        if (total == 0) return std::chrono::nanoseconds::zero();
+        auto rank = static_cast<std::uint64_t>(q * static_cast<double>(total - 1));
+        std::uint64_t seen = 0;
+        for (std::size_t i = 0; i < kLatencyBuckets; ++i) {
+            seen += buckets[i];
+            if (seen > rank) return bucketUpperBound(i);
+        }
+        return bucketUpperBound(kLatencyBuckets - 1);
+    }
+
+    LatencySnapshot &operator+=(const LatencySnapshot &other) noexcept {
+        for (std::size_t i = 0; i < kLatencyBuckets; ++i) buckets[i] += other.buckets[i];
+        return *this;
+    }
+};
+
+/// 统计快照:计数器在读取时汇总,并发写入时只是近似值
+struct CacheStatsSnapshot {
+    std::uint64_t hits = 0;
+    std::uint64_t misses = 0;
+    std::uint64_t puts = 0;
+    std::array<std::uint64_t, kEvictionCauses> evictions{};
+    std::uint64_t lockAcquisitions = 0;
+    std::chrono::nanoseconds lockWait{0};  // 所有加锁等待时间之和
+    std::array<LatencySnapshot, kTimedOperations> latencies{};
+    std::size_t size = 0;    // 快照时的条目数
+    std::size_t charge = 0;  // 快照时的计费总和;策略没有 Sizer 时等于 size
+
+    [[nodiscard]] std::uint64_t requests() const noexcept {
+        return hits + misses;
+    }
+
+    /// 命中率;没有请求时为 0
+    [[nodiscard]] double hitRatio() const noexcept {
+        return requests() == 0 ? 0.0 : static_cast<double>(hits) / static_cast<double>(requests());
+    }
+
+    [[nodiscard]] std::uint64_t evictionCount(EvictionCause cause) const noexcept {
+        return evictions[static_cast<std::size_t>(cause)];
+    }
+
+    /// 各原因的淘汰总数
+    [[nodiscard]] std::uint64_t evictionCount() const noexcept {
+        std::uint64_t total = 0;
+        for (auto n: evictions) total += n;
+        return total;
+    }
+
+    [[nodiscard]] const LatencySnapshot &latency(TimedOperation operation) const noexcept {
+        return latencies[static_cast<std::size_t>(operation)];
+    }
+
+    /// 合并另一份快照(如 ShardedConcurrentCache 的各分片)
+    CacheStatsSnapshot &operator+=(const CacheStatsSnapshot &other) noexcept {
+        hits += other.hits;
+        misses += other.misses;
+        puts += other.puts;
+        for (std::size_t i = 0; i < kEvictionCauses; ++i) evictions[i] += other.evictions[i];
+        lockAcquisitions += other.lockAcquisitions;
+        lockWait += other.lockWait;
+        for (std::size_t i = 0; i < kTimedOperations; ++i) latencies[i] += other.latencies[i];
+        size += other.size;
+        charge += other.charge;
+        return *this;
+    }
+};
+
+/// 关闭统计(默认):所有记录都是空操作
+struct NoStats {
+    static constexpr bool kEnabled = false;
+
+    void recordHit() noexcept {}
+
+    void recordMiss() noexcept {}
+
+    void recordPut() noexcept {}
+
+    void recordEviction(EvictionCause) noexcept {}
+
+    void recordLockWait(std::chrono::nanoseconds) noexcept {}
+
+    void recordLatency(TimedOperation, std::chrono::nanoseconds) noexcept {}
+};
+
+/// 分条带的统计计数器
+/// - 每个线程固定映射到一个条带(见 threadIndex),条带各自独占缓存行,记录只是一次 relaxed fetch_add,
+///   不同线程之间没有缓存行乒乓
+/// - snapshot() 在读取时把所有条带累加起来
+/// 可以在读锁下并发记录;条带数与 StripedReadBuffer 相同
+class CacheStats {
+public:
+    static constexpr bool kEnabled = true;
+    static constexpr std::size_t kMaxStripes = 16;
+
+private:
+    using Counter = std::atomic<std::uint64_t>;
+
+    struct alignas(kCacheLineSize) Stripe {
+        Counter hits{0};
+        Counter misses{0};
+        Counter puts{0};
+        Counter lockAcquisitions{0};
+        Counter lockWaitNanos{0};
+        std::array<Counter, kEvictionCauses> evictions{};
+        std::array<std::array<Counter, kLatencyBuckets>, kTimedOperations> latencies{};
+    };
+
+    std::unique_ptr<Stripe[]> m_stripes;
+    std::size_t m_mask;
+
+    Stripe &stripe() noexcept {
+        return m_stripes[threadIndex() & m_mask];
+    }
+
+    static void bump(Counter &counter, std::uint64_t n = 1) noexcept {
+        counter.fetch_add(n, std::memory_order_relaxed);
+    }
+
+    static std::uint64_t read(const Counter &counter) noexcept {
+        return counter.load(std::memory_order_relaxed);
+    }
+
+    static std::size_t bucketOf(std::chrono::nanoseconds latency) noexcept {
+        auto ns = static_cast<std::uint64_t>(std::max<std::int64_t>(latency.count(), 0));
+        return std::min<std::size_t>(std::bit_width(ns), kLatencyBuckets - 1);
+    }
+
+public:
+    CacheStats()
+            : m_stripes(std::make_unique<Stripe[]>(stripeCount(kMaxStripes))),
+              m_mask(stripeCount(kMaxStripes) - 1) {}
+
+    void recordHit() noexcept {
+        bump(stripe().hits);
+    }
+
+    void recordMiss() noexcept {
+        bump(stripe().misses);
+    }
+
+    void recordPut() noexcept {
+        bump(stripe().puts);
+    }
+
+    void recordEviction(EvictionCause cause) noexcept {
+        bump(stripe().evictions[static_cast<std::size_t>(cause)]);
+    }
+
+    void recordLockWait(std::chrono::nanoseconds wait) noexcept {
+        Stripe &s = stripe();
+        bump(s.lockAcquisitions);
+        bump(s.lockWaitNanos, static_cast<std::uint64_t>(std::max<std::int64_t>(wait.count(), 0)));
+    }
+
+    void recordLatency(TimedOperation operation, std::chrono::nanoseconds latency) noexcept {
+        if (operation == TimedOperation::Other) return;
+        bump(stripe().latencies[static_cast<std::size_t>(operation)][bucketOf(latency)]);
+    }
+
+    /// 累加所有条带;size/charge 由调用方填写
+    [[nodiscard]] CacheStatsSnapshot snapshot() const noexcept {
+        CacheStatsSnapshot result;
+        std::uint64_t waitNanos = 0;
+        for (std::size_t i = 0; i <= m_mask; ++i) {
+            const Stripe &s = m_stripes[i];
+            result.hits += read(s.hits);
+            result.misses += read(s.misses);
+            result.puts += read(s.puts);
+            result.lockAcquisitions += read(s.lockAcquisitions);
+            waitNanos += read(s.lockWaitNanos);
+            for (std::size_t c = 0; c < kEvictionCauses; ++c) result.evictions[c] += read(s.evictions[c]);
+            for (std::size_t op = 0; op < kTimedOperations; ++op)
+                for (std::size_t b = 0; b < kLatencyBuckets; ++b)
+                    result.latencies[op].buckets[b] += read(s.latencies[op][b]);
+        }
+        result.lockWait = std::chrono::nanoseconds(static_cast<std::int64_t>(waitNanos));
+        return result;
+    }
+};
+
+/// 以启用的统计器实例化的策略:statsRecorder() 返回的统计器能生成快照
+template<typename C>
+concept StatsRecordingPolicy = requires(const C &cache) {
+    { cache.statsRecorder().snapshot() } -> std::same_as<CacheStatsSnapshot>;
+};
+
+template<typename C>
+struct StatsRecorderTraits {
+    using type = NoStats;
+};
+
+template<StatsRecordingPolicy C>
+struct StatsRecorderTraits<C> {
+    using type = std::remove_cvref_t<decltype(std::declval<const C &>().statsRecorder())>;
+};
+
+/// 策略使用的统计器类型;未启用统计时为 NoStats
+template<typename C>
+using StatsRecorderOf = typename StatsRecorderTraits<C>::type;
+
+/// 为一次持锁操作计时:构造时读时钟,lockAcquired() 记录等锁时间,析构时把总耗时记入 operation 的直方图
+template<typename Recorder>
+class OperationTimer {
+private:
+    using Clock = std::chrono::steady_clock;
+
+    Recorder &m_recorder;
+    TimedOperation m_operation;
+    Clock::time_point m_start;
+
+public:
+    OperationTimer(Recorder &recorder, TimedOperation operation) noexcept
+            : m_recorder(recorder), m_operation(operation), m_start(Clock::now()) {}
+
+    OperationTimer(const OperationTimer &) = delete;
+
+    OperationTimer &operator=(const OperationTimer &) = delete;
+
+    ~OperationTimer() {
+        m_recorder.recordLatency(m_operation, Clock::now() - m_start);
+    }
+
+    void lockAcquired() noexcept {
+        m_recorder.recordLockWait(Clock::now() - m_start);
+    }
+};
+
+/// 统计器未启用:不读时钟
+template<typename Recorder>
+requires (!Recorder::kEnabled)
+class OperationTimer<Recorder> {
+public:
+    OperationTimer() noexcept = default;
+
+    OperationTimer(Recorder &, TimedOperation) noexcept {}
+
+    void lockAcquired() noexcept {}
+};
+
+#endif //CACHE_STATS_HPP
@@ -0,0 +1,166 @@
+#ifndef CACHE_TIMERWHEEL_HPP
+#define CACHE_TIMERWHEEL_HPP
+
+#include "KeyTraits.hpp"
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory_resource>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+/// 分层时间轮:按 key 管理到期时间(纳秒),O(1) 调度/取消,推进时只处理经过的槽
+/// - 5 层,每层 64 个槽;第 l 层每槽跨度 2^(20 + 6l) 纳秒
+///   (约 1ms / 67ms / 4.3s / 4.6min / 4.9h),超过约 13 天的到期时间放入溢出槽
+/// - 推进时从低层到高层依次处理经过的槽:已到期的 key 被回调,未到期的重新放入更精细的层
+/// - 到期回调的精度为第 0 层的一个槽(约 1ms);需要精确判断时使用 expired()
+/// 推进的均摊代价与到期/降层的 key 数成正比,从不扫描全部定时器
+/// 定时器节点从构造时给出的 std::pmr::memory_resource 分配
+template<typename K>
+class TimerWheel {
+private:
+    static constexpr int kLevels = 5;
+    static constexpr int kBucketBits = 6;
+    static constexpr std::size_t kBuckets = std::size_t{1} << kBucketBits;
+    static constexpr int kBaseShift = 20;
+
+    struct Node {
+        std::int64_t deadline = 0;
+        Node *prev = this;
+        Node *next = this;
+        const K *key = nullptr;  // 指向 m_nodes 中的 key;哨兵为空
+    };
+
+    std::pmr::unordered_map<K, Node, KeyHash<K>, KeyEqual> m_nodes;  // 节点地址在 rehash 时保持不变
+    std::array<Node, kLevels * kBuckets + 1> m_buckets;  // 各槽的哨兵,最后一个为溢出槽
+    std::int64_t m_time;                  // 最近一次推进到的时间
+    std::vector<K> m_expired;             // 复用的到期 key 缓冲
+
+    static constexpr int shiftOf(int level) noexcept {
+        return kBaseShift + kBucketBits * level;
+    }
+
+    Node &overflow() noexcept { return m_buckets[kLevels * kBuckets]; }
+
+    static void unlink(Node &node) noexcept {
+        node.prev->next = node.next;
+        node.next->prev = node.prev;
+        node.prev = node.next = &node;
+    }
+
+    static void append(Node &sentinel, Node &node) noexcept {
+        node.prev = sentinel.prev;
+        node.next = &sentinel;
+        sentinel.prev->next = &node;
+        sentinel.prev = &node;
+    }
+
+    // 按相对 m_time 的剩余时间选择层与槽;已过期的放入当前槽,在下一次推进时处理
+    void place(Node &node) noexcept {
+        std::int64_t when = std::max(node.deadline, m_time);
+        std::uint64_t delta = static_cast<std::uint64_t>(when - m_time);
+        for (int level = 0; level < kLevels; ++level) {
+            if (delta < (std::uint64_t{1} << shiftOf(level + 1))) {
+                std::size_t bucket = static_cast<std::size_t>(when >> shiftOf(level)) & (kBuckets - 1);
+                append(m_buckets[level * kBuckets + bucket], node);
+                return;
+            }
+        }
+        append(overflow(), node);
+    }
+
+    // 摘下整个槽,逐个判断到期或重新放置
+    void process(Node &sentinel) {
+        Node *node = sentinel.next;
+        sentinel.prev = sentinel.next = &sentinel;
+        while (node != &sentinel) {
+            Node *next = node->next;
+            node->prev = node->next = node;
+            if (node->deadline <= m_time) {
+                m_expired.push_back(*node->key);
+            } else {
+                place(*node);
+            }
+            node = next;
+        }
+    }
+
+public:
+    explicit TimerWheel(std::int64_t now = 0,
+                        std::pmr::memory_resource *resource = std::pmr::get_default_resource())
+            : m_nodes(resource), m_time(now) {}
+
+    TimerWheel(const TimerWheel &) = delete;
+
+    TimerWheel &operator=(const TimerWheel &) = delete;
+
+    /// 设置(或重设)key 的到期时间
+    void schedule(const K &key, std::int64_t deadline) {
+        auto [it, inserted] = m_nodes.try_emplace(key);
+        Node &node = it->second;
+        if (inserted) node.key = &it->first;
+        else unlink(node);
+        node.deadline = deadline;
+        place(node);
+    }
+
+    /// 取消 key 的定时器,返回是否存在;Q 为 K 或满足 LookupKey<Q, K> 的类型(下同)
+    template<typename Q>
+    bool cancel(const Q &key) {
+        auto it = m_nodes.find(key);
+        if (it == m_nodes.end()) return false;
+        unlink(it->second);
+        m_nodes.erase(it);
+        return true;
+    }
+
+    /// key 的到期时间;没有定时器时返回空
+    template<typename Q>
+    [[nodiscard]] std::optional<std::int64_t> deadline(const Q &key) const {
+        auto it = m_nodes.find(key);
+        if (it == m_nodes.end()) return std::nullopt;
+        return it->second.deadline;
+    }
+
+    /// 精确判断 key 在 now 时刻是否已到期(没有定时器视为永不到期)
+    template<typename Q>
+    [[nodiscard]] bool expired(const Q &key, std::int64_t now) const {
+        auto it = m_nodes.find(key);
+        return it != m_nodes.end() && it->second.deadline <= now;
+    }
+
+    /// 推进到 now:对每个已到期的 key 调用 onExpire(key),其定时器同时被移除
+    /// 回调在时间轮状态更新完成后才执行,可以安全地重新调度或取消其他 key
+    template<typename F>
+    void advance(std::int64_t now, F &&onExpire) {
+        if (now <= m_time) return;
+        std::int64_t previous = m_time;
+        m_time = now;
+        for (int level = 0; level < kLevels; ++level) {
+            std::int64_t prevTicks = previous >> shiftOf(level);
+            std::int64_t curTicks = now >> shiftOf(level);
+            if (curTicks <= prevTicks) break;  // 更高层的刻度也不会变化
+            std::size_t steps = static_cast<std::size_t>(
+                    std::min<std::int64_t>(curTicks - prevTicks + 1, static_cast<std::int64_t>(kBuckets)));
+            for (std::size_t i = 0; i < steps; ++i) {
+                std::size_t bucket = static_cast<std::size_t>(prevTicks + static_cast<std::int64_t>(i)) & (kBuckets - 1);
+                process(m_buckets[level * kBuckets + bucket]);
+            }
+            if (level == kLevels - 1) process(overflow());
+        }
+        if (m_expired.empty()) return;
+        for (const auto &key: m_expired) m_nodes.erase(key);
+        for (const auto &key: m_expired) onExpire(key);
+        m_expired.clear();
+    }
+
+    /// 当前定时器个数
+    [[nodiscard]] std::size_t size() const noexcept {
+        return m_nodes.size();
+    }
+};
+
+#endif //CACHE_TIMERWHEEL_HPP
@@ -0,0 +1,273 @@
+#ifndef CACHE_TINYLFUCACHE_HPP
+#define CACHE_TINYLFUCACHE_HPP
+
+#include "Cache.hpp"
+#include "FrequencySketch.hpp"
+#include "HashIndex.hpp"
+#include "Removal.hpp"
+#include "Stats.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <memory_resource>
+#include <stdexcept>
+#include <type_traits>
+
+/// W-TinyLFU 策略缓存
+/// - 新元素先进入约占 1% 容量的 LRU 窗口区(window),吸收突发的新 key
+/// - 主区为 SLRU:试用段(probation,约 20%)+ 保护段(protected,约 80%);
+///   试用段中的元素再次命中后晋升到保护段,保护段溢出时其 LRU 元素降回试用段
+/// - 窗口区淘汰出的候选者要与试用段的 LRU 牺牲者比较 FrequencySketch 估计的频率,
+///   只有严格更高时才被接纳,否则候选者被丢弃;扫描类流量因此无法冲刷热点集合
+/// 容量 > 0;Index 为 key 索引容器选择器(见 HashIndex.hpp)
+/// Stats 为统计器(见 Stats.hpp),默认 NoStats 不做任何统计
+/// 调用 collectRemovals 后,被淘汰、删除、替换或拒绝的条目移入批次而不是就地析构(见 Removal.hpp)
+/// get/peek/erase/contains 另有异构重载(见 KeyTraits.hpp)
+/// 所有节点容器从构造时给出的 std::pmr::memory_resource 分配(默认为全局分配器,见 NodePool.hpp)
+template<typename K, typename V, typename Index = StdHashIndex, typename Stats = NoStats>
+class TinyLFUCache : public CacheBase<TinyLFUCache<K, V, Index, Stats>, K, V> {
+private:
+    static_assert(
+            std::is_default_constructible_v<std::hash<K>>,
+            "Key type K must be hashable: provide specialization of std::hash<K> if needed"
+    );
+    enum class Region { Window, Probation, Protected };
+    struct Entry {
+        K key;
+        V value;
+        Region region;
+    };
+    using List = std::pmr::list<Entry>;  // front 为 LRU,back 为 MRU
+
+    std::size_t m_windowCapacity;
+    std::size_t m_mainCapacity;
+    std::size_t m_protectedCapacity;
+    List m_window;
+    List m_probation;
+    List m_protected;
+    typename Index::template map<K, typename List::iterator> m_map;
+    FrequencySketch<K> m_sketch;
+    [[no_unique_address]] mutable Stats m_stats;
+    RemovalSink<K, V> m_removals;
+
+    List &listOf(Region region) {
+        switch (region) {
+            case Region::Window:
+                return m_window;
+            case Region::Probation:
+                return m_probation;
+            default:
+                return m_protected;
+        }
+    }
+
+    void evictEntry(List &list, typename List::iterator it, EvictionCause cause) {
+        m_map.erase(it->key);
+        // 未通过准入的候选者同样是为容量让路
+        if (m_removals) m_removals.push(std::move(it->key), std::move(it->value), RemovalCause::Capacity);
+        list.erase(it);
+        m_stats.recordEviction(cause);
+    }
+
+    // 命中后按所在区域调整位置
+    void onHit(typename List::iterator it) {
+        switch (it->region) {
+            case Region::Window:
+                m_window.splice(m_window.end(), m_window, it);
+                break;
+            case Region::Probation:
+                it->region = Region::Protected;
+                m_protected.splice(m_protected.end(), m_probation, it);
+                if (m_protected.size() > m_protectedCapacity) {
+                    auto demoted = m_protected.begin();
+                    demoted->region = Region::Probation;
+                    m_probation.splice(m_probation.end(), m_protected, demoted);
+                }
+                break;
+            case Region::Protected:
+                m_protected.splice(m_protected.end(), m_protected, it);
+                break;
+        }
+    }
+
+    // 窗口区溢出:候选者进入试用段,主区溢出时由频率决定淘汰候选者还是牺牲者
+    void evict() {
+        if (m_window.size() <= m_windowCapacity) return;
+        auto candidate = m_window.begin();
+        if (m_mainCapacity == 0) {
+            evictEntry(m_window, candidate, EvictionCause::Size);
+            return;
+        }
+        candidate->region = Region::Probation;
+        m_probation.splice(m_probation.end(), m_window, candidate);
+        if (m_probation.size() + m_protected.size() <= m_mainCapacity) return;
+
+        // 试用段中只有候选者自己时,牺牲者取自保护段
+        List &victimList = m_probation.begin() != candidate ? m_probation : m_protected;
+        auto victim = victimList.begin();
+        if (m_sketch.frequency(candidate->key) > m_sketch.frequency(victim->key)) {
+            evictEntry(victimList, victim, EvictionCause::Size);
+        } else {
+            evictEntry(m_probation, candidate, EvictionCause::Rejected);
+        }
+    }
+
+    template<typename Q>
+    const V *access(const Q &key) {
+        auto it = m_map.find(key);
+        if (it == m_map.end()) {
+            m_stats.recordMiss();
+            return nullptr;
+        }
+        m_stats.recordHit();
+        auto lit = it->second;
+        m_sketch.increment(lit->key);
+        onHit(lit);
+        return &lit->value;
+    }
+
+    template<typename Q>
+    const V *lookup(const Q &key) const {
+        auto it = m_map.find(key);
+        if (it == m_map.end())
+            return nullptr;
+        return &it->second->value;
+    }
+
+    template<typename Q>
+    void remove(const Q &key) {
+        auto it = m_map.find(key);
+        if (it == m_map.end()) return;
+        auto lit = it->second;
+        m_map.erase(it);
+        if (m_removals) m_removals.push(std::move(lit->key), std::move(lit->value), RemovalCause::Explicit);
+        listOf(lit->region).erase(lit);
+    }
+
+    template<typename KK, typename VV>
+    void insert(KK &&key, VV &&value) {
+        m_stats.recordPut();
+        m_sketch.increment(key);
+        auto it = m_map.find(key);
+        if (it != m_map.end()) {
+            auto lit = it->second;
+            if (m_removals) m_removals.push(lit->key, std::move(lit->value), RemovalCause::Replaced);
+            lit->value = std::forward<VV>(value);
+            onHit(lit);
+            return;
+        }
+        m_window.push_back(Entry{std::forward<KK>(key), std::forward<VV>(value), Region::Window});
+        m_map[m_window.back().key] = std::prev(m_window.end());
+        evict();
+    }
+
+public:
+    explicit TinyLFUCache(std::size_t capacity, std::pmr::memory_resource *resource = std::pmr::get_default_resource())
+            : m_windowCapacity(std::max<std::size_t>(1, capacity / 100)),
+              m_mainCapacity(capacity - std::min(capacity, m_windowCapacity)),
+              m_protectedCapacity(m_mainCapacity * 4 / 5),
+              m_window(resource),
+              m_probation(resource),
+              m_protected(resource),
+              m_map(resource),
+              m_sketch(capacity) {
+        if (capacity == 0) throw std::invalid_argument("TinyLFUCache capacity must be > 0");
+    }
+
+    void put(const K &key, const V &value) {
+        insert(key, value);
+    }
+
+    void put(K &&key, V &&value) {
+        insert(std::move(key), std::move(value));
+    }
+
+    std::optional<V> get(const K &key) {
+        return optionalOf(access(key));
+    }
+
+    template<LookupKey<K> Q>
+    std::optional<V> get(const Q &key) {
+        return optionalOf(access(key));
+    }
+
+    const V *find(const K &key) {
+        return access(key);
+    }
+
+    /// 只读查找,不记录访问;供并发装饰器在读锁下调用
+    [[nodiscard]] std::optional<V> peek(const K &key) const {
+        return optionalOf(lookup(key));
+    }
+
+    template<LookupKey<K> Q>
+    [[nodiscard]] std::optional<V> peek(const Q &key) const {
+        return optionalOf(lookup(key));
+    }
+
+    /// 与 peek 相同,但返回指向缓存内值的指针而不复制
+    [[nodiscard]] const V *peekValue(const K &key) const {
+        return lookup(key);
+    }
+
+    template<LookupKey<K> Q>
+    [[nodiscard]] const V *peekValue(const Q &key) const {
+        return lookup(key);
+    }
+
+    /// 记录一次命中:累加频率并调整所在区域;key 不存在时无操作
+    void touch(const K &key) {
+        auto it = m_map.find(key);
+        if (it == m_map.end()) return;
+        m_sketch.increment(key);
+        onHit(it->second);
+    }
+
+    void erase(const K &key) {
+        remove(key);
+    }
+
+    template<LookupKey<K> Q>
+    void erase(const Q &key) {
+        remove(key);
+    }
+
+    void prefetch(const K &key) const {
+        prefetchIndex(m_map, key);
+    }
+
+    [[nodiscard]] bool contains(const K &key) const {
+        return m_map.count(key) != 0;
+    }
+
+    template<LookupKey<K> Q>
+    [[nodiscard]] bool contains(const Q &key) const {
+        return m_map.count(key) != 0;
+    }
+
+    [[nodiscard]] std::size_t size() const {
+        return m_map.size();
+    }
+
+    /// 被移除条目的去处(见 Removal.hpp);nullptr(默认)表示就地析构
+    void collectRemovals(RemovalBatch<K, V> *batch) noexcept {
+        m_removals.attach(batch);
+    }
+
+    [[nodiscard]] RemovalBatch<K, V> *removalBatch() const noexcept {
+        return m_removals.batch();
+    }
+
+    /// 统计器(见 Stats.hpp)
+    [[nodiscard]] Stats &statsRecorder() const noexcept {
+        return m_stats;
+    }
+
+    /// 节点容器使用的内存资源
+    [[nodiscard]] std::pmr::memory_resource *resource() const noexcept {
+        return m_map.get_allocator().resource();
+    }
+};
+
+#endif //CACHE_TINYLFUCACHE_HPP
@@ -0,0 +1,127 @@
+#ifndef CACHE_TRACE_HPP
+#define CACHE_TRACE_HPP
+
+#include "MappedFile.hpp"
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <string_view>
+
+/// key 访问序列(trace)的文件格式
+enum class TraceFormat : std::uint8_t {
+    Binary,  // 连续的 64 位小端无符号整数,每个一条访问
+    Csv      // 每行一条访问,key 取自指定列
+};
+
+/// 从内存映射的 trace 文件中逐条读出 key,不把文件读进内存
+/// - Csv:列从 0 开始编号,以逗号分隔;该列为十进制整数时直接作为 key,否则取其字符串哈希;
+///   空行与该列为空的行被跳过;表头行需显式跳过(skipHeader)
+/// - Binary:文件长度不是 8 的倍数时,末尾不足 8 字节的部分被忽略
+class TraceReader {
+private:
+    MappedFile m_file;
+    TraceFormat m_format;
+    std::size_t m_column;
+    bool m_skipHeader;
+    std::size_t m_offset = 0;
+
+    static std::uint64_t loadLittleEndian(const char *p) noexcept {
+        std::uint64_t value;
+        std::memcpy(&value, p, sizeof(value));
+        if constexpr (std::endian::native == std::endian::big) {
+            std::uint64_t swapped = 0;
+            for (int i = 0; i < 8; ++i) swapped = (swapped << 8) | ((value >> (8 * i)) & 0xff);
+            value = swapped;
+        }
+        return value;
+    }
+
+    static bool isPadding(char c) noexcept {
+        return c == ' ' || c == '\t' || c == '"' || c == '\r';
+    }
+
+    static std::string_view trim(std::string_view field) noexcept {
+        while (!field.empty() && isPadding(field.front())) field.remove_prefix(1);
+        while (!field.empty() && isPadding(field.back())) field.remove_suffix(1);
+        return field;
+    }
+
+    static std::uint64_t keyOf(std::string_view field) noexcept {
+        std::uint64_t value = 0;
+        bool numeric = !field.empty() && field.size() <= 19;
+        for (char c: field) {
+            if (c < '0' || c > '9') {
+                numeric = false;
+                break;
+            }
+            value = value * 10 + static_cast<std::uint64_t>(c - '0');
+        }
+        return numeric ? value : static_cast<std::uint64_t>(std::hash<std::string_view>{}(field));
+    }
+
+    std::string_view nextLine() noexcept {
+        const char *begin = m_file.data() + m_offset;
+        std::size_t rest = m_file.size() - m_offset;
+        const void *newline = std::memchr(begin, '\n', rest);
+        std::size_t length = newline ? static_cast<const char *>(newline) - begin : rest;
+        m_offset += newline ? length + 1 : length;
+        return {begin, length};
+    }
+
+    std::string_view columnOf(std::string_view line) const noexcept {
+        for (std::size_t i = 0; i < m_column; ++i) {
+            auto comma = line.find(',');
+            if (comma == std::string_view::npos) return {};
+            line.remove_prefix(comma + 1);
+        }
+        return line.substr(0, line.find(','));
+    }
+
+public:
+    explicit TraceReader(const std::string &path, TraceFormat format = TraceFormat::Binary, std::size_t column = 0,
+                         bool skipHeader = false)
+            : m_file(path), m_format(format), m_column(column), m_skipHeader(skipHeader) {
+        rewind();
+    }
+
+    /// 按扩展名推断格式:.csv/.txt 为 Csv,其余为 Binary
+    static TraceFormat formatOf(std::string_view path) noexcept {
+        auto dot = path.rfind('.');
+        if (dot == std::string_view::npos) return TraceFormat::Binary;
+        auto ext = path.substr(dot);
+        return ext == ".csv" || ext == ".txt" ? TraceFormat::Csv : TraceFormat::Binary;
+    }
+
+    /// 读出下一个 key;trace 结束时返回 false
+    bool next(std::uint64_t &key) noexcept {
+        if (m_format == TraceFormat::Binary) {
+            if (m_file.size() - m_offset < sizeof(std::uint64_t)) return false;
+            key = loadLittleEndian(m_file.data() + m_offset);
+            m_offset += sizeof(std::uint64_t);
+            return true;
+        }
+        while (m_offset < m_file.size()) {
+            std::string_view field = trim(columnOf(nextLine()));
+            if (field.empty()) continue;
+            key = keyOf(field);
+            return true;
+        }
+        return false;
+    }
+
+    /// 回到 trace 开头
+    void rewind() noexcept {
+        m_offset = 0;
+        if (m_format == TraceFormat::Csv && m_skipHeader && m_file.size() > 0) nextLine();
+    }
+
+    /// 已读取的字节比例,用于显示进度
+    [[nodiscard]] double progress() const noexcept {
+        return m_file.size() == 0 ? 1.0 : static_cast<double>(m_offset) / static_cast<double>(m_file.size());
+    }
+};
+
+#endif //CACHE_TRACE_HPP
@@ -0,0 +1,56 @@
+#ifndef CACHE_UTILITY_HPP
+#define CACHE_UTILITY_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+
+#if defined(_MSC_VER) && !defined(__clang__) && (defined(_M_X64) || defined(_M_IX86))
+#include <xmmintrin.h>
+#endif
+
+/// 缓存行大小:用于对齐/填充,避免不同线程频繁写入的数据发生伪共享
+/// 不使用 std::hardware_destructive_interference_size:其值随编译选项变化,GCC 会对此告警
+inline constexpr std::size_t kCacheLineSize = 64;
+
+/// 对 std::hash 的结果做二次混洗
+/// 许多标准库对整数使用恒等哈希,直接取模/取低位会导致分布极不均匀
+inline constexpr std::uint64_t mixHash(std::uint64_t h) noexcept {
+    // splitmix64 finalizer
+    h ^= h >> 30;
+    h *= 0xbf58476d1ce4e5b9ULL;
+    h ^= h >> 27;
+    h *= 0x94d049bb133111ebULL;
+    h ^= h >> 31;
+    return h;
+}
+
+/// 当前线程的固定编号,按线程首次调用的先后分配;用于把线程映射到分条带的计数器/缓冲区
+inline std::size_t threadIndex() noexcept {
+    static std::atomic<std::size_t> next{0};
+    thread_local std::size_t index = next.fetch_add(1, std::memory_order_relaxed);
+    return index;
+}
+
+/// 条带数:硬件线程数向上取整到 2 的幂,且不超过 maxStripes(须为 2 的幂)
+inline std::size_t stripeCount(std::size_t maxStripes) noexcept {
+    std::size_t n = std::max(1u, std::thread::hardware_concurrency());
+    std::size_t count = 1;
+    while (count < n && count < maxStripes) count <<= 1;
+    return count;
+}
+
+/// 软件预取(只读,保留在所有缓存层级);只是提示,地址无效也不会出错
+inline void prefetchRead(const void *address) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(address, 0, 3);
+#elif defined(_M_X64) || defined(_M_IX86)
+    _mm_prefetch(static_cast<const char *>(address), _MM_HINT_T0);
+#else
+    (void) address;
+#endif
+}
+
+#endif //CACHE_UTILITY_HPP
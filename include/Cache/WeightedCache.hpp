@@ -3,23 +3,84 @@
 #define CACHE_WEIGHTEDCACHE_HPP
 
 #include "Cache.hpp"
-#include <utility>
-#include <unordered_map>
+#include "HashIndex.hpp"
+#include "Removal.hpp"
+#include "Sizer.hpp"
+#include "Snapshot.hpp"
+#include "Stats.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory_resource>
 #include <stdexcept>
+#include <string>
 #include <type_traits>
-#include <set>
+#include <utility>
+#include <vector>
+
+/// WeightedCache 的优先级策略(Priority 模板参数):决定条目的优先级与计费,淘汰优先级最低的条目
+/// - kDynamic:优先级是否随访问变化;为 true 时 get 会修改内部状态,缓存因此提供 peek/touch
+/// - charge(key, entry):条目占用的预算
+/// - priority(weight, charge, frequency, clock):条目的优先级,clock 为膨胀时钟(见 GreedyDualSizeFrequency)
+///
+/// 默认:优先级就是权重,命中不改变优先级,每个条目计 1(capacity 即条目数上限)
+struct ByWeight {
+    static constexpr bool kDynamic = false;
+
+    template<typename K, typename E>
+    constexpr std::size_t charge(const K &, const E &) const noexcept {
+        return 1;
+    }
+
+    template<typename W>
+    static W priority(const W &weight, std::size_t, std::uint64_t, double) {
+        return weight;
+    }
+};
+
+/// GreedyDual-Size-Frequency:优先级 = L + 访问次数 × 代价 / 大小,代价为权重 W(如回源耗时),大小由 Sizer 计费
+/// L 为膨胀时钟:每次淘汰把 L 提高到被淘汰条目的优先级,之后插入或被访问的条目排在长期未访问的条目之后,
+/// 老条目因此不必逐个衰减,也不需要重新建堆;每次访问只调整被访问的那一个条目
+template<typename Sizer = UnitSizer>
+struct GreedyDualSizeFrequency {
+    static constexpr bool kDynamic = true;
+
+    [[no_unique_address]] Sizer sizer;
+
+    template<typename K, typename E>
+    std::size_t charge(const K &key, const E &entry) const {
+        return sizer(key, entry);
+    }
+
+    template<typename W>
+    static double priority(const W &weight, std::size_t charge, std::uint64_t frequency, double clock) {
+        return clock + static_cast<double>(frequency) * static_cast<double>(weight) /
+                       static_cast<double>(std::max<std::size_t>(1, charge));
+    }
+};
 
 /// 加权优先策略缓存:仅支持 V = std::pair<ValueType, WeightType> 的情况
-/// 要求 WeightType 为整数类型,且全局唯一(相同权重不会并存)
-/// - 当容量满时,淘汰 weight 最小的元素;
-/// - 如果插入时发现已有元素的 weight == 新 weight,则仅替换那条目的 value。
+/// - 容量不足时淘汰优先级最低的条目;默认(ByWeight)优先级就是权重,即淘汰 weight 最小的条目
+/// - 允许相同的权重并存;优先级相同时淘汰最久未被写入(GDSF 下为最久未被访问)的条目
+/// - Priority = GreedyDualSizeFrequency<Sizer> 时按 GDSF 淘汰,capacity 为 Sizer 计费总和的上限
+/// 条目存放在索引中,优先级保存在带下标的 4 叉最小堆里:找到最小值 O(1),插入、淘汰与调整优先级 O(log n),
+/// 每个条目只有索引中的一次节点分配,堆数组按摊还增长
 ///
-/// 专门化:V = std::pair<T, W>,且 W 为整数类型
-template<typename K, typename V>
+/// 专门化:V = std::pair<T, W>,W 可以用 std::less 比较(GDSF 下还需能转换为 double)
+/// Index 为 key 索引容器选择器(见 HashIndex.hpp)
+/// Stats 为统计器(见 Stats.hpp),默认 NoStats 不做任何统计
+/// 调用 collectRemovals 后,被淘汰、删除、替换或拒绝的条目移入批次而不是就地析构(见 Removal.hpp)
+/// saveSnapshot/loadSnapshot 保存与恢复条目及其权重与访问次数(见 Snapshot.hpp)
+/// get/erase/contains 另有异构重载(见 KeyTraits.hpp)
+/// 所有节点容器从构造时给出的 std::pmr::memory_resource 分配(默认为全局分配器,见 NodePool.hpp)
+template<typename K, typename V, typename Index = StdHashIndex, typename Stats = NoStats, typename Priority = ByWeight>
 class WeightedCache;
 
-template<typename K, typename T, typename W>
-class WeightedCache<K, std::pair<T, W>> : public Cache<K, std::pair<T, W>> {
+template<typename K, typename T, typename W, typename Index, typename Stats, typename Priority>
+class WeightedCache<K, std::pair<T, W>, Index, Stats, Priority>
+        : public CacheBase<WeightedCache<K, std::pair<T, W>, Index, Stats, Priority>, K, std::pair<T, W>> {
 private:
     static_assert(
             std::is_invocable_r_v<bool, std::less<W>, const W &, const W &>,
@@ -29,87 +90,358 @@ private:
             std::is_default_constructible_v<std::hash<K>>,
             "Key type K must be hashable: provide specialization of std::hash<K> if needed"
     );
-    // 最大容量
+    using Entry = std::pair<T, W>;
+    using P = decltype(Priority::priority(std::declval<const W &>(), std::size_t{}, std::uint64_t{}, 0.0));
+    static constexpr std::size_t kArity = 4;
+
+    struct Node {
+        Entry entry;
+        std::size_t slot;         // 在堆数组中的下标
+        std::size_t charge;
+        std::uint64_t frequency;  // 访问次数(插入计 1)
+    };
+
+    using Map = typename Index::template map<K, Node>;
+    // 堆中引用条目的方式:索引节点地址稳定时直接指向它,否则保存 key 的副本并经索引查找
+    using NodeRef = std::conditional_t<Index::kStableKeys, typename Map::value_type *, K>;
+
+    struct HeapSlot {
+        P priority;
+        std::uint64_t sequence;  // 最近一次设置优先级的序号,优先级相同时较小的先淘汰
+        NodeRef ref;
+    };
+
+    // 最大容量(计费预算)
     std::size_t m_capacity;
-    // key -> (value, weight)
-    std::unordered_map<K, std::pair<T, W>> m_map;
-    // weight -> key (保证同一时刻只有一个 entry 拥有该 weight)
-    std::unordered_map<W, K> m_w2k;
-    // 有序的 weight 集合,用于 O(log n) 淘汰最小 weight
-    std::set<W> m_weights;
+    std::size_t m_totalCharge = 0;
+    [[no_unique_address]] Priority m_priority;
+    [[no_unique_address]] mutable Stats m_stats;
+    // key -> (value, weight) 及其在堆中的位置
+    Map m_map;
+    // 按 (优先级, 序号) 排列的最小堆
+    std::pmr::vector<HeapSlot> m_heap;
+    std::uint64_t m_sequence = 0;
+    double m_clock = 0;  // 膨胀时钟,仅 Priority::kDynamic 时使用
+    RemovalSink<K, Entry> m_removals;
 
-public:
-    explicit WeightedCache(std::size_t capacity)
-            : m_capacity(capacity) {
-        if (capacity == 0)
-            throw std::invalid_argument("WeightedCache capacity must be > 0");
+    static bool before(const HeapSlot &a, const HeapSlot &b) {
+        if (std::less<P>{}(a.priority, b.priority)) return true;
+        if (std::less<P>{}(b.priority, a.priority)) return false;
+        return a.sequence < b.sequence;
     }
 
-    void put(const K &key, const std::pair<T, W> &entry) override {
-        T val = entry.first;
-        W w = entry.second;
+    static NodeRef refOf(typename Map::iterator it) {
+        if constexpr (Index::kStableKeys) return &*it;
+        else return it->first;
+    }
 
-        // 1) 权重冲突:只更新那条目的 value
-        auto wit = m_w2k.find(w);
-        if (wit != m_w2k.end()) {
-            K old_key = wit->second;
-            m_map[old_key].first = val;
-            return;
+    Node &nodeOf(const HeapSlot &slot) {
+        if constexpr (Index::kStableKeys) return slot.ref->second;
+        else return m_map.find(slot.ref)->second;
+    }
+
+    const K &keyOf(const HeapSlot &slot) const {
+        if constexpr (Index::kStableKeys) return slot.ref->first;
+        else return slot.ref;
+    }
+
+    P priorityOf(const Node &node) const {
+        return Priority::priority(node.entry.second, node.charge, node.frequency, m_clock);
+    }
+
+    void place(std::size_t i, HeapSlot &&slot) {
+        m_heap[i] = std::move(slot);
+        nodeOf(m_heap[i]).slot = i;
+    }
+
+    void siftUp(std::size_t i) {
+        HeapSlot moving = std::move(m_heap[i]);
+        while (i > 0) {
+            std::size_t parent = (i - 1) / kArity;
+            if (!before(moving, m_heap[parent])) break;
+            place(i, std::move(m_heap[parent]));
+            i = parent;
         }
+        place(i, std::move(moving));
+    }
 
-        // 2) 相同 key,不同 weight:移除旧 weight,再插入新 weight
-        auto kit = m_map.find(key);
-        if (kit != m_map.end()) {
-            W old_w = kit->second.second;
-            // 删除旧 weight 的映射
-            m_weights.erase(old_w);
-            m_w2k.erase(old_w);
-            // 更新 map 中的 value 和 weight
-            kit->second = { val, w };
-            // 插入新 weight
-            m_w2k[w] = key;
-            m_weights.insert(w);
-            return;
+    void siftDown(std::size_t i) {
+        HeapSlot moving = std::move(m_heap[i]);
+        for (;;) {
+            std::size_t first = i * kArity + 1;
+            if (first >= m_heap.size()) break;
+            std::size_t best = first;
+            std::size_t last = std::min(first + kArity, m_heap.size());
+            for (std::size_t c = first + 1; c < last; ++c)
+                if (before(m_heap[c], m_heap[best])) best = c;
+            if (!before(m_heap[best], moving)) break;
+            place(i, std::move(m_heap[best]));
+            i = best;
         }
+        place(i, std::move(moving));
+    }
 
-        // 3) 全新 key+weight:容量满则淘汰最小 weight
-        if (m_map.size() >= m_capacity) {
-            W min_w = *m_weights.begin();
-            K  min_k = m_w2k[min_w];
-            m_weights.erase(m_weights.begin());
-            m_w2k.erase(min_w);
-            m_map.erase(min_k);
+    // 优先级变化后恢复堆序
+    void fix(std::size_t i) {
+        if (i > 0 && before(m_heap[i], m_heap[(i - 1) / kArity])) siftUp(i);
+        else siftDown(i);
+    }
+
+    void heapErase(std::size_t i) {
+        std::size_t last = m_heap.size() - 1;
+        if (i != last) {
+            HeapSlot moved = std::move(m_heap[last]);
+            m_heap.pop_back();
+            place(i, std::move(moved));
+            fix(i);
+        } else {
+            m_heap.pop_back();
         }
+    }
 
-        // 插入新节点
-        m_map[key]   = { val, w };
-        m_w2k[w]     = key;
-        m_weights.insert(w);
+    // 重新计算优先级并刷新序号
+    void reprioritize(Node &node) {
+        HeapSlot &slot = m_heap[node.slot];
+        slot.priority = priorityOf(node);
+        slot.sequence = m_sequence++;
+        fix(node.slot);
     }
 
-    std::optional<std::pair<T, W>> get(const K &key) override {
+    void evictOne() {
+        auto it = m_map.find(keyOf(m_heap.front()));
+        if constexpr (Priority::kDynamic) m_clock = static_cast<double>(m_heap.front().priority);
+        m_totalCharge -= it->second.charge;
+        heapErase(0);
+        m_removals.erase(m_map, it, it->second.entry, RemovalCause::Capacity);
+        m_stats.recordEviction(EvictionCause::Size);
+    }
+
+    template<typename Q>
+    const Entry *lookup(const Q &key) const {
         auto it = m_map.find(key);
         if (it == m_map.end())
-            return std::nullopt;
-        return it->second;
+            return nullptr;
+        return &it->second.entry;
+    }
+
+    template<typename Q>
+    const Entry *access(const Q &key) {
+        auto it = m_map.find(key);
+        if (it == m_map.end()) {
+            m_stats.recordMiss();
+            return nullptr;
+        }
+        m_stats.recordHit();
+        if constexpr (Priority::kDynamic) {
+            ++it->second.frequency;
+            reprioritize(it->second);
+        }
+        return &it->second.entry;
     }
 
-    void erase(const K &key) override {
+    template<typename Q>
+    void remove(const Q &key, RemovalCause cause = RemovalCause::Explicit) {
         auto it = m_map.find(key);
         if (it == m_map.end()) return;
-        W w = it->second.second;
-        m_map.erase(it);
-        m_w2k.erase(w);
-        m_weights.erase(w);
+        m_totalCharge -= it->second.charge;
+        heapErase(it->second.slot);
+        m_removals.erase(m_map, it, it->second.entry, cause);
+    }
+
+    template<typename KK, typename EE>
+    void insert(KK &&key, EE &&entry) {
+        m_stats.recordPut();
+        std::size_t charge = m_priority.charge(key, entry);
+        auto it = m_map.find(key);
+        if (charge > m_capacity) {
+            // 超出整个预算:拒绝,同时丢弃旧值
+            if (it != m_map.end()) remove(key, RemovalCause::Replaced);
+            m_stats.recordEviction(EvictionCause::Rejected);
+            if (m_removals) m_removals.push(std::forward<KK>(key), std::forward<EE>(entry), RemovalCause::Capacity);
+            return;
+        }
+
+        // 相同 key:替换值与权重,视为一次访问,再按新的优先级调整位置
+        if (it != m_map.end()) {
+            Node &node = it->second;
+            if (m_removals) m_removals.push(it->first, std::move(node.entry), RemovalCause::Replaced);
+            node.entry = std::forward<EE>(entry);
+            m_totalCharge = m_totalCharge - node.charge + charge;
+            node.charge = charge;
+            ++node.frequency;
+            reprioritize(node);
+            // 调整后仍然超出预算时,更新过的条目本身也可能被淘汰
+            while (m_totalCharge > m_capacity) evictOne();
+            return;
+        }
+
+        // 全新 key:超出预算则依次淘汰优先级最低的条目
+        while (m_totalCharge + charge > m_capacity) evictOne();
+        auto nit = m_map.try_emplace(std::forward<KK>(key), Node{std::forward<EE>(entry), m_heap.size(), charge, 1}).first;
+        try {
+            m_heap.push_back(HeapSlot{priorityOf(nit->second), m_sequence++, refOf(nit)});
+        } catch (...) {
+            m_map.erase(nit);
+            throw;
+        }
+        m_totalCharge += charge;
+        siftUp(m_heap.size() - 1);
     }
 
-    [[nodiscard]] bool contains(const K &key) const override {
+public:
+    explicit WeightedCache(std::size_t capacity,
+                           std::pmr::memory_resource *resource = std::pmr::get_default_resource())
+            : WeightedCache(capacity, Priority{}, resource) {}
+
+    WeightedCache(std::size_t capacity, Priority priority,
+                  std::pmr::memory_resource *resource = std::pmr::get_default_resource())
+            : m_capacity(capacity), m_priority(std::move(priority)), m_map(resource), m_heap(resource) {
+        if (capacity == 0)
+            throw std::invalid_argument("WeightedCache capacity must be > 0");
+    }
+
+    void put(const K &key, const Entry &entry) {
+        insert(key, entry);
+    }
+
+    void put(K &&key, Entry &&entry) {
+        insert(std::move(key), std::move(entry));
+    }
+
+    std::optional<Entry> get(const K &key) {
+        return optionalOf(access(key));
+    }
+
+    template<LookupKey<K> Q>
+    std::optional<Entry> get(const Q &key) {
+        return optionalOf(access(key));
+    }
+
+    const Entry *find(const K &key) {
+        return access(key);
+    }
+
+    /// 只读查找,不计访问次数;供并发装饰器在读锁下调用(仅当优先级随访问变化时提供)
+    [[nodiscard]] std::optional<Entry> peek(const K &key) const
+    requires Priority::kDynamic {
+        return optionalOf(lookup(key));
+    }
+
+    template<LookupKey<K> Q>
+    [[nodiscard]] std::optional<Entry> peek(const Q &key) const
+    requires Priority::kDynamic {
+        return optionalOf(lookup(key));
+    }
+
+    /// 与 peek 相同,但返回指向缓存内值的指针而不复制
+    [[nodiscard]] const Entry *peekValue(const K &key) const
+    requires Priority::kDynamic {
+        return lookup(key);
+    }
+
+    /// 记录一次访问:访问次数加一并调整优先级;key 不存在时无操作
+    void touch(const K &key)
+    requires Priority::kDynamic {
+        auto it = m_map.find(key);
+        if (it == m_map.end()) return;
+        ++it->second.frequency;
+        reprioritize(it->second);
+    }
+
+    void erase(const K &key) {
+        remove(key);
+    }
+
+    template<LookupKey<K> Q>
+    void erase(const Q &key) {
+        remove(key);
+    }
+
+    void prefetch(const K &key) const {
+        prefetchIndex(m_map, key);
+    }
+
+    [[nodiscard]] bool contains(const K &key) const {
         return m_map.count(key) != 0;
     }
 
-    [[nodiscard]] std::size_t size() const override {
+    template<LookupKey<K> Q>
+    [[nodiscard]] bool contains(const Q &key) const {
+        return m_map.count(key) != 0;
+    }
+
+    [[nodiscard]] std::size_t size() const {
         return m_map.size();
     }
+
+    /// 当前计费总和
+    [[nodiscard]] std::size_t totalCharge() const noexcept {
+        return m_totalCharge;
+    }
+
+    /// 膨胀时钟的当前值(仅对 GreedyDualSizeFrequency 有意义)
+    [[nodiscard]] double inflation() const noexcept {
+        return m_clock;
+    }
+
+    /// 按淘汰顺序复制出所有条目(优先级最低的在前),meta 为访问次数;并发装饰器在读锁下调用,序列化在锁外进行
+    [[nodiscard]] SnapshotData<K, Entry> snapshot() const {
+        std::vector<const HeapSlot *> order;
+        order.reserve(m_heap.size());
+        for (const auto &slot: m_heap) order.push_back(&slot);
+        std::sort(order.begin(), order.end(), [](const HeapSlot *a, const HeapSlot *b) { return before(*a, *b); });
+        SnapshotData<K, Entry> data{SnapshotPolicy::Weighted, {}};
+        data.entries.reserve(order.size());
+        for (const HeapSlot *slot: order) {
+            const Node &node = m_map.find(keyOf(*slot))->second;
+            data.entries.push_back({keyOf(*slot), node.entry, node.frequency});
+        }
+        return data;
+    }
+
+    /// 按快照顺序插入条目并恢复访问次数;权重随值保存。膨胀时钟不保存,恢复后从 0 开始
+    /// 快照来自其他策略时抛出 std::runtime_error
+    void restore(SnapshotData<K, Entry> &&data) {
+        data.expect(SnapshotPolicy::Weighted);
+        for (auto &entry: data.entries) {
+            insert(entry.key, std::move(entry.value));
+            if constexpr (Priority::kDynamic) {
+                auto it = m_map.find(entry.key);
+                if (it == m_map.end()) continue;
+                it->second.frequency = std::max<std::uint64_t>(1, entry.meta);
+                reprioritize(it->second);
+            }
+        }
+    }
+
+    /// 把条目与权重保存到 path(见 Snapshot.hpp);K、T 与 W 需要 Serializer
+    void saveSnapshot(const std::string &path) const {
+        writeSnapshot(path, snapshot());
+    }
+
+    /// 从 path 加载快照(见 Snapshot.hpp);文件损坏、版本不符或来自其他策略时抛出 std::runtime_error,缓存不变
+    void loadSnapshot(const std::string &path) {
+        restore(readSnapshot<K, Entry>(path));
+    }
+
+    /// 被移除条目的去处(见 Removal.hpp);nullptr(默认)表示就地析构
+    void collectRemovals(RemovalBatch<K, Entry> *batch) noexcept {
+        m_removals.attach(batch);
+    }
+
+    [[nodiscard]] RemovalBatch<K, Entry> *removalBatch() const noexcept {
+        return m_removals.batch();
+    }
+
+    /// 统计器(见 Stats.hpp)
+    [[nodiscard]] Stats &statsRecorder() const noexcept {
+        return m_stats;
+    }
+
+    /// 节点容器使用的内存资源
+    [[nodiscard]] std::pmr::memory_resource *resource() const noexcept {
+        return m_map.get_allocator().resource();
+    }
 };
 
 #endif //CACHE_WEIGHTEDCACHE_HPP
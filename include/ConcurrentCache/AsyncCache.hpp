@@ -0,0 +1,207 @@
+#ifndef CACHE_ASYNCCACHE_HPP
+#define CACHE_ASYNCCACHE_HPP
+
+#include "../Cache/ExpiringCache.hpp"
+#include "ConcurrentCache.hpp"
+#include <chrono>
+#include <concepts>
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <unordered_set>
+#include <utility>
+
+/// 执行器:把一个任务交给其他线程运行(线程池、事件循环的阻塞任务队列等)
+/// execute 可能在任务运行前返回,任务只会运行一次
+template<typename E>
+concept CacheExecutor = requires(E &executor, std::function<void()> task) {
+    executor.execute(std::move(task));
+};
+
+/// 协程接口的缓存:co_await cache.getAsync(key, loader)
+/// - co_await 先不等锁地查一次(ConcurrentCache::tryGet):命中时协程不挂起,直接在调用线程上继续
+/// - 否则查找、加锁与 loader 都在执行器上运行,调用协程所在的线程(如 reactor 线程)从不阻塞;
+///   协程在执行器线程上恢复
+/// - 未命中时以 single-flight 方式加载(见 ConcurrentCache::tryGetOrLoad),loader 的异常在 co_await 处重新抛出;
+///   同一 key 的其他等待者挂在进行中的加载上,不占用执行器线程,加载结束后各自交给执行器恢复
+/// - 条目以 ttl 写入 ExpiringCache;开启 refresh-ahead 后,命中一个已度过 refreshAhead 比例寿命的条目时
+///   立即返回当前值,同时在执行器上后台重新加载,热点 key 因此不会在过期时集中未命中
+/// - 同一 key 同时至多排队一次后台刷新:刷新窗口内的一连串命中只触发一次重新加载
+/// - 后台刷新失败时保留旧值,条目照常到期
+/// 执行器必须比本对象活得久;析构时等待所有后台刷新结束,但调用方须保证没有仍在等待的 getAsync
+template<typename K, typename V, typename Policy, CacheExecutor Executor,
+        typename Clock = std::chrono::steady_clock>
+class AsyncCache {
+public:
+    using Duration = typename Clock::duration;
+    using Cache = ConcurrentCache<K, V, ExpiringCache<K, V, Policy, Clock>>;
+
+private:
+    Executor &m_executor;
+    Cache m_cache;
+    Duration m_ttl;
+    Duration m_refreshWindow;  // 剩余寿命不超过该值时触发刷新;0 表示不刷新
+
+    std::mutex m_pendingMutex;
+    std::condition_variable m_idle;
+    std::size_t m_pending = 0;  // 尚未结束的后台刷新数
+    std::unordered_set<K, KeyHash<K>, KeyEqual> m_refreshing;  // 已排队或正在刷新的 key
+
+    [[nodiscard]] bool refreshDue(const K &key) const {
+        if (m_refreshWindow <= Duration::zero()) return false;
+        auto deadline = m_cache.expiration(key);
+        return deadline && *deadline - Clock::now() <= m_refreshWindow;
+    }
+
+    // 该 key 已有刷新排队或进行中时什么也不做
+    template<typename Loader>
+    void scheduleRefresh(const K &key, const Loader &loader) {
+        {
+            std::lock_guard lock(m_pendingMutex);
+            if (!m_refreshing.insert(key).second) return;
+            ++m_pending;
+        }
+        try {
+            m_executor.execute([this, key, loader]() mutable {
+                try {
+                    // 排队期间条目可能已被刷新或改写,不再需要重新加载
+                    if (refreshDue(key)) m_cache.refresh(key, loader);
+                } catch (...) {
+                    // 保留旧值,由到期后的下一次未命中重新加载
+                }
+                finishRefresh(key);
+            });
+        } catch (...) {
+            finishRefresh(key);
+            throw;
+        }
+    }
+
+    void finishRefresh(const K &key) {
+        std::lock_guard lock(m_pendingMutex);
+        m_refreshing.erase(key);
+        if (--m_pending == 0) m_idle.notify_all();
+    }
+
+    /// 一次命中之后:条目进入刷新窗口时安排后台刷新
+    template<typename Loader>
+    void refreshIfDue(const K &key, const Loader &loader) noexcept {
+        try {
+            if (refreshDue(key)) scheduleRefresh(key, loader);
+        } catch (...) {
+            // 执行器拒绝了任务:本次命中照常返回,不刷新
+        }
+    }
+
+    /// 在执行器上恢复协程;执行器拒绝时在当前线程恢复
+    void resumeLater(std::coroutine_handle<> handle) noexcept {
+        try {
+            m_executor.execute([handle] { handle.resume(); });
+        } catch (...) {
+            handle.resume();
+        }
+    }
+
+public:
+    /// getAsync 返回的 awaiter;在执行器上完成查找/加载后恢复协程
+    template<typename Loader>
+    class GetAwaiter {
+    private:
+        AsyncCache *m_owner;
+        K m_key;
+        Loader m_loader;
+        std::optional<V> m_result;
+        std::exception_ptr m_error;
+        std::coroutine_handle<> m_handle;
+
+        // 在执行器线程上运行:查找或加载完成后就地恢复;该 key 正由别人加载时挂上回调后立即返回
+        void resolve() {
+            try {
+                bool ready = m_owner->m_cache.tryGetOrLoad(
+                        m_key, m_loader, m_result,
+                        [this](const std::optional<V> &result, std::exception_ptr error) {
+                            // 在加载者的线程上运行,不能在这里跑协程的剩余部分
+                            if (error) m_error = std::move(error);
+                            else m_result = result;
+                            m_owner->resumeLater(m_handle);
+                        });
+                if (!ready) return;
+                if (m_result) m_owner->refreshIfDue(m_key, m_loader);
+            } catch (...) {
+                m_error = std::current_exception();
+            }
+            m_handle.resume();
+        }
+
+    public:
+        GetAwaiter(AsyncCache *owner, K key, Loader loader)
+                : m_owner(owner), m_key(std::move(key)), m_loader(std::move(loader)) {}
+
+        /// 不等锁地查一次,命中时不挂起
+        [[nodiscard]] bool await_ready() {
+            m_result = m_owner->m_cache.tryGet(m_key);
+            if (!m_result) return false;
+            m_owner->refreshIfDue(m_key, m_loader);
+            return true;
+        }
+
+        void await_suspend(std::coroutine_handle<> handle) {
+            m_handle = handle;
+            m_owner->m_executor.execute([this] { resolve(); });
+        }
+
+        std::optional<V> await_resume() {
+            if (m_error) std::rethrow_exception(m_error);
+            return std::move(m_result);
+        }
+    };
+
+    /// refreshAhead 为触发刷新的寿命比例,取值 (0, 1);0 表示不刷新。例如 0.8 表示条目写入
+    /// 0.8 * ttl 之后的命中会触发后台刷新。ttl 为 0 时条目永不过期,refresh-ahead 不生效
+    /// 其余参数转发给 Policy
+    template<typename... Args>
+    AsyncCache(Executor &executor, std::size_t capacity, Duration ttl, double refreshAhead = 0.0,
+               Args &&... args)
+            : m_executor(executor),
+              m_cache(capacity, ttl, std::forward<Args>(args)...),
+              m_ttl(ttl),
+              m_refreshWindow(Duration::zero()) {
+        if (refreshAhead < 0.0 || refreshAhead >= 1.0)
+            throw std::invalid_argument("AsyncCache refreshAhead must be in [0, 1)");
+        if (refreshAhead > 0.0 && ttl > Duration::zero())
+            m_refreshWindow = std::chrono::duration_cast<Duration>(ttl * (1.0 - refreshAhead));
+    }
+
+    AsyncCache(const AsyncCache &) = delete;
+
+    AsyncCache &operator=(const AsyncCache &) = delete;
+
+    ~AsyncCache() {
+        std::unique_lock lock(m_pendingMutex);
+        m_idle.wait(lock, [this] { return m_pending == 0; });
+    }
+
+    /// co_await 得到 key 对应的值;未命中时调用 loader(key) 加载,loader 返回 V 或 std::optional<V>
+    /// loader 会被复制到后台刷新任务中,因此必须可复制
+    template<typename Loader>
+    requires std::invocable<std::decay_t<Loader> &, const K &> && std::copy_constructible<std::decay_t<Loader>>
+    [[nodiscard]] GetAwaiter<std::decay_t<Loader>> getAsync(K key, Loader &&loader) {
+        return GetAwaiter<std::decay_t<Loader>>(this, std::move(key), std::forward<Loader>(loader));
+    }
+
+    /// 底层的同步缓存,可直接 put/erase/get
+    [[nodiscard]] Cache &cache() noexcept { return m_cache; }
+
+    [[nodiscard]] const Cache &cache() const noexcept { return m_cache; }
+
+    /// 写入时使用的 TTL
+    [[nodiscard]] Duration ttl() const noexcept { return m_ttl; }
+};
+
+#endif //CACHE_ASYNCCACHE_HPP
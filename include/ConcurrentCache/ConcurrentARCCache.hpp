@@ -0,0 +1,10 @@
+#ifndef CACHE_CONCURRENTARCCACHE_HPP
+#define CACHE_CONCURRENTARCCACHE_HPP
+
+#include "../Cache/ARCCache.hpp"
+#include "ConcurrentCache.hpp"
+
+template<typename K, typename V>
+using ConcurrentARCCache = ConcurrentCache<K, V, ARCCache<K, V>>;
+
+#endif //CACHE_CONCURRENTARCCACHE_HPP
@@ -2,59 +2,639 @@
 #define CACHE_CONCURRENTCACHE_HPP
 
 #include "../Cache/Cache.hpp"
+#include "../Cache/KeyTraits.hpp"
+#include "../Cache/LRUCache.hpp"
+#include "../Cache/Removal.hpp"
+#include "../Cache/Snapshot.hpp"
+#include "ReadBuffer.hpp"
+#include <chrono>
+#include <concepts>
+#include <exception>
+#include <functional>
+#include <future>
 #include <memory>
 #include <shared_mutex>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
 #include <stdexcept>
 #include <mutex>
+#include <unordered_map>
 
-/// 通用并发缓存装饰器:通过组合 Cache<K,V> 实现线程安全
-/// 不通过继承,而是直接包含一个 std::unique_ptr<Cache<K,V>>
+/// 命中即写的策略(LRU/LFU 的 get 会调整内部顺序)需要把"查找"和"记录访问"拆开:
+/// - peek:只读查找,可在读锁下并发执行
+/// - touch:把一次访问应用到淘汰顺序上,只在写锁下执行
+/// get 会修改内部状态的策略必须提供这两个接口,否则不能在读锁下调用 get
+template<typename C, typename K, typename V>
+concept BufferedAccessPolicy = requires(C &cache, const C &constCache, const K &key) {
+    { constCache.peek(key) } -> std::same_as<std::optional<V>>;
+    cache.touch(key);
+};
+
+/// get 会修改内部状态、又不能拆成 peek/touch 的策略声明 static constexpr bool kExclusiveGet = true,
+/// ConcurrentCache 对它的读操作(get/visit/getMany)改持写锁,例如 DRAM 层不支持 peek 的 HybridCache
+template<typename C>
+concept ExclusiveGetPolicy = requires { requires C::kExclusiveGet; };
+
+/// 通用并发缓存装饰器:通过组合具体策略实现线程安全
+/// 不通过继承,而是按值包含一个 CacheImpl,调用不经过虚函数也不经过额外的堆间接
 /// 通用并发缓存装饰器（读写分离）
 /// - 写操作（put/erase）使用 std::unique_lock
 /// - 读操作（get/contains/size）使用 std::shared_lock
-/// CacheImpl 必须是 Cache<K,V> 的具体实现
+/// - 对 BufferedAccessPolicy,命中只在读锁下 peek,并把访问事件写入有损的分条带缓冲区;
+///   缓冲区积压时尝试获取写锁批量回放,写操作前也会先回放,淘汰顺序因此近似精确
+///   注意延后的只是淘汰顺序的调整:命中仍要获取 m_mutex 的读锁,所有读者都要写同一把锁的读者计数,
+///   读多的负载在核数增加时仍会在这条缓存行上竞争;需要无锁命中时用 ShardedConcurrentCache 分散锁,
+///   或用 LockFreeReadCache(FIFO/Random)
+/// - 对 ExclusiveGetPolicy,读操作与写操作一样持写锁
+/// - get/contains/erase 另有异构重载(见 KeyTraits.hpp),要求 CacheImpl 同样支持
+/// - getOrLoad 未命中时对同一 key 只运行一次 loader,其余调用方等待同一个结果(single-flight);
+///   加载期间不持有缓存的读写锁,只在登记/注销时短暂持有独立的 in-flight 表锁;
+///   tryGetOrLoad 不阻塞等待,而是把回调挂在进行中的加载上,供协程接口(AsyncCache)使用
+/// - visit 在持锁期间以 const V& 调用 visitor,不复制值;visitor 内不得再访问同一个缓存
+/// - CacheImpl 以启用的统计器实例化时(见 Stats.hpp),另外记录读锁下的命中/未命中、加锁的等待时间
+///   (get/put/erase 等,不含 contains/size)以及 get/put/加载的延迟直方图,stats() 返回汇总;
+///   未启用时这些代码全部在编译期消失
+/// - saveSnapshot 只在读锁下复制条目,序列化与写文件都在锁外进行;loadSnapshot 在锁外读取并校验文件,
+///   只有把条目插入策略时才持写锁(见 Snapshot.hpp)
+/// - CacheImpl 支持 collectRemovals 时,写操作移除的条目在锁内只被移入局部批次,释放锁之后才析构;
+///   setRemovalListener 设置了移除监听器时,析构之前先逐个通知监听器
+/// CacheImpl 必须满足 CachePolicy(见 Cache.hpp)
 
 template<typename K, typename V, typename CacheImpl>
 class ConcurrentCache {
 private:
-    std::unique_ptr<Cache<K, V>> m_delegate;
+    static_assert(CachePolicy<CacheImpl, K, V>, "CacheImpl must satisfy CachePolicy");
+    static constexpr bool kBuffered = BufferedAccessPolicy<CacheImpl, K, V>;
+    static constexpr bool kStats = StatsRecordingPolicy<CacheImpl>;
+    static constexpr bool kExclusiveGet = ExclusiveGetPolicy<CacheImpl>;
+    static constexpr bool kRemovals = requires(CacheImpl &cache, RemovalBatch<K, V> *batch) {
+        cache.collectRemovals(batch);
+    };
+    using Recorder = StatsRecorderOf<CacheImpl>;
+
+    struct NoReadBuffer {};
+
+    using LoadClock = std::chrono::steady_clock;
+    using LoadWaiter = std::function<void(const std::optional<V> &, std::exception_ptr)>;
+
+    // 一次进行中的加载:同步调用方等待 future,tryGetOrLoad 的调用方把回调挂在 waiters 上
+    struct InFlight {
+        std::shared_future<std::optional<V>> future;
+        std::vector<LoadWaiter> waiters;
+    };
+
+    CacheImpl m_delegate;  // 按值保存,所有调用在编译期解析
     mutable std::shared_mutex m_mutex;
+    [[no_unique_address]] std::conditional_t<kBuffered, StripedReadBuffer<K>, NoReadBuffer> m_readBuffer;
+    std::shared_ptr<const RemovalListener<K, V>> m_removalListener;  // 只在写锁下读写
+
+    // 以下状态只在 m_loadMutex 下访问,与 m_mutex 互不嵌套
+    std::mutex m_loadMutex;
+    std::unordered_map<K, InFlight, KeyHash<K>, KeyEqual> m_inFlight;
+    std::unique_ptr<LRUCache<K, LoadClock::time_point>> m_negative;  // key -> 不存在结论的失效时刻
+    LoadClock::duration m_negativeTtl{};
+
+    OperationTimer<Recorder> startTimer(TimedOperation operation) const {
+        if constexpr (kStats) return OperationTimer<Recorder>(m_delegate.statsRecorder(), operation);
+        else return {};
+    }
+
+    /// 加锁并把等锁时间记入 timer
+    template<template<typename> class Lock>
+    Lock<std::shared_mutex> acquire(OperationTimer<Recorder> &timer) const {
+        Lock<std::shared_mutex> lock(m_mutex);
+        timer.lockAcquired();
+        return lock;
+    }
+
+    /// 读锁下 peek 的结果不经过策略的 get,由这里计入命中/未命中
+    void recordLookup(bool hit) {
+        if constexpr (kStats) {
+            if (hit) m_delegate.statsRecorder().recordHit();
+            else m_delegate.statsRecorder().recordMiss();
+        }
+    }
+
+    /// 回放积压的访问事件,调用方必须持有写锁
+    void drainReadBuffer() {
+        if constexpr (kBuffered) {
+            m_readBuffer.drain([this](const K &key) { m_delegate.touch(key); });
+        }
+    }
+
+    /// 读路径上的回放:拿不到写锁就放弃,由后续的读或写再触发
+    void tryDrainReadBuffer() {
+        std::unique_lock lock(m_mutex, std::try_to_lock);
+        if (lock.owns_lock()) drainReadBuffer();
+    }
+
+    /// 在写锁下执行 op(之前先回放读缓冲区)
+    /// op 移除的条目收集到局部批次,释放锁之后再交给监听器(若已设置),最后在锁外析构
+    template<typename F>
+    void write(TimedOperation operation, F &&op) {
+        if constexpr (kRemovals) {
+            RemovalBatch<K, V> removed;  // 在锁释放之后才析构
+            std::shared_ptr<const RemovalListener<K, V>> listener;
+            {
+                auto timer = startTimer(operation);
+                auto lock = acquire<std::unique_lock>(timer);
+                drainReadBuffer();
+                listener = m_removalListener;
+                struct Detach {
+                    CacheImpl &cache;
+
+                    ~Detach() { cache.collectRemovals(nullptr); }
+                } detach{m_delegate};
+                m_delegate.collectRemovals(&removed);
+                std::forward<F>(op)();
+            }
+            if (listener) {
+                for (auto &removal: removed) (*listener)(removal.key, std::move(removal.value), removal.cause);
+            }
+        } else {
+            auto timer = startTimer(operation);
+            auto lock = acquire<std::unique_lock>(timer);
+            drainReadBuffer();
+            std::forward<F>(op)();
+        }
+    }
+
+    template<typename Q>
+    std::optional<V> lookup(const Q &key) {
+        if constexpr (kBuffered) {
+            bool shouldDrain = false;
+            std::optional<V> result;
+            {
+                auto timer = startTimer(TimedOperation::Get);
+                auto lock = acquire<std::shared_lock>(timer);
+                result = m_delegate.peek(key);
+                recordLookup(result.has_value());
+                if (result) shouldDrain = m_readBuffer.record(key);
+            }
+            if (shouldDrain) tryDrainReadBuffer();
+            return result;
+        } else if constexpr (kExclusiveGet) {
+            std::optional<V> result;
+            write(TimedOperation::Get, [&] { result = m_delegate.get(key); });
+            return result;
+        } else {
+            auto timer = startTimer(TimedOperation::Get);
+            auto lock = acquire<std::shared_lock>(timer);
+            return m_delegate.get(key);
+        }
+    }
+
+    /// 登记为加载者之后的复查:启用统计时不把同一次请求再计一次未命中
+    std::optional<V> recheck(const K &key) {
+        if constexpr (!kStats || kExclusiveGet) {
+            return lookup(key);
+        } else {
+            std::shared_lock lock(m_mutex);
+            if constexpr (requires(const CacheImpl &cache) { cache.peek(key); }) {
+                return m_delegate.peek(key);
+            } else {
+                if (!m_delegate.contains(key)) return std::nullopt;
+                return m_delegate.get(key);
+            }
+        }
+    }
+
+    /// loader 最近报告过 key 不存在且结论尚未失效;调用方必须持有 m_loadMutex
+    bool knownAbsent(const K &key) {
+        if (!m_negative) return false;
+        auto deadline = m_negative->get(key);
+        if (!deadline) return false;
+        if (LoadClock::now() < *deadline) return true;
+        m_negative->erase(key);
+        return false;
+    }
+
+    void rememberAbsent(const K &key) {
+        std::lock_guard lock(m_loadMutex);
+        if (m_negative) m_negative->put(key, LoadClock::now() + m_negativeTtl);
+    }
+
+    /// 注销 key 的加载,返回挂在上面的回调
+    std::vector<LoadWaiter> finishLoad(const K &key) {
+        std::lock_guard lock(m_loadMutex);
+        auto it = m_inFlight.find(key);
+        std::vector<LoadWaiter> waiters = std::move(it->second.waiters);
+        m_inFlight.erase(it);
+        return waiters;
+    }
+
+    /// 作为 key 的加载者运行 loader、写回缓存并发布结果;调用方已在 m_inFlight 中登记了 promise
+    /// refreshing 为 true 时不复用缓存中的旧值,且 loader 报告不存在时删除旧条目
+    template<typename Loader>
+    std::optional<V> runLoad(const K &key, std::promise<std::optional<V>> &promise, Loader &loader, bool refreshing) {
+        std::optional<V> result;
+        try {
+            // 上一次加载可能在我们未命中之后、登记之前刚刚完成
+            if (!refreshing) result = recheck(key);
+            if (!result) {
+                [[maybe_unused]] auto timer = startTimer(TimedOperation::Load);
+                result = std::invoke(loader, key);
+                if (result) {
+                    put(key, *result);
+                } else {
+                    if (refreshing) erase(key);
+                    rememberAbsent(key);
+                }
+            }
+        } catch (...) {
+            // 先注销再发布结果:之后到达的调用方会重新加载,而不是拿到过期的异常
+            auto waiters = finishLoad(key);
+            auto error = std::current_exception();
+            promise.set_exception(error);
+            for (auto &waiter: waiters) waiter(std::nullopt, error);
+            throw;
+        }
+        auto waiters = finishLoad(key);
+        promise.set_value(result);
+        for (auto &waiter: waiters) waiter(result, nullptr);
+        return result;
+    }
+
+    template<typename Q>
+    void prefetch(const Q &key) const {
+        if constexpr (requires { m_delegate.prefetch(key); }) m_delegate.prefetch(key);
+    }
+
+    /// 批量操作的公共实现:at(i)(i < count)返回第 i 个元素的引用,元素本身不被复制
+    template<typename At>
+    std::vector<std::optional<V>> getBatch(std::size_t count, At at) {
+        std::vector<std::optional<V>> result;
+        result.reserve(count);
+        if constexpr (kBuffered) {
+            bool shouldDrain = false;
+            {
+                auto timer = startTimer(TimedOperation::Get);
+                auto lock = acquire<std::shared_lock>(timer);
+                for (std::size_t i = 0; i < count; ++i) prefetch(at(i));
+                for (std::size_t i = 0; i < count; ++i) {
+                    result.push_back(m_delegate.peek(at(i)));
+                    recordLookup(result.back().has_value());
+                    if (result.back()) shouldDrain |= m_readBuffer.record(at(i));
+                }
+            }
+            if (shouldDrain) tryDrainReadBuffer();
+        } else {
+            auto run = [&] {
+                for (std::size_t i = 0; i < count; ++i) prefetch(at(i));
+                for (std::size_t i = 0; i < count; ++i) result.push_back(m_delegate.get(at(i)));
+            };
+            if constexpr (kExclusiveGet) {
+                write(TimedOperation::Get, run);
+            } else {
+                auto timer = startTimer(TimedOperation::Get);
+                auto lock = acquire<std::shared_lock>(timer);
+                run();
+            }
+        }
+        return result;
+    }
+
+    template<typename At>
+    void putBatch(std::size_t count, At at) {
+        write(TimedOperation::Put, [&] {
+            for (std::size_t i = 0; i < count; ++i) prefetch(at(i).first);
+            for (std::size_t i = 0; i < count; ++i) m_delegate.put(at(i).first, at(i).second);
+        });
+    }
+
+    template<typename At>
+    void eraseBatch(std::size_t count, At at) {
+        write(TimedOperation::Other, [&] {
+            for (std::size_t i = 0; i < count; ++i) prefetch(at(i));
+            for (std::size_t i = 0; i < count; ++i) m_delegate.erase(at(i));
+        });
+    }
+
+    template<typename Q>
+    void remove(const Q &key) {
+        write(TimedOperation::Other, [&] { m_delegate.erase(key); });
+    }
 
 public:
-    /// 构造时将参数转发给 CacheImpl
+    /// 构造时将参数转发给 CacheImpl;例如 ConcurrentLRUCache<K, V> cache(1024, &pool) 让节点从 pool 分配
+    /// 分配只发生在写锁内,因此独占的 memory_resource 不需要自带同步(见 NodePool.hpp)
     template<typename... Args>
     explicit ConcurrentCache(Args&&... args)
-            : m_delegate(std::make_unique<CacheImpl>(std::forward<Args>(args)...))
+            : m_delegate(std::forward<Args>(args)...)
     {}
 
     /// 插入或更新
     void put(const K& key, const V& value) {
-        std::unique_lock lock(m_mutex);
-        m_delegate->put(key, value);
+        write(TimedOperation::Put, [&] { m_delegate.put(key, value); });
+    }
+
+    /// 插入或更新,key 与 value 被移入缓存
+    void put(K&& key, V&& value) {
+        write(TimedOperation::Put, [&] { m_delegate.put(std::move(key), std::move(value)); });
+    }
+
+    /// 以指定 TTL 插入或更新(仅适用于 ExpiringCache 等支持 TTL 的实现)
+    template<typename Duration>
+    void put(const K& key, const V& value, Duration ttl)
+    requires requires(CacheImpl &cache) { cache.put(key, value, ttl); } {
+        write(TimedOperation::Put, [&] { m_delegate.put(key, value, ttl); });
     }
 
-    /// 获取，抛出 out_of_range
+    template<typename Duration>
+    void put(K&& key, V&& value, Duration ttl)
+    requires requires(CacheImpl &cache) { cache.put(std::move(key), std::move(value), ttl); } {
+        write(TimedOperation::Put, [&] { m_delegate.put(std::move(key), std::move(value), ttl); });
+    }
+
+    /// 以 args 构造值后插入或替换;值在锁外构造,锁内只做移动
+    template<typename... Args>
+    void emplace(K key, Args&&... args) {
+        put(std::move(key), V(std::forward<Args>(args)...));
+    }
+
+    /// 仅当 key 不存在时构造值并插入,返回是否插入;判断与插入在同一次写锁内完成
+    template<typename... Args>
+    bool try_emplace(K key, Args&&... args) {
+        bool inserted = false;
+        write(TimedOperation::Put, [&] {
+            if (m_delegate.contains(key)) return;
+            m_delegate.put(std::move(key), V(std::forward<Args>(args)...));
+            inserted = true;
+        });
+        return inserted;
+    }
+
+    /// 在锁内以 const V& 调用 visitor,不复制值;返回是否命中
+    /// 对 BufferedAccessPolicy 只持读锁并记录访问,否则与 get 持同样的锁
+    template<typename F>
+    bool visit(const K& key, F&& visitor) {
+        if constexpr (kBuffered && requires(const CacheImpl &cache) { cache.peekValue(key); }) {
+            bool shouldDrain = false;
+            {
+                auto timer = startTimer(TimedOperation::Get);
+                auto lock = acquire<std::shared_lock>(timer);
+                const V *value = m_delegate.peekValue(key);
+                recordLookup(value != nullptr);
+                if (value == nullptr) return false;
+                std::forward<F>(visitor)(*value);
+                shouldDrain = m_readBuffer.record(key);
+            }
+            if (shouldDrain) tryDrainReadBuffer();
+            return true;
+        } else if constexpr (kBuffered || kExclusiveGet) {
+            auto timer = startTimer(TimedOperation::Get);
+            auto lock = acquire<std::unique_lock>(timer);
+            drainReadBuffer();
+            return m_delegate.visit(key, std::forward<F>(visitor));
+        } else {
+            auto timer = startTimer(TimedOperation::Get);
+            auto lock = acquire<std::shared_lock>(timer);
+            return m_delegate.visit(key, std::forward<F>(visitor));
+        }
+    }
+
+    /// 获取
     std::optional<V> get(const K& key) {
-        std::shared_lock lock(m_mutex);
-        return m_delegate->get(key);
+        return lookup(key);
+    }
+
+    /// 异构获取,不构造 K
+    template<LookupKey<K> Q>
+    std::optional<V> get(const Q& key) {
+        return lookup(key);
+    }
+
+    /// 不等锁的获取:读锁被占用、未命中或策略的读操作需要写锁(ExclusiveGetPolicy)时返回空
+    /// 只有命中计入统计,调用方随后用 get/getOrLoad 兜底时未命中不会被重复计数
+    std::optional<V> tryGet(const K& key) {
+        if constexpr (kExclusiveGet) {
+            return std::nullopt;
+        } else {
+            bool shouldDrain = false;
+            std::optional<V> result;
+            {
+                std::shared_lock lock(m_mutex, std::try_to_lock);
+                if (!lock.owns_lock()) return std::nullopt;
+                if constexpr (kBuffered) {
+                    result = m_delegate.peek(key);
+                    if (result) {
+                        recordLookup(true);
+                        shouldDrain = m_readBuffer.record(key);
+                    }
+                } else {
+                    if (m_delegate.contains(key)) result = m_delegate.get(key);
+                }
+            }
+            if (shouldDrain) tryDrainReadBuffer();
+            return result;
+        }
+    }
+
+    /// 获取;未命中时调用 loader(key) 加载并写入缓存
+    /// - 同一 key 同时只有一个调用方运行 loader,其余调用方等待并共享它的结果
+    /// - loader 返回 V,或返回 std::optional<V>(空表示后端也不存在,不写入缓存)
+    /// - loader 抛出的异常传递给所有等待该次加载的调用方,且不被缓存,下一次调用会重新加载
+    /// - 开启 setNegativeCaching 后,"不存在"的结论在 TTL 内直接返回空,不再调用 loader
+    /// loader 在不持有任何锁的情况下运行,可以访问本缓存
+    template<typename Loader>
+    requires std::invocable<Loader &, const K &>
+    std::optional<V> getOrLoad(const K& key, Loader&& loader) {
+        if (auto hit = lookup(key)) return hit;
+        std::promise<std::optional<V>> promise;
+        {
+            std::unique_lock lock(m_loadMutex);
+            if (knownAbsent(key)) return std::nullopt;
+            auto it = m_inFlight.find(key);
+            if (it != m_inFlight.end()) {
+                auto result = it->second.future;
+                lock.unlock();
+                return result.get();
+            }
+            m_inFlight.emplace(key, InFlight{promise.get_future().share(), {}});
+        }
+        return runLoad(key, promise, loader, false);
+    }
+
+    /// 与 getOrLoad 相同,但从不阻塞等待其他调用方的加载
+    /// - 命中、负缓存命中或由本次调用完成加载时,结果写入 result 并返回 true;loader 的异常照常抛出
+    /// - 该 key 正在由其他调用方加载时,把 onLoaded 挂在那次加载上并立即返回 false;
+    ///   加载结束时由加载者的线程调用 onLoaded(结果, 异常) 恰好一次
+    /// onLoaded 不得抛出异常,且应尽快返回(例如把后续工作交给执行器),它运行时加载者还不能返回
+    template<typename Loader, typename OnLoaded>
+    requires std::invocable<Loader &, const K &> &&
+             std::invocable<OnLoaded &, const std::optional<V> &, std::exception_ptr>
+    bool tryGetOrLoad(const K& key, Loader&& loader, std::optional<V> &result, OnLoaded&& onLoaded) {
+        result = lookup(key);
+        if (result) return true;
+        std::promise<std::optional<V>> promise;
+        {
+            std::lock_guard lock(m_loadMutex);
+            if (knownAbsent(key)) return true;
+            auto it = m_inFlight.find(key);
+            if (it != m_inFlight.end()) {
+                it->second.waiters.emplace_back(std::forward<OnLoaded>(onLoaded));
+                return false;
+            }
+            m_inFlight.emplace(key, InFlight{promise.get_future().share(), {}});
+        }
+        result = runLoad(key, promise, loader, false);
+        return true;
+    }
+
+    /// 无论是否命中都调用 loader(key) 重新加载并写回;loader 报告不存在时删除旧条目
+    /// 与 getOrLoad 共用 in-flight 表:该 key 已有加载在进行时不重复加载,直接返回 false
+    /// loader 的异常在写回之前抛出给调用方,旧值保持不变
+    template<typename Loader>
+    requires std::invocable<Loader &, const K &>
+    bool refresh(const K& key, Loader&& loader) {
+        std::promise<std::optional<V>> promise;
+        {
+            std::lock_guard lock(m_loadMutex);
+            if (m_inFlight.contains(key)) return false;
+            m_inFlight.emplace(key, InFlight{promise.get_future().share(), {}});
+        }
+        runLoad(key, promise, loader, true);
+        return true;
+    }
+
+    /// 开启/关闭 getOrLoad 的负缓存:loader 报告 key 不存在后,该结论保留 ttl
+    /// 最多记住 capacity 个 key(LRU 淘汰);ttl <= 0 关闭并清空负缓存
+    /// 负缓存只影响 getOrLoad;之后对该 key 的 put 会先于负缓存被命中
+    template<typename Rep, typename Period>
+    void setNegativeCaching(std::chrono::duration<Rep, Period> ttl, std::size_t capacity = 1024) {
+        std::lock_guard lock(m_loadMutex);
+        if (ttl <= ttl.zero() || capacity == 0) {
+            m_negative.reset();
+            return;
+        }
+        m_negativeTtl = std::chrono::duration_cast<LoadClock::duration>(ttl);
+        m_negative = std::make_unique<LRUCache<K, LoadClock::time_point>>(capacity);
+    }
+
+    /// 设置移除监听器(见 Removal.hpp),传入空函数则取消;仅当 CacheImpl 支持 collectRemovals 时可用
+    /// - 被淘汰、删除、替换或到期的条目在写锁内只被移入该次写操作的局部批次,
+    ///   释放锁之后才逐个调用 listener(key, value, cause),随后析构;昂贵的析构或写回因此不会延长持锁时间
+    /// - listener 在调用写操作的线程上运行(因此可能被并发调用),不持有任何锁,可以访问本缓存;它抛出的异常在写操作完成后传给调用方,
+    ///   同一批次中剩余的条目不再通知
+    /// - 未设置监听器时条目仍在锁内就地析构,没有额外开销
+    void setRemovalListener(RemovalListener<K, V> listener)
+    requires kRemovals {
+        std::shared_ptr<const RemovalListener<K, V>> shared;
+        if (listener) shared = std::make_shared<const RemovalListener<K, V>>(std::move(listener));
+        std::unique_lock lock(m_mutex);
+        m_removalListener.swap(shared);
+    }
+
+    /// 把条目与淘汰状态保存到 path(仅当 CacheImpl 支持快照时可用,见 Snapshot.hpp)
+    /// 先尝试回放积压的访问,再在读锁下按淘汰顺序复制条目;序列化与写文件期间不持有任何锁,读写照常进行
+    /// 代价是复制期间内存中多一份条目,写线程在复制期间等待
+    void saveSnapshot(const std::string &path)
+    requires requires(const CacheImpl &cache) { cache.snapshot(); } {
+        tryDrainReadBuffer();
+        decltype(m_delegate.snapshot()) data;
+        {
+            std::shared_lock lock(m_mutex);
+            data = m_delegate.snapshot();
+        }
+        writeSnapshot(path, data);
+    }
+
+    /// 从 path 加载快照(仅当 CacheImpl 支持快照时可用,见 Snapshot.hpp)
+    /// 映射、校验和反序列化都在锁外完成,只在把条目插入策略时持写锁;挤出的条目照常通知移除监听器
+    /// 文件损坏、版本不符或来自其他策略时抛出 std::runtime_error,缓存不变
+    void loadSnapshot(const std::string &path)
+    requires requires(CacheImpl &cache, SnapshotData<K, V> &&data) { cache.restore(std::move(data)); } {
+        auto data = readSnapshot<K, V>(path);
+        write(TimedOperation::Other, [&] { m_delegate.restore(std::move(data)); });
+    }
+
+    /// 批量获取:一次加读锁,先为所有 key 发出预取,再逐个查找;整批在延迟直方图中计为一次 get
+    std::vector<std::optional<V>> getMany(std::span<const K> keys) {
+        return getBatch(keys.size(), [keys](std::size_t i) -> const K & { return keys[i]; });
+    }
+
+    /// 只取 keys 中 positions 所指的条目,结果与 positions 一一对应;不复制 key(ShardedConcurrentCache 按分片分派时使用)
+    std::vector<std::optional<V>> getMany(std::span<const K> keys, std::span<const std::size_t> positions) {
+        return getBatch(positions.size(), [keys, positions](std::size_t i) -> const K & { return keys[positions[i]]; });
+    }
+
+    /// 批量插入或更新:一次加写锁
+    void putMany(std::span<const std::pair<K, V>> entries) {
+        putBatch(entries.size(), [entries](std::size_t i) -> const std::pair<K, V> & { return entries[i]; });
+    }
+
+    /// 只写入 entries 中 positions 所指的条目,按 positions 的顺序生效;不复制条目
+    void putMany(std::span<const std::pair<K, V>> entries, std::span<const std::size_t> positions) {
+        putBatch(positions.size(), [entries, positions](std::size_t i) -> const std::pair<K, V> & {
+            return entries[positions[i]];
+        });
+    }
+
+    /// 批量删除:一次加写锁
+    void eraseMany(std::span<const K> keys) {
+        eraseBatch(keys.size(), [keys](std::size_t i) -> const K & { return keys[i]; });
+    }
+
+    /// 只删除 keys 中 positions 所指的条目
+    void eraseMany(std::span<const K> keys, std::span<const std::size_t> positions) {
+        eraseBatch(positions.size(), [keys, positions](std::size_t i) -> const K & { return keys[positions[i]]; });
     }
 
     /// 删除条目
     void erase(const K& key) {
-        std::unique_lock lock(m_mutex);
-        m_delegate->erase(key);
+        remove(key);
+    }
+
+    template<LookupKey<K> Q>
+    void erase(const Q& key) {
+        remove(key);
     }
 
     /// 是否包含
     bool contains(const K& key) const {
         std::shared_lock lock(m_mutex);
-        return m_delegate->contains(key);
+        return m_delegate.contains(key);
+    }
+
+    template<LookupKey<K> Q>
+    bool contains(const Q& key) const {
+        std::shared_lock lock(m_mutex);
+        return m_delegate.contains(key);
     }
 
     /// 当前大小
     std::size_t size() const noexcept {
         std::shared_lock lock(m_mutex);
-        return m_delegate->size();
+        return m_delegate.size();
+    }
+
+    /// 当前计费总和(仅适用于带 Sizer 的策略)
+    std::size_t totalCharge() const
+    requires requires(const CacheImpl &cache) { cache.totalCharge(); } {
+        std::shared_lock lock(m_mutex);
+        return m_delegate.totalCharge();
+    }
+
+    /// 统计快照(仅当 CacheImpl 启用统计时可用);计数器无锁汇总,条目数与计费总和在读锁下读取
+    CacheStatsSnapshot stats() const
+    requires kStats {
+        std::shared_lock lock(m_mutex);
+        return m_delegate.stats();
+    }
+
+    /// 条目的到期时刻(仅适用于支持 TTL 的实现)
+    auto expiration(const K& key) const
+    requires requires(const CacheImpl &cache) { cache.expiration(key); } {
+        std::shared_lock lock(m_mutex);
+        return m_delegate.expiration(key);
+    }
+
+    /// 批量删除已到期的条目(仅适用于支持 TTL 的实现)
+    void cleanUp()
+    requires requires(CacheImpl &cache) { cache.cleanUp(); } {
+        write(TimedOperation::Other, [&] { m_delegate.cleanUp(); });
     }
 };
 
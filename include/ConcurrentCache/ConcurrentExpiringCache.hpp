@@ -0,0 +1,10 @@
+#ifndef CACHE_CONCURRENTEXPIRINGCACHE_HPP
+#define CACHE_CONCURRENTEXPIRINGCACHE_HPP
+
+#include "../Cache/ExpiringCache.hpp"
+#include "ConcurrentCache.hpp"
+
+template<typename K, typename V, typename CacheImpl>
+using ConcurrentExpiringCache = ConcurrentCache<K, V, ExpiringCache<K, V, CacheImpl>>;
+
+#endif //CACHE_CONCURRENTEXPIRINGCACHE_HPP
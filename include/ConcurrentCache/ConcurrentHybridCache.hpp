@@ -0,0 +1,10 @@
+#ifndef CACHE_CONCURRENTHYBRIDCACHE_HPP
+#define CACHE_CONCURRENTHYBRIDCACHE_HPP
+
+#include "../Cache/HybridCache.hpp"
+#include "ConcurrentCache.hpp"
+
+template<typename K, typename V, typename Memory = LRUCache<K, V>>
+using ConcurrentHybridCache = ConcurrentCache<K, V, HybridCache<K, V, Memory>>;
+
+#endif //CACHE_CONCURRENTHYBRIDCACHE_HPP
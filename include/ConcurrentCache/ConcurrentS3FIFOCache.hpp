@@ -0,0 +1,10 @@
+#ifndef CACHE_CONCURRENTS3FIFOCACHE_HPP
+#define CACHE_CONCURRENTS3FIFOCACHE_HPP
+
+#include "../Cache/S3FIFOCache.hpp"
+#include "ConcurrentCache.hpp"
+
+template<typename K, typename V>
+using ConcurrentS3FIFOCache = ConcurrentCache<K, V, S3FIFOCache<K, V>>;
+
+#endif //CACHE_CONCURRENTS3FIFOCACHE_HPP
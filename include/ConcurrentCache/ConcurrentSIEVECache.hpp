@@ -0,0 +1,10 @@
+#ifndef CACHE_CONCURRENTSIEVECACHE_HPP
+#define CACHE_CONCURRENTSIEVECACHE_HPP
+
+#include "../Cache/SIEVECache.hpp"
+#include "ConcurrentCache.hpp"
+
+template<typename K, typename V>
+using ConcurrentSIEVECache = ConcurrentCache<K, V, SIEVECache<K, V>>;
+
+#endif //CACHE_CONCURRENTSIEVECACHE_HPP
@@ -0,0 +1,10 @@
+#ifndef CACHE_CONCURRENTSLABFIFOCACHE_HPP
+#define CACHE_CONCURRENTSLABFIFOCACHE_HPP
+
+#include "../Cache/SlabFIFOCache.hpp"
+#include "ConcurrentCache.hpp"
+
+template<typename K, typename V>
+using ConcurrentSlabFIFOCache = ConcurrentCache<K, V, SlabFIFOCache<K, V>>;
+
+#endif //CACHE_CONCURRENTSLABFIFOCACHE_HPP
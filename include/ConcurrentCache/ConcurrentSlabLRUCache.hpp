@@ -0,0 +1,10 @@
+#ifndef CACHE_CONCURRENTSLABLRUCACHE_HPP
+#define CACHE_CONCURRENTSLABLRUCACHE_HPP
+
+#include "../Cache/SlabLRUCache.hpp"
+#include "ConcurrentCache.hpp"
+
+template<typename K, typename V>
+using ConcurrentSlabLRUCache = ConcurrentCache<K, V, SlabLRUCache<K, V>>;
+
+#endif //CACHE_CONCURRENTSLABLRUCACHE_HPP
@@ -0,0 +1,10 @@
+#ifndef CACHE_CONCURRENTTINYLFUCACHE_HPP
+#define CACHE_CONCURRENTTINYLFUCACHE_HPP
+
+#include "../Cache/TinyLFUCache.hpp"
+#include "ConcurrentCache.hpp"
+
+template<typename K, typename V>
+using ConcurrentTinyLFUCache = ConcurrentCache<K, V, TinyLFUCache<K, V>>;
+
+#endif //CACHE_CONCURRENTTINYLFUCACHE_HPP
@@ -0,0 +1,197 @@
+#ifndef CACHE_EPOCH_HPP
+#define CACHE_EPOCH_HPP
+
+#include "../Cache/Utility.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/// 基于 epoch 的内存回收(EBR):无锁读路径上被写者摘下的对象延迟到没有读者可能持有它时才释放
+/// - 全局 epoch 单调递增;读者进入临界区时把当前 epoch 写入自己独占缓存行的槽位,离开时清除,
+///   读者之间不写任何共享的缓存行,槽位只由推进 epoch 的写者读取
+/// - 所有处于临界区的读者都已看到当前 epoch 时,epoch 才能前进一格;对象在 epoch e 被摘下并退休后,
+///   epoch 到达 e + 2 时不可能再有读者持有它
+/// - 进程内只有一个域(EpochDomain::instance()),线程第一次进入时认领一个槽位,线程退出时归还供复用;
+///   槽位从不释放,数量等于同时存在过的线程数的峰值
+/// - 临界区可以嵌套;读者在临界区内停留过久只会推迟回收(内存暂时增长),不会出错
+class EpochDomain {
+private:
+    struct alignas(kCacheLineSize) Slot {
+        std::atomic<std::uint64_t> epoch{0};  // 0 表示不在临界区,否则为 (epoch << 1) | 1
+        std::atomic<bool> claimed{false};
+        Slot *next = nullptr;                  // 槽位链表只在头部追加,节点不再改动
+    };
+
+    // 线程退出时归还槽位
+    struct Local {
+        Slot *slot = nullptr;
+        std::size_t depth = 0;
+
+        ~Local() {
+            if (slot != nullptr) slot->claimed.store(false, std::memory_order_release);
+        }
+    };
+
+    std::atomic<std::uint64_t> m_epoch{1};
+    std::atomic<Slot *> m_slots{nullptr};
+
+    EpochDomain() = default;
+
+    static Local &local() noexcept {
+        thread_local Local state;
+        return state;
+    }
+
+    Slot *claim() {
+        for (Slot *slot = m_slots.load(std::memory_order_acquire); slot != nullptr; slot = slot->next) {
+            bool expected = false;
+            if (!slot->claimed.load(std::memory_order_relaxed) &&
+                slot->claimed.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+                return slot;
+            }
+        }
+        auto *slot = new Slot;
+        slot->claimed.store(true, std::memory_order_relaxed);
+        Slot *head = m_slots.load(std::memory_order_relaxed);
+        do {
+            slot->next = head;
+        } while (!m_slots.compare_exchange_weak(head, slot, std::memory_order_release, std::memory_order_relaxed));
+        return slot;
+    }
+
+    void enter() {
+        Local &state = local();
+        if (state.depth++ != 0) return;
+        if (state.slot == nullptr) state.slot = claim();
+        state.slot->epoch.store((m_epoch.load(std::memory_order_relaxed) << 1) | 1, std::memory_order_relaxed);
+        // 槽位的写入必须先于临界区内的任何读取对推进者可见
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+    }
+
+    void leave() noexcept {
+        Local &state = local();
+        if (--state.depth == 0) state.slot->epoch.store(0, std::memory_order_release);
+    }
+
+public:
+    /// 临界区:构造时进入,析构时离开;期间读到的对象不会被释放
+    class Guard {
+    private:
+        EpochDomain &m_domain;
+
+    public:
+        explicit Guard(EpochDomain &domain) : m_domain(domain) {
+            m_domain.enter();
+        }
+
+        Guard(const Guard &) = delete;
+
+        Guard &operator=(const Guard &) = delete;
+
+        ~Guard() {
+            m_domain.leave();
+        }
+    };
+
+    EpochDomain(const EpochDomain &) = delete;
+
+    EpochDomain &operator=(const EpochDomain &) = delete;
+
+    /// 进程内唯一的域;故意不析构,线程退出时归还槽位总是安全的
+    static EpochDomain &instance() {
+        static auto *domain = new EpochDomain;
+        return *domain;
+    }
+
+    [[nodiscard]] Guard pin() {
+        return Guard(*this);
+    }
+
+    [[nodiscard]] std::uint64_t epoch() const noexcept {
+        return m_epoch.load(std::memory_order_seq_cst);
+    }
+
+    /// 所有处于临界区的读者都已看到当前 epoch 时把它加一;返回调用结束时的 epoch
+    std::uint64_t tryAdvance() noexcept {
+        std::uint64_t current = m_epoch.load(std::memory_order_seq_cst);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        for (Slot *slot = m_slots.load(std::memory_order_acquire); slot != nullptr; slot = slot->next) {
+            std::uint64_t pinned = slot->epoch.load(std::memory_order_seq_cst);
+            if ((pinned & 1) != 0 && (pinned >> 1) != current) return current;
+        }
+        // 失败说明别的写者已经推进,current 被更新为新值
+        if (m_epoch.compare_exchange_strong(current, current + 1, std::memory_order_seq_cst)) return current + 1;
+        return current;
+    }
+};
+
+/// 一个写者的退休对象列表:对象摘下后交给 retire,epoch 前进两格后由 Deleter 释放
+/// 不是线程安全的,调用方(通常持有写锁)负责串行化;析构时释放全部对象,调用方须保证此时已没有读者
+/// 调用 retire 的线程不能处于临界区:列表无法分配内存时会原地等待所有读者离开再释放
+template<typename T, typename Deleter>
+class RetireList {
+private:
+    struct Retired {
+        T *object;
+        std::uint64_t epoch;
+    };
+
+    static constexpr std::size_t kCollectEvery = 64;  // 每退休这么多个对象尝试回收一次
+
+    EpochDomain &m_domain = EpochDomain::instance();
+    std::pmr::vector<Retired> m_retired;  // 按退休顺序排列,epoch 单调不减
+    [[no_unique_address]] Deleter m_deleter;
+    std::size_t m_sinceCollect = 0;
+
+public:
+    explicit RetireList(Deleter deleter = Deleter{},
+                        std::pmr::memory_resource *resource = std::pmr::get_default_resource())
+            : m_retired(resource), m_deleter(std::move(deleter)) {}
+
+    RetireList(const RetireList &) = delete;
+
+    RetireList &operator=(const RetireList &) = delete;
+
+    ~RetireList() {
+        for (const Retired &retired: m_retired) m_deleter(retired.object);
+    }
+
+    /// object 必须已经从所有读者可达的位置摘下
+    void retire(T *object) {
+        // 摘下对象的通常只是一次 release 写,随后读取 epoch 是对另一个变量的读,两者可能被重排
+        // (store buffer):读到旧的 e 时摘除尚未可见,钉住 e + 1 的读者仍可能拿到对象,
+        // epoch 到 e + 2 时对象就会在它手中被释放。全序栅栏保证读到的 epoch 不早于摘除生效的时刻,
+        // 与 enter 中的栅栏配对:钉住的 epoch 晚于这里读到的值的读者一定看得到摘除
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        std::uint64_t epoch = m_domain.epoch();
+        try {
+            m_retired.push_back({object, epoch});
+        } catch (...) {
+            // 无法记录:等到 epoch 前进两格(所有可能持有它的读者都已离开)后直接释放
+            while (m_domain.tryAdvance() < epoch + 2) std::this_thread::yield();
+            m_deleter(object);
+            return;
+        }
+        if (++m_sinceCollect >= kCollectEvery) collect();
+    }
+
+    /// 尝试推进 epoch,并释放已经安全的对象
+    void collect() {
+        m_sinceCollect = 0;
+        std::uint64_t epoch = m_domain.tryAdvance();
+        std::size_t freed = 0;
+        while (freed < m_retired.size() && m_retired[freed].epoch + 2 <= epoch) m_deleter(m_retired[freed++].object);
+        m_retired.erase(m_retired.begin(), m_retired.begin() + static_cast<std::ptrdiff_t>(freed));
+    }
+
+    /// 已退休、尚未释放的对象数
+    [[nodiscard]] std::size_t size() const noexcept {
+        return m_retired.size();
+    }
+};
+
+#endif //CACHE_EPOCH_HPP
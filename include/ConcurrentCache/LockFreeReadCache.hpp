@@ -0,0 +1,366 @@
+#ifndef CACHE_LOCKFREEREADCACHE_HPP
+#define CACHE_LOCKFREEREADCACHE_HPP
+
+#include "../Cache/KeyTraits.hpp"
+#include "../Cache/Utility.hpp"
+#include "Epoch.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <optional>
+#include <random>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+/// LockFreeReadCache 的淘汰选择器,作为 Replacement 模板参数传入
+/// 选择器需提供成员类模板 hook<Node>(嵌在每个节点中)与 policy<Node>(以容量与内存资源构造),policy 提供:
+/// - inserted(node):新节点;可以抛出异常,此时节点不会被插入
+/// - replaced(old, fresh):fresh 取代 old(替换值),继承它的位置
+/// - removed(node):节点被淘汰或删除
+/// - victim() -> Node *:下一个淘汰对象;至少有一个节点
+/// 各函数只在写锁下调用,读者从不访问 hook
+
+/// FIFO:按插入顺序淘汰,替换值不调整顺序;hook 为侵入式双向链表
+struct FIFOReplacement {
+    template<typename Node>
+    struct hook {
+        Node *older = nullptr;
+        Node *newer = nullptr;
+    };
+
+    template<typename Node>
+    class policy {
+    private:
+        Node *m_oldest = nullptr;
+        Node *m_newest = nullptr;
+
+    public:
+        policy(std::size_t, std::pmr::memory_resource *) noexcept {}
+
+        void inserted(Node *node) noexcept {
+            node->hook.older = m_newest;
+            node->hook.newer = nullptr;
+            if (m_newest != nullptr) m_newest->hook.newer = node;
+            else m_oldest = node;
+            m_newest = node;
+        }
+
+        void replaced(Node *old, Node *fresh) noexcept {
+            fresh->hook = old->hook;
+            if (fresh->hook.older != nullptr) fresh->hook.older->hook.newer = fresh;
+            else m_oldest = fresh;
+            if (fresh->hook.newer != nullptr) fresh->hook.newer->hook.older = fresh;
+            else m_newest = fresh;
+        }
+
+        void removed(Node *node) noexcept {
+            if (node->hook.older != nullptr) node->hook.older->hook.newer = node->hook.newer;
+            else m_oldest = node->hook.newer;
+            if (node->hook.newer != nullptr) node->hook.newer->hook.older = node->hook.older;
+            else m_newest = node->hook.older;
+        }
+
+        [[nodiscard]] Node *victim() const noexcept {
+            return m_oldest;
+        }
+    };
+};
+
+/// 随机:均匀随机淘汰;hook 为节点在稠密数组中的下标,删除时用最后一个节点填补
+struct RandomReplacement {
+    template<typename Node>
+    struct hook {
+        std::size_t index = 0;
+    };
+
+    template<typename Node>
+    class policy {
+    private:
+        std::pmr::vector<Node *> m_nodes;
+        std::mt19937 m_gen;
+
+    public:
+        policy(std::size_t capacity, std::pmr::memory_resource *resource)
+                : m_nodes(resource), m_gen(std::random_device{}()) {
+            m_nodes.reserve(capacity);
+        }
+
+        void inserted(Node *node) {
+            node->hook.index = m_nodes.size();
+            m_nodes.push_back(node);
+        }
+
+        void replaced(Node *old, Node *fresh) noexcept {
+            fresh->hook.index = old->hook.index;
+            m_nodes[fresh->hook.index] = fresh;
+        }
+
+        void removed(Node *node) noexcept {
+            std::size_t index = node->hook.index;
+            m_nodes[index] = m_nodes.back();
+            m_nodes[index]->hook.index = index;
+            m_nodes.pop_back();
+        }
+
+        [[nodiscard]] Node *victim() {
+            return m_nodes[std::uniform_int_distribution<std::size_t>(0, m_nodes.size() - 1)(m_gen)];
+        }
+    };
+};
+
+/// 读路径无锁的并发缓存:FIFO/随机淘汰的 get 从不修改淘汰状态,读者因此完全不加锁
+/// - 索引是固定桶数的链式哈希表,桶头与链上的指针都是原子指针,读者只做 acquire 读;
+///   读者唯一的写入是 EpochDomain 中自己独占缓存行的槽位(见 Epoch.hpp),不与其他读者争用任何缓存行
+/// - 节点不可变:替换值时构造新节点整体换入,被淘汰、删除或替换的节点经 epoch 回收延迟释放,
+///   读者在写者并发修改时也能安全地复制值或以 const V& 访问它
+/// - 写者(put/erase)之间由一把互斥锁串行化,淘汰顺序只由写者维护(见 FIFOReplacement/RandomReplacement)
+/// - 桶数在构造时确定(不小于容量的 2 的幂),之后不再扩容;size() 为写者维护的计数,读取不加锁
+/// - 节点与写者的辅助结构从构造时给出的 std::pmr::memory_resource 分配;只有写者分配和释放,资源不必线程安全
+/// - 没有统计、移除监听与 TTL,需要这些功能时使用 ConcurrentCache
+/// - get/contains 另有异构重载(见 KeyTraits.hpp)
+/// 析构时调用方须保证没有其他线程仍在访问缓存
+template<typename K, typename V, typename Replacement = FIFOReplacement>
+class LockFreeReadCache {
+private:
+    struct Node {
+        std::atomic<Node *> next;
+        std::uint64_t hash;
+        K key;
+        V value;
+        typename Replacement::template hook<Node> hook;  // 只由写者访问
+
+        template<typename KK, typename VV>
+        Node(Node *n, std::uint64_t h, KK &&k, VV &&v)
+                : next(n), hash(h), key(std::forward<KK>(k)), value(std::forward<VV>(v)) {}
+    };
+
+    struct NodeDeleter {
+        std::pmr::memory_resource *resource;
+
+        void operator()(Node *node) const {
+            std::pmr::polymorphic_allocator<Node> allocator(resource);
+            std::allocator_traits<decltype(allocator)>::destroy(allocator, node);
+            allocator.deallocate(node, 1);
+        }
+    };
+
+    std::size_t m_capacity;
+    std::size_t m_mask;
+    std::pmr::vector<std::atomic<Node *>> m_buckets;
+    std::atomic<std::size_t> m_size{0};
+    std::mutex m_writeMutex;
+    typename Replacement::template policy<Node> m_replacement;
+    RetireList<Node, NodeDeleter> m_retired;
+    EpochDomain &m_domain = EpochDomain::instance();
+
+    template<typename Q>
+    static std::uint64_t hashOf(const Q &key) {
+        return mixHash(static_cast<std::uint64_t>(KeyHash<K>{}(key)));
+    }
+
+    static std::size_t bucketCount(std::size_t capacity) {
+        std::size_t count = 1;
+        while (count < capacity) count <<= 1;
+        return count;
+    }
+
+    std::atomic<Node *> &bucketOf(std::uint64_t hash) noexcept {
+        return m_buckets[hash & m_mask];
+    }
+
+    /// 读者:在临界区内沿链查找
+    template<typename Q>
+    const Node *find(const Q &key) const {
+        std::uint64_t hash = hashOf(key);
+        const Node *node = m_buckets[hash & m_mask].load(std::memory_order_acquire);
+        while (node != nullptr && !(node->hash == hash && node->key == key)) {
+            node = node->next.load(std::memory_order_acquire);
+        }
+        return node;
+    }
+
+    /// 写者:返回指向 key 所在节点的链接(找不到时指向链尾的 nullptr)
+    std::atomic<Node *> *linkOf(const K &key, std::uint64_t hash) noexcept {
+        std::atomic<Node *> *link = &bucketOf(hash);
+        for (Node *node = link->load(std::memory_order_relaxed); node != nullptr;
+             node = link->load(std::memory_order_relaxed)) {
+            if (node->hash == hash && node->key == key) return link;
+            link = &node->next;
+        }
+        return link;
+    }
+
+    // 把节点从桶链与淘汰顺序中摘下并退休;读者可能仍停在它上面,它的 next 保持不变
+    void unlink(std::atomic<Node *> *link, Node *node) {
+        link->store(node->next.load(std::memory_order_relaxed), std::memory_order_release);
+        m_replacement.removed(node);
+        m_size.fetch_sub(1, std::memory_order_relaxed);
+        m_retired.retire(node);
+    }
+
+    void evict() {
+        Node *victim = m_replacement.victim();
+        unlink(linkOf(victim->key, victim->hash), victim);
+    }
+
+    template<typename KK, typename VV>
+    Node *make(Node *next, std::uint64_t hash, KK &&key, VV &&value) {
+        std::pmr::polymorphic_allocator<Node> allocator(m_buckets.get_allocator().resource());
+        Node *node = allocator.allocate(1);
+        try {
+            std::allocator_traits<decltype(allocator)>::construct(allocator, node, next, hash,
+                                                                  std::forward<KK>(key), std::forward<VV>(value));
+        } catch (...) {
+            allocator.deallocate(node, 1);
+            throw;
+        }
+        return node;
+    }
+
+    template<typename KK, typename VV>
+    void insert(KK &&key, VV &&value) {
+        std::uint64_t hash = hashOf(key);
+        std::lock_guard lock(m_writeMutex);
+        std::atomic<Node *> *link = linkOf(key, hash);
+        if (Node *old = link->load(std::memory_order_relaxed)) {
+            // 已存在:新节点接替旧节点在桶链与淘汰顺序中的位置,旧节点退休
+            Node *fresh = make(old->next.load(std::memory_order_relaxed), hash,
+                               std::forward<KK>(key), std::forward<VV>(value));
+            m_replacement.replaced(old, fresh);
+            link->store(fresh, std::memory_order_release);
+            m_retired.retire(old);
+            return;
+        }
+        if (m_size.load(std::memory_order_relaxed) >= m_capacity) evict();
+        // 新节点完整构造之后才以 release 发布到桶头
+        std::atomic<Node *> &head = bucketOf(hash);
+        Node *node = make(head.load(std::memory_order_relaxed), hash, std::forward<KK>(key), std::forward<VV>(value));
+        try {
+            m_replacement.inserted(node);
+        } catch (...) {
+            NodeDeleter{m_buckets.get_allocator().resource()}(node);
+            throw;
+        }
+        head.store(node, std::memory_order_release);
+        m_size.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    template<typename Q>
+    std::optional<V> lookup(const Q &key) const {
+        auto guard = m_domain.pin();
+        const Node *node = find(key);
+        if (node == nullptr) return std::nullopt;
+        return node->value;
+    }
+
+    template<typename Q>
+    bool has(const Q &key) const {
+        auto guard = m_domain.pin();
+        return find(key) != nullptr;
+    }
+
+public:
+    explicit LockFreeReadCache(std::size_t capacity,
+                               std::pmr::memory_resource *resource = std::pmr::get_default_resource())
+            : m_capacity(capacity),
+              m_mask(bucketCount(capacity) - 1),
+              m_buckets(bucketCount(capacity), resource),
+              m_replacement(capacity, resource),
+              m_retired(NodeDeleter{resource}, resource) {
+        if (capacity == 0)
+            throw std::invalid_argument("LockFreeReadCache capacity must be > 0");
+    }
+
+    LockFreeReadCache(const LockFreeReadCache &) = delete;
+
+    LockFreeReadCache &operator=(const LockFreeReadCache &) = delete;
+
+    ~LockFreeReadCache() {
+        NodeDeleter deleter{m_buckets.get_allocator().resource()};
+        for (auto &bucket: m_buckets) {
+            Node *node = bucket.load(std::memory_order_relaxed);
+            while (node != nullptr) {
+                Node *next = node->next.load(std::memory_order_relaxed);
+                deleter(node);
+                node = next;
+            }
+        }
+    }
+
+    void put(const K &key, const V &value) {
+        insert(key, value);
+    }
+
+    void put(K &&key, V &&value) {
+        insert(std::move(key), std::move(value));
+    }
+
+    /// 无锁读取,返回值的副本
+    std::optional<V> get(const K &key) const {
+        return lookup(key);
+    }
+
+    template<LookupKey<K> Q>
+    std::optional<V> get(const Q &key) const {
+        return lookup(key);
+    }
+
+    /// 在临界区内以 const V& 调用 visitor,不复制值;返回是否命中
+    /// visitor 执行期间节点不会被释放,但 visitor 不应长时间停留,否则推迟回收
+    template<typename F>
+    bool visit(const K &key, F &&visitor) const {
+        auto guard = m_domain.pin();
+        const Node *node = find(key);
+        if (node == nullptr) return false;
+        std::forward<F>(visitor)(node->value);
+        return true;
+    }
+
+    void erase(const K &key) {
+        std::uint64_t hash = hashOf(key);
+        std::lock_guard lock(m_writeMutex);
+        std::atomic<Node *> *link = linkOf(key, hash);
+        if (Node *node = link->load(std::memory_order_relaxed)) unlink(link, node);
+    }
+
+    [[nodiscard]] bool contains(const K &key) const {
+        return has(key);
+    }
+
+    template<LookupKey<K> Q>
+    [[nodiscard]] bool contains(const Q &key) const {
+        return has(key);
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept {
+        return m_size.load(std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] std::size_t capacity() const noexcept {
+        return m_capacity;
+    }
+
+    /// 已被摘下、等待 epoch 回收的节点数
+    [[nodiscard]] std::size_t pendingReclamation() {
+        std::lock_guard lock(m_writeMutex);
+        return m_retired.size();
+    }
+
+    /// 尝试推进 epoch 并释放已经安全的节点;写操作会定期自动调用
+    void reclaim() {
+        std::lock_guard lock(m_writeMutex);
+        m_retired.collect();
+    }
+};
+
+template<typename K, typename V>
+using LockFreeFIFOCache = LockFreeReadCache<K, V, FIFOReplacement>;
+
+template<typename K, typename V>
+using LockFreeRandomCache = LockFreeReadCache<K, V, RandomReplacement>;
+
+#endif //CACHE_LOCKFREEREADCACHE_HPP
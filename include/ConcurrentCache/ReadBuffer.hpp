@@ -0,0 +1,78 @@
+#ifndef CACHE_READBUFFER_HPP
+#define CACHE_READBUFFER_HPP
+
+#include "../Cache/Utility.hpp"
+#include <array>
+#include <atomic>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+
+/// 分条带、有损的访问事件缓冲区(参考 Caffeine 的 read buffer)
+/// 与 Caffeine 不同,这里的查找本身不是无锁的:缓冲区只让命中不必为调整淘汰顺序而获取写锁
+/// - 每个线程固定映射到一个条带,条带是容量为 kSlots 的环形队列,各自独占缓存行
+/// - record 在条带已满时直接丢弃事件(有损),绝不阻塞读路径
+/// - drain 按记录顺序回放所有条带中的事件后清空
+///
+/// 同步约定:record 必须在持有某把 std::shared_mutex 的读锁时调用,
+/// drain 必须在持有同一把锁的写锁时调用。读写锁本身提供了记录与回放之间的
+/// happens-before 关系,因此条带内部只需用原子 CAS 在多个记录者之间分配槽位。
+template<typename K>
+class StripedReadBuffer {
+public:
+    static constexpr std::uint32_t kSlots = 16;       // 每个条带的槽位数,必须是 2 的幂
+    static constexpr std::uint32_t kDrainThreshold = kSlots / 2;
+    static constexpr std::size_t kMaxStripes = 16;
+
+private:
+    struct alignas(kCacheLineSize) Stripe {
+        std::atomic<std::uint32_t> tail{0};  // 下一个待分配的槽位(记录者之间竞争)
+        std::atomic<std::uint32_t> head{0};  // 下一个待回放的槽位(仅在写锁下修改)
+        std::array<std::optional<K>, kSlots> slots;
+    };
+
+    std::unique_ptr<Stripe[]> m_stripes;
+    std::size_t m_mask;
+
+public:
+    StripedReadBuffer()
+            : m_stripes(std::make_unique<Stripe[]>(stripeCount(kMaxStripes))),
+              m_mask(stripeCount(kMaxStripes) - 1) {}
+
+    /// 记录一次访问;返回 true 表示当前条带积压较多(或已满而丢弃),调用方应尽快触发 drain
+    /// key 可以是任何可赋值给 K 的类型(如 std::string_view):槽位复用已有的 K,
+    /// 对 std::string 这类 key 稳态下不会分配内存
+    template<typename Q>
+    requires std::constructible_from<K, const Q &> && std::assignable_from<K &, const Q &>
+    bool record(const Q &key) {
+        Stripe &stripe = m_stripes[threadIndex() & m_mask];
+        // 读锁期间 head 不会变化
+        std::uint32_t head = stripe.head.load(std::memory_order_relaxed);
+        std::uint32_t tail = stripe.tail.load(std::memory_order_relaxed);
+        do {
+            if (tail - head >= kSlots) return true;  // 已满,丢弃本次事件
+        } while (!stripe.tail.compare_exchange_weak(tail, tail + 1, std::memory_order_relaxed));
+        auto &slot = stripe.slots[tail & (kSlots - 1)];
+        if (slot) *slot = key;
+        else slot.emplace(key);
+        return tail + 1 - head >= kDrainThreshold;
+    }
+
+    /// 按条带依次回放所有积压的事件
+    template<typename F>
+    void drain(F &&apply) {
+        for (std::size_t i = 0; i <= m_mask; ++i) {
+            Stripe &stripe = m_stripes[i];
+            std::uint32_t head = stripe.head.load(std::memory_order_relaxed);
+            std::uint32_t tail = stripe.tail.load(std::memory_order_relaxed);
+            for (; head != tail; ++head) {
+                apply(*stripe.slots[head & (kSlots - 1)]);
+            }
+            stripe.head.store(head, std::memory_order_relaxed);
+        }
+    }
+};
+
+#endif //CACHE_READBUFFER_HPP
@@ -0,0 +1,256 @@
+#ifndef CACHE_SHARDEDCONCURRENTCACHE_HPP
+#define CACHE_SHARDEDCONCURRENTCACHE_HPP
+
+#include "ConcurrentCache.hpp"
+#include "../Cache/Utility.hpp"
+#include <algorithm>
+#include <chrono>
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+/// 分片并发缓存:按 key 的哈希值把条目分散到 N 个相互独立加锁的 CacheImpl 中
+/// - 不同分片上的读写互不阻塞,写操作不再被一把全局锁串行化
+/// - 总容量在各分片间均分(前 capacity % N 个分片各多分 1 个),每个分片独立执行淘汰策略,
+///   因此淘汰顺序只在分片内部精确
+/// - 每个分片单独对齐到缓存行,分片锁之间不会伪共享
+/// CacheImpl 必须满足 CachePolicy(见 Cache.hpp),且第一个构造参数为容量
+/// 其余构造参数原样传给每个分片;传入的 memory_resource 因此被各分片共享,须是线程安全的(如 SynchronizedNodePoolResource)
+template<typename K, typename V, typename CacheImpl>
+class ShardedConcurrentCache {
+private:
+    struct alignas(kCacheLineSize) Shard {
+        ConcurrentCache<K, V, CacheImpl> cache;
+
+        template<typename... Args>
+        explicit Shard(std::size_t capacity, const Args &... args)
+                : cache(capacity, args...) {}
+    };
+
+    std::vector<std::unique_ptr<Shard>> m_shards;
+
+    template<typename Q>
+    Shard &shardFor(const Q &key) const {
+        return *m_shards[shardIndex(key)];
+    }
+
+    /// 按分片稳定地分组:先算出每个元素所属分片,再计数排序
+    /// 对每个非空分片调用 f(shard, 该分片的元素在输入中的位置),同一分片内保持输入顺序;元素本身不被复制
+    template<typename T, typename KeyOf, typename F>
+    void forEachShardGroup(std::span<const T> items, KeyOf keyOf, F &&f) const {
+        std::vector<std::size_t> shardOf(items.size());
+        std::vector<std::size_t> offsets(m_shards.size() + 1, 0);
+        for (std::size_t i = 0; i < items.size(); ++i) {
+            shardOf[i] = shardIndex(keyOf(items[i]));
+            ++offsets[shardOf[i] + 1];
+        }
+        for (std::size_t s = 0; s < m_shards.size(); ++s) offsets[s + 1] += offsets[s];
+        std::vector<std::size_t> positions(items.size());
+        std::vector<std::size_t> cursor(offsets.begin(), offsets.end() - 1);
+        for (std::size_t i = 0; i < items.size(); ++i) positions[cursor[shardOf[i]]++] = i;
+        for (std::size_t s = 0; s < m_shards.size(); ++s) {
+            if (offsets[s] == offsets[s + 1]) continue;
+            f(*m_shards[s], std::span<const std::size_t>(positions.data() + offsets[s], offsets[s + 1] - offsets[s]));
+        }
+    }
+
+    static const K &keyOfKey(const K &key) noexcept { return key; }
+
+    static const K &keyOfEntry(const std::pair<K, V> &entry) noexcept { return entry.first; }
+
+public:
+    /// 默认分片数:硬件线程数向上取整到 2 的幂
+    static std::size_t defaultShardCount() noexcept {
+        std::size_t n = std::max(1u, std::thread::hardware_concurrency());
+        std::size_t count = 1;
+        while (count < n) count <<= 1;
+        return count;
+    }
+
+    /// capacity 为所有分片的总容量;分片数不会超过 capacity,保证每个分片容量 > 0
+    /// 额外参数原样转发给每个分片的 CacheImpl
+    template<typename... Args>
+    explicit ShardedConcurrentCache(std::size_t capacity,
+                                    std::size_t shardCount = defaultShardCount(),
+                                    const Args &... args) {
+        if (capacity == 0)
+            throw std::invalid_argument("ShardedConcurrentCache capacity must be > 0");
+        if (shardCount == 0)
+            throw std::invalid_argument("ShardedConcurrentCache shard count must be > 0");
+        shardCount = std::min(shardCount, capacity);
+        m_shards.reserve(shardCount);
+        for (std::size_t i = 0; i < shardCount; ++i) {
+            std::size_t shardCapacity = capacity / shardCount + (i < capacity % shardCount ? 1 : 0);
+            m_shards.push_back(std::make_unique<Shard>(shardCapacity, args...));
+        }
+    }
+
+    /// 插入或更新
+    void put(const K &key, const V &value) {
+        shardFor(key).cache.put(key, value);
+    }
+
+    /// 插入或更新,key 与 value 被移入缓存
+    void put(K &&key, V &&value) {
+        shardFor(key).cache.put(std::move(key), std::move(value));
+    }
+
+    /// 以指定 TTL 插入或更新(仅适用于支持 TTL 的实现)
+    template<typename Duration>
+    void put(const K &key, const V &value, Duration ttl)
+    requires requires(ConcurrentCache<K, V, CacheImpl> &cache) { cache.put(key, value, ttl); } {
+        shardFor(key).cache.put(key, value, ttl);
+    }
+
+    template<typename Duration>
+    void put(K &&key, V &&value, Duration ttl)
+    requires requires(ConcurrentCache<K, V, CacheImpl> &cache) { cache.put(std::move(key), std::move(value), ttl); } {
+        shardFor(key).cache.put(std::move(key), std::move(value), ttl);
+    }
+
+    /// 以 args 构造值后插入或替换
+    template<typename... Args>
+    void emplace(K key, Args &&... args) {
+        shardFor(key).cache.put(std::move(key), V(std::forward<Args>(args)...));
+    }
+
+    /// 仅当 key 不存在时构造值并插入,返回是否插入(在所属分片内原子完成)
+    template<typename... Args>
+    bool try_emplace(K key, Args &&... args) {
+        return shardFor(key).cache.try_emplace(std::move(key), std::forward<Args>(args)...);
+    }
+
+    /// 在所属分片的锁内以 const V& 调用 visitor,不复制值;返回是否命中
+    template<typename F>
+    bool visit(const K &key, F &&visitor) {
+        return shardFor(key).cache.visit(key, std::forward<F>(visitor));
+    }
+
+    /// 获取
+    std::optional<V> get(const K &key) {
+        return shardFor(key).cache.get(key);
+    }
+
+    /// 异构获取(见 KeyTraits.hpp),不构造 K
+    template<LookupKey<K> Q>
+    std::optional<V> get(const Q &key) {
+        return shardFor(key).cache.get(key);
+    }
+
+    /// 获取;未命中时在所属分片内以 single-flight 方式调用 loader(key) 加载(见 ConcurrentCache::getOrLoad)
+    template<typename Loader>
+    requires std::invocable<Loader &, const K &>
+    std::optional<V> getOrLoad(const K &key, Loader &&loader) {
+        return shardFor(key).cache.getOrLoad(key, std::forward<Loader>(loader));
+    }
+
+    /// 开启/关闭 getOrLoad 的负缓存;capacity 为所有分片合计可记住的 key 数
+    template<typename Rep, typename Period>
+    void setNegativeCaching(std::chrono::duration<Rep, Period> ttl, std::size_t capacity = 1024) {
+        std::size_t perShard = std::max<std::size_t>(1, capacity / m_shards.size());
+        for (auto &shard: m_shards) shard->cache.setNegativeCaching(ttl, capacity == 0 ? 0 : perShard);
+    }
+
+    /// 为每个分片设置同一个移除监听器(见 ConcurrentCache::setRemovalListener);监听器可能被多个线程并发调用
+    void setRemovalListener(const RemovalListener<K, V> &listener)
+    requires requires(ConcurrentCache<K, V, CacheImpl> &cache) { cache.setRemovalListener(listener); } {
+        for (auto &shard: m_shards) shard->cache.setRemovalListener(listener);
+    }
+
+    /// 批量获取:按分片分组,每个分片只加一次锁;结果与 keys 一一对应
+    std::vector<std::optional<V>> getMany(std::span<const K> keys) {
+        std::vector<std::optional<V>> result(keys.size());
+        forEachShardGroup(keys, keyOfKey, [&result, keys](Shard &shard, std::span<const std::size_t> positions) {
+            auto values = shard.cache.getMany(keys, positions);
+            for (std::size_t i = 0; i < positions.size(); ++i) result[positions[i]] = std::move(values[i]);
+        });
+        return result;
+    }
+
+    /// 批量插入或更新:按分片分组,每个分片只加一次锁;同一 key 的多次写入保持先后顺序
+    void putMany(std::span<const std::pair<K, V>> entries) {
+        forEachShardGroup(entries, keyOfEntry, [entries](Shard &shard, std::span<const std::size_t> positions) {
+            shard.cache.putMany(entries, positions);
+        });
+    }
+
+    /// 批量删除:按分片分组,每个分片只加一次锁
+    void eraseMany(std::span<const K> keys) {
+        forEachShardGroup(keys, keyOfKey, [keys](Shard &shard, std::span<const std::size_t> positions) {
+            shard.cache.eraseMany(keys, positions);
+        });
+    }
+
+    /// 删除条目
+    void erase(const K &key) {
+        shardFor(key).cache.erase(key);
+    }
+
+    template<LookupKey<K> Q>
+    void erase(const Q &key) {
+        shardFor(key).cache.erase(key);
+    }
+
+    /// 是否包含
+    bool contains(const K &key) const {
+        return shardFor(key).cache.contains(key);
+    }
+
+    template<LookupKey<K> Q>
+    bool contains(const Q &key) const {
+        return shardFor(key).cache.contains(key);
+    }
+
+    /// 当前大小:逐个分片累加,任一时刻最多持有一个分片的读锁
+    /// 并发写入时结果只是近似快照
+    std::size_t size() const noexcept {
+        std::size_t total = 0;
+        for (const auto &shard: m_shards) total += shard->cache.size();
+        return total;
+    }
+
+    /// 当前计费总和(仅适用于带 Sizer 的策略);与 size() 一样逐个分片累加
+    /// 注意预算同样在分片间均分,计费超过单个分片预算的条目会被拒绝
+    std::size_t totalCharge() const
+    requires requires(const CacheImpl &cache) { cache.totalCharge(); } {
+        std::size_t total = 0;
+        for (const auto &shard: m_shards) total += shard->cache.totalCharge();
+        return total;
+    }
+
+    /// 统计快照(仅当 CacheImpl 启用统计时可用):逐个分片汇总,与 size() 一样只是近似快照
+    CacheStatsSnapshot stats() const
+    requires StatsRecordingPolicy<CacheImpl> {
+        CacheStatsSnapshot total;
+        for (const auto &shard: m_shards) total += shard->cache.stats();
+        return total;
+    }
+
+    /// 逐个分片清理已到期的条目(仅适用于支持 TTL 的实现)
+    void cleanUp()
+    requires requires(ConcurrentCache<K, V, CacheImpl> &cache) { cache.cleanUp(); } {
+        for (auto &shard: m_shards) shard->cache.cleanUp();
+    }
+
+    /// key 所属分片的下标
+    /// 分片内的 FlatHashMap 用同一个混洗后哈希值的低位作控制字节与探测起点,因此这里取高 32 位
+    /// 做乘法映射(h_hi * N >> 32):分片的选择与低位无关,每个分片里的条目仍使用全部 128 个控制字节
+    template<typename Q>
+    [[nodiscard]] std::size_t shardIndex(const Q &key) const {
+        auto h = mixHash(static_cast<std::uint64_t>(KeyHash<K>{}(key)));
+        return static_cast<std::size_t>(((h >> 32) * m_shards.size()) >> 32);
+    }
+
+    /// 分片数
+    [[nodiscard]] std::size_t shardCount() const noexcept {
+        return m_shards.size();
+    }
+};
+
+#endif //CACHE_SHARDEDCONCURRENTCACHE_HPP
@@ -3,11 +3,84 @@
 #include "../include/ConcurrentCache/ConcurrentLFUCache.hpp"
 #include "../include/ConcurrentCache/ConcurrentRandomReplacementCache.hpp"
 #include "../include/ConcurrentCache/ConcurrentWeightedCache.hpp"
+#include "../include/ConcurrentCache/ShardedConcurrentCache.hpp"
+#include "../include/ConcurrentCache/ConcurrentSlabFIFOCache.hpp"
+#include "../include/ConcurrentCache/ConcurrentSlabLRUCache.hpp"
+#include "../include/Cache/FlatHashMap.hpp"
+#include "../include/Cache/ComposedCache.hpp"
+#include "../include/Cache/NodePool.hpp"
+#include "../include/ConcurrentCache/ConcurrentTinyLFUCache.hpp"
+#include "../include/ConcurrentCache/ConcurrentARCCache.hpp"
+#include "../include/ConcurrentCache/ConcurrentS3FIFOCache.hpp"
+#include "../include/ConcurrentCache/ConcurrentSIEVECache.hpp"
+#include "../include/ConcurrentCache/ConcurrentExpiringCache.hpp"
+#include "../include/ConcurrentCache/AsyncCache.hpp"
+#include "../include/ConcurrentCache/ConcurrentHybridCache.hpp"
+#include "../include/ConcurrentCache/LockFreeReadCache.hpp"
+#include "../include/Cache/MissRatioCurve.hpp"
+#include "../include/Cache/Trace.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <coroutine>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <memory_resource>
+#include <functional>
+#include <future>
+#include <mutex>
 #include <cassert>
+#include <cmath>
+#include <cstdlib>
+#include <new>
+#include <random>
 #include <iostream>
 #include <thread>
 #include <vector>
+#include <map>
 #include <set>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+// ===== 全局分配计数:用于验证稳态下不做堆分配 =====
+static std::atomic<std::size_t> g_allocations{0};
+static std::atomic<std::size_t> g_large_allocations{0};  // >= 256 字节,用于统计长 key 的复制
+
+void *operator new(std::size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (size >= 256) g_large_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void *p = std::malloc(size == 0 ? 1 : size)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void *p, std::size_t) noexcept {
+    std::free(p);
+}
+
+// std::pmr::new_delete_resource 经由带对齐的版本分配
+void *operator new(std::size_t size, std::align_val_t alignment) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (size >= 256) g_large_allocations.fetch_add(1, std::memory_order_relaxed);
+    auto align = static_cast<std::size_t>(alignment);
+    if (void *p = std::aligned_alloc(align, (size + align - 1) / align * align)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *p, std::align_val_t) noexcept {
+    std::free(p);
+}
+
+void operator delete(void *p, std::size_t, std::align_val_t) noexcept {
+    std::free(p);
+}
 
 // ===== FIFO Cache Tests =====
 void test_fifo_basic() {
@@ -183,6 +256,110 @@ void test_random_concurrent_mixed() {
     std::cout << "[random_concurrent_mixed] PASS\n";
 }
 
+template<typename Rank, std::size_t Samples = 8, std::size_t PoolSize = 0, typename V = int>
+using SampledCache = RandomReplacementCache<int, V, StdHashIndex, UnitSizer, NoStats,
+        SampledEviction<Rank, Samples, PoolSize>>;
+
+void test_random_sampled() {
+    // 条目数不超过样本数时比较全部条目,淘汰是精确的
+    {
+        SampledCache<LeastRecentlyUsed> lru(4);
+        for (int k = 1; k <= 4; ++k) lru.put(k, k);
+        assert(lru.get(1) == 1);
+        lru.put(5, 5);  // 2 最久未访问
+        assert(!lru.contains(2) && lru.contains(1));
+        assert(lru.get(3) == 3);
+        lru.put(6, 6);
+        assert(!lru.contains(4) && lru.contains(3) && lru.contains(5));
+    }
+    {
+        SampledCache<LeastFrequentlyUsed> lfu(3);
+        for (int k = 1; k <= 3; ++k) lfu.put(k, k);
+        for (int i = 0; i < 3; ++i) lfu.get(1);
+        lfu.get(2);
+        lfu.put(4, 4);  // 3 从未被访问
+        assert(!lfu.contains(3) && lfu.contains(1) && lfu.contains(2));
+        lfu.put(5, 5);  // 4 的次数最少
+        assert(!lfu.contains(4));
+        // 之后不再访问 1,它的次数随插入逐渐衰减,最终被每个都访问两次的新 key 挤掉
+        for (int k = 6; k < 36; ++k) {
+            lfu.put(k, k);
+            lfu.get(k);
+            lfu.get(k);
+        }
+        assert(!lfu.contains(1) && lfu.size() == 3);
+    }
+    {
+        struct Deadline {
+            int operator()(int, const std::pair<int, int> &value) const { return value.second; }
+        };
+        SampledCache<SoonestExpiry<Deadline>, 8, 0, std::pair<int, int>> ttl(3);
+        ttl.put(1, {1, 30});
+        ttl.put(2, {2, 10});
+        ttl.put(3, {3, 20});
+        ttl.put(4, {4, 40});
+        assert(!ttl.contains(2));
+        ttl.put(5, {5, 50});
+        assert(!ttl.contains(3) && ttl.contains(1));
+    }
+    // 候选池与删除、搬移交错:条目与访问信息保持一致
+    {
+        RandomReplacementCache<int, int, FlatHashIndex, UnitSizer, NoStats,
+                SampledEviction<LeastRecentlyUsed, 2, 4>> cache(64);
+        std::mt19937 gen(7);
+        for (int i = 0; i < 20000; ++i) {
+            int key = static_cast<int>(gen() % 256);
+            switch (gen() % 4) {
+                case 0:
+                    cache.erase(key);
+                    assert(!cache.contains(key));
+                    break;
+                case 1:
+                    if (auto value = cache.get(key)) assert(*value == key);
+                    break;
+                default:
+                    cache.put(key, key);
+                    assert(cache.get(key) == key);
+            }
+            assert(cache.size() <= 64);
+        }
+    }
+    // 热点集合与一次性 key 交替:采样 LRU 保住热点,均匀随机做不到
+    {
+        auto hits = [](auto &cache) {
+            int count = 0;
+            for (int i = 0; i < 40000; ++i) {
+                int key = i % 2 == 0 ? (i / 2) % 40 : 1000 + i;
+                if (cache.get(key)) ++count;
+                else cache.put(key, key);
+            }
+            return count;
+        };
+        RandomReplacementCache<int, int> uniform(100);
+        SampledCache<LeastRecentlyUsed, 5, 16> sampled(100);
+        int uniformHits = hits(uniform);
+        int sampledHits = hits(sampled);
+        assert(sampledHits > uniformHits + 5000);
+    }
+    // 命中只做 relaxed 原子写,读锁下并发 get 与写者交错
+    {
+        ConcurrentCache<int, int, SampledCache<LeastFrequentlyUsed, 5, 16>> cache(128);
+        std::vector<std::thread> workers;
+        for (int t = 0; t < 8; ++t) {
+            workers.emplace_back([&cache, t] {
+                for (int i = 0; i < 5000; ++i) {
+                    int key = (i * 7 + t) % 512;
+                    if (t % 2 == 0) cache.put(key, key);
+                    else if (auto value = cache.get(key)) assert(*value == key);
+                }
+            });
+        }
+        for (auto &th: workers) th.join();
+        assert(cache.size() <= 128);
+    }
+    std::cout << "[random_sampled] PASS\n";
+}
+
 // ===== Weighted Cache Tests =====
 void test_weighted_basic() {
     WeightedCache<int, std::pair<int, int>> cache(3);
@@ -195,23 +372,115 @@ void test_weighted_basic() {
 }
 
 void test_weighted_conflict() {
+    // 相同的权重可以并存,互不覆盖
     WeightedCache<int, std::pair<int, int>> cache(2);
     cache.put(1, {100, 50});
-    cache.put(2, {200, 50});  // conflict
-    assert(cache.size() == 1 && cache.get(1).has_value() && cache.get(1)->first == 200);
+    cache.put(2, {200, 50});
+    assert(cache.size() == 2 && cache.get(1)->first == 100 && cache.get(2)->first == 200);
+    cache.put(3, {300, 60});  // 权重相同时先淘汰较早写入的 1
+    assert(!cache.contains(1) && cache.contains(2) && cache.contains(3));
     std::cout << "[weighted_conflict] PASS\n";
 }
 
 void test_weighted_uniform() {
+    // 权重全部相同时按写入顺序淘汰
     WeightedCache<int, std::pair<int, int>> cache(10);
-    cache.put(1, {1, 999});
-    for (int v = 2; v < 100; ++v) {
+    for (int v = 1; v < 100; ++v) {
         cache.put(v, {v, 999});
-        assert(cache.size() == 1);
+        assert(cache.size() == std::min<std::size_t>(v, 10));
+        assert(cache.contains(v) && !cache.contains(v - 10));
     }
     std::cout << "[weighted_uniform] PASS\n";
 }
 
+void test_weighted_heap() {
+    // 与按 (权重, 写入序号) 排序的参考实现逐步比较淘汰结果,覆盖更新与删除
+    WeightedCache<int, std::pair<int, int>> cache(64);
+    WeightedCache<int, std::pair<int, int>, FlatHashIndex> flat(64);
+    std::map<int, std::pair<int, std::uint64_t>> reference;  // key -> (权重, 序号)
+    std::uint64_t sequence = 0;
+    std::mt19937 rng(3);
+    for (int i = 0; i < 20000; ++i) {
+        int key = static_cast<int>(rng() % 200);
+        int weight = static_cast<int>(rng() % 16);
+        if (rng() % 5 == 0) {
+            cache.erase(key);
+            flat.erase(key);
+            reference.erase(key);
+            continue;
+        }
+        cache.put(key, {i, weight});
+        flat.put(key, {i, weight});
+        if (!reference.contains(key) && reference.size() == 64) {
+            auto victim = std::min_element(reference.begin(), reference.end(), [](const auto &a, const auto &b) {
+                return a.second < b.second;
+            });
+            reference.erase(victim);
+        }
+        reference[key] = {weight, sequence++};
+        assert(cache.size() == reference.size() && flat.size() == reference.size());
+    }
+    for (const auto &[key, entry]: reference) {
+        assert(cache.get(key)->second == entry.first);
+        assert(flat.get(key)->second == entry.first);
+    }
+    std::cout << "[weighted_heap] PASS\n";
+}
+
+void test_weighted_gdsf() {
+    // 代价 / 大小:同样大小时代价高的留下,同样代价时小的留下
+    struct EntrySizer {
+        std::size_t operator()(int, const std::pair<int, int> &entry) const { return static_cast<std::size_t>(entry.first); }
+    };
+    using Gdsf = WeightedCache<int, std::pair<int, int>, StdHashIndex, NoStats, GreedyDualSizeFrequency<EntrySizer>>;
+    {
+        Gdsf cache(10);
+        cache.put(1, {4, 100});   // 大小 4,代价 100:优先级 25
+        cache.put(2, {4, 10});    // 优先级 2.5
+        cache.put(3, {2, 10});    // 优先级 5
+        assert(cache.totalCharge() == 10);
+        cache.put(4, {2, 8});     // 淘汰 2,膨胀时钟升到 2.5
+        assert(!cache.contains(2) && cache.contains(3) && cache.totalCharge() == 8);
+        assert(cache.inflation() == 2.5);
+    }
+    {
+        // 访问次数提高优先级;被淘汰的旧热点不会因为历史访问永远留下:新条目从更高的时钟起步
+        Gdsf cache(3);
+        cache.put(1, {1, 1});
+        cache.put(2, {1, 1});
+        cache.put(3, {1, 1});
+        for (int i = 0; i < 3; ++i) cache.get(1);
+        cache.get(2);
+        cache.put(4, {1, 1});     // 3 的访问次数最少
+        assert(!cache.contains(3));
+        for (int k = 5; k < 10; ++k) {
+            cache.put(k, {1, 1});
+            cache.get(k);
+            cache.get(k);
+        }
+        assert(!cache.contains(2) && cache.inflation() > 1.0);
+    }
+    {
+        // 并发装饰器只在读锁下 peek,访问次数经读缓冲区回放
+        static_assert(BufferedAccessPolicy<Gdsf, int, std::pair<int, int>>);
+        static_assert(!BufferedAccessPolicy<WeightedCache<int, std::pair<int, int>>, int, std::pair<int, int>>);
+        ConcurrentCache<int, std::pair<int, int>, Gdsf> cache(200);
+        std::vector<std::thread> workers;
+        for (int t = 0; t < 4; ++t) {
+            workers.emplace_back([&cache, t] {
+                for (int i = 0; i < 4000; ++i) {
+                    int key = (i * 7 + t) % 300;
+                    if (auto hit = cache.get(key)) assert(hit->second == key % 13);
+                    else cache.put(key, {1 + key % 3, key % 13});
+                }
+            });
+        }
+        for (auto &worker: workers) worker.join();
+        assert(cache.totalCharge() <= 200);
+    }
+    std::cout << "[weighted_gdsf] PASS\n";
+}
+
 void test_weighted_concurrent_put() {
     ConcurrentCache<int, std::pair<int, int>, WeightedCache<int, std::pair<int, int>>> cache(50);
     const int threads = 8;
@@ -269,6 +538,2431 @@ void test_weighted_concurrent_mixed() {
     std::cout << "[weighted_concurrent_mixed] PASS\n";
 }
 
+// ===== Sharded Concurrent Cache Tests =====
+void test_sharded_basic() {
+    ShardedConcurrentCache<int, int, LRUCache<int, int>> cache(10, 4);
+    assert(cache.shardCount() == 4);
+    for (int i = 0; i < 10; ++i) cache.put(i, i * 10);
+    for (int i = 0; i < 10; ++i) {
+        auto v = cache.get(i);
+        if (v) assert(*v == i * 10);
+    }
+    cache.erase(3);
+    assert(!cache.contains(3));
+    assert(cache.size() <= 10);
+    // 分片数不超过容量
+    ShardedConcurrentCache<int, int, FIFOCache<int, int>> tiny(2, 8);
+    assert(tiny.shardCount() == 2);
+    std::cout << "[sharded_basic] PASS\n";
+}
+
+void test_sharded_capacity_split() {
+    ShardedConcurrentCache<int, int, FIFOCache<int, int>> cache(100, 8);
+    for (int i = 0; i < 10000; ++i) cache.put(i, i);
+    // 每个分片都被写满,总量恰好等于总容量
+    assert(cache.size() == 100);
+    std::cout << "[sharded_capacity_split] PASS\n";
+}
+
+void test_sharded_hash_bits() {
+    // 分片只取哈希高位:每个分片内的 key 仍覆盖 FlatHashMap 的全部 128 个控制字节,且分片大致均衡
+    ShardedConcurrentCache<int, int, LRUCache<int, int, FlatHashIndex>> cache(1 << 16, 16);
+    std::vector<std::set<int>> tags(cache.shardCount());
+    std::vector<int> counts(cache.shardCount(), 0);
+    for (int k = 0; k < 32000; ++k) {
+        std::size_t shard = cache.shardIndex(k);
+        assert(shard < cache.shardCount());
+        ++counts[shard];
+        tags[shard].insert(static_cast<int>(mixHash(static_cast<std::uint64_t>(KeyHash<int>{}(k))) & 0x7F));
+    }
+    for (std::size_t s = 0; s < cache.shardCount(); ++s) {
+        assert(tags[s].size() == 128);
+        assert(counts[s] > 1600 && counts[s] < 2400);
+    }
+    std::cout << "[sharded_hash_bits] PASS\n";
+}
+
+void test_sharded_concurrent_all_policies() {
+    auto run = [](auto &cache) {
+        const int threads = 8;
+        const int ops = 500;
+        std::vector<std::thread> workers;
+        workers.reserve(threads);
+        for (int t = 0; t < threads; ++t) {
+            workers.emplace_back([&cache, t]() {
+                for (int i = 0; i < ops; ++i) {
+                    int k = t * ops + i;
+                    if constexpr (std::is_same_v<std::decay_t<decltype(cache.get(k))>, std::optional<int>>)
+                        cache.put(k, i);
+                    else
+                        cache.put(k, {i, k});
+                    cache.contains(k);
+                    if (i % 7 == 0) cache.erase(k);
+                }
+            });
+        }
+        for (auto &th: workers) th.join();
+        assert(cache.size() <= 64);
+    };
+    ShardedConcurrentCache<int, int, FIFOCache<int, int>> fifo(64);
+    ShardedConcurrentCache<int, int, LRUCache<int, int>> lru(64);
+    ShardedConcurrentCache<int, int, LFUCache<int, int>> lfu(64);
+    ShardedConcurrentCache<int, int, RandomReplacementCache<int, int>> rnd(64);
+    ShardedConcurrentCache<int, std::pair<int, int>, WeightedCache<int, std::pair<int, int>>> weighted(64);
+    run(fifo);
+    run(lru);
+    run(lfu);
+    run(rnd);
+    run(weighted);
+    std::cout << "[sharded_concurrent_all_policies] PASS\n";
+}
+
+// ===== Buffered Access Tests =====
+void test_buffered_access_order() {
+    // 读锁下的命中先进入缓冲区,下一次写操作前回放,淘汰顺序与单线程一致
+    ConcurrentCache<int, int, LRUCache<int, int>> lru(3);
+    lru.put(1, 1);
+    lru.put(2, 2);
+    lru.put(3, 3);
+    assert(lru.get(1) == 1);
+    lru.put(4, 4);  // evict key=2
+    assert(lru.contains(1) && !lru.contains(2));
+
+    ConcurrentCache<int, int, LFUCache<int, int>> lfu(2);
+    lfu.put(1, 1);
+    lfu.put(2, 2);
+    lfu.get(1);
+    lfu.get(1);
+    lfu.get(2);
+    lfu.put(3, 3);  // evict key=2
+    assert(lfu.contains(1) && !lfu.contains(2));
+    std::cout << "[buffered_access_order] PASS\n";
+}
+
+void test_buffered_access_concurrent() {
+    auto run = [](auto &cache) {
+        for (int k = 0; k < 64; ++k) cache.put(k, k);
+        std::vector<std::thread> workers;
+        for (int t = 0; t < 8; ++t) {
+            workers.emplace_back([&cache, t]() {
+                for (int i = 0; i < 2000; ++i) {
+                    int k = (i * 7 + t) % 96;
+                    if (t == 0 && i % 4 == 0) {
+                        cache.put(k, k);
+                    } else {
+                        auto v = cache.get(k);
+                        if (v) assert(*v == k);
+                    }
+                }
+            });
+        }
+        for (auto &th: workers) th.join();
+        assert(cache.size() <= 64);
+    };
+    ConcurrentCache<int, int, LRUCache<int, int>> lru(64);
+    ConcurrentCache<int, int, LFUCache<int, int>> lfu(64);
+    run(lru);
+    run(lfu);
+    std::cout << "[buffered_access_concurrent] PASS\n";
+}
+
+// ===== Slab Cache Tests =====
+void test_slab_matches_reference() {
+    // 与基于 std::list 的实现做差分对比
+    LRUCache<int, int> lru(50);
+    SlabLRUCache<int, int> slabLru(50);
+    FIFOCache<int, int> fifo(50);
+    SlabFIFOCache<int, int> slabFifo(50);
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<int> keyDist(0, 199);
+    for (int i = 0; i < 20000; ++i) {
+        int k = keyDist(gen);
+        switch (gen() % 4) {
+            case 0:
+                assert(lru.get(k) == slabLru.get(k));
+                assert(fifo.get(k) == slabFifo.get(k));
+                break;
+            case 1:
+                lru.erase(k);
+                slabLru.erase(k);
+                fifo.erase(k);
+                slabFifo.erase(k);
+                break;
+            default:
+                lru.put(k, i);
+                slabLru.put(k, i);
+                fifo.put(k, i);
+                slabFifo.put(k, i);
+        }
+        assert(lru.size() == slabLru.size() && fifo.size() == slabFifo.size());
+    }
+    for (int k = 0; k < 200; ++k) {
+        assert(lru.contains(k) == slabLru.contains(k));
+        assert(fifo.contains(k) == slabFifo.contains(k));
+    }
+    std::cout << "[slab_matches_reference] PASS\n";
+}
+
+void test_slab_no_steady_state_allocation() {
+    auto churn = [](auto &cache) {
+        for (int i = 0; i < 10000; ++i) {
+            cache.put(i, i);
+            cache.get(i - 64);
+            if (i % 5 == 0) cache.erase(i - 3);
+        }
+    };
+    SlabLRUCache<int, int> slabLru(128);
+    SlabFIFOCache<int, int> slabFifo(128);
+    LRUCache<int, int> lru(128);
+
+    std::size_t before = g_allocations.load();
+    churn(slabLru);
+    churn(slabFifo);
+    assert(g_allocations.load() == before);
+
+    before = g_allocations.load();
+    churn(lru);
+    assert(g_allocations.load() > before);  // 对照组:每次插入都会分配节点
+    std::cout << "[slab_no_steady_state_allocation] PASS\n";
+}
+
+void test_slab_concurrent() {
+    ConcurrentSlabLRUCache<int, int> lru(100);
+    ConcurrentSlabFIFOCache<int, int> fifo(100);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < 8; ++t) {
+        workers.emplace_back([&, t]() {
+            for (int i = 0; i < 1000; ++i) {
+                int k = (t * 1000 + i) % 300;
+                lru.put(k, k);
+                fifo.put(k, k);
+                if (auto v = lru.get(k / 2)) assert(*v == k / 2);
+                if (auto v = fifo.get(k / 2)) assert(*v == k / 2);
+            }
+        });
+    }
+    for (auto &th: workers) th.join();
+    assert(lru.size() == 100 && fifo.size() == 100);
+    std::cout << "[slab_concurrent] PASS\n";
+}
+
+// 复制构造可按需抛出异常的值
+struct ThrowingCopy {
+    static inline bool armed = false;
+    int value = 0;
+
+    explicit ThrowingCopy(int v) : value(v) {}
+
+    ThrowingCopy(const ThrowingCopy &other) : value(other.value) {
+        if (armed) throw std::bad_alloc();
+    }
+
+    ThrowingCopy &operator=(const ThrowingCopy &) = default;
+};
+
+template<typename Cache>
+void check_slab_throwing_value() {
+    Cache cache(4);
+    ThrowingCopy value(1);
+    // 构造失败的插入不占用槽位:失败次数超过容量之后仍能正常插入
+    ThrowingCopy::armed = true;
+    for (int i = 0; i < 10; ++i) {
+        bool thrown = false;
+        try {
+            cache.put(i, value);
+        } catch (const std::bad_alloc &) {
+            thrown = true;
+        }
+        assert(thrown && !cache.contains(i) && cache.size() == 0);
+    }
+    ThrowingCopy::armed = false;
+    for (int i = 0; i < 4; ++i) cache.put(i, value);
+    assert(cache.size() == 4);
+    // 已满时先淘汰最老的条目,随后的构造失败不影响其余条目
+    ThrowingCopy::armed = true;
+    bool thrown = false;
+    try {
+        cache.put(100, value);
+    } catch (const std::bad_alloc &) {
+        thrown = true;
+    }
+    ThrowingCopy::armed = false;
+    assert(thrown && !cache.contains(100) && cache.size() == 3);
+    for (int i = 200; i < 220; ++i) cache.put(i, value);
+    assert(cache.size() == 4 && cache.contains(219) && cache.get(219)->value == 1);
+}
+
+void test_slab_throwing_value() {
+    check_slab_throwing_value<SlabLRUCache<int, ThrowingCopy>>();
+    check_slab_throwing_value<SlabFIFOCache<int, ThrowingCopy>>();
+    std::cout << "[slab_throwing_value] PASS\n";
+}
+
+// ===== Flat Hash Map Tests =====
+template<typename Map>
+void check_flat_map_against_std() {
+    Map flat;
+    std::unordered_map<std::string, int> ref;
+    std::mt19937 gen(7);
+    std::uniform_int_distribution<int> keyDist(0, 999);
+    for (int i = 0; i < 50000; ++i) {
+        std::string k = "key-" + std::to_string(keyDist(gen));
+        switch (gen() % 3) {
+            case 0:
+                flat[k] = i;
+                ref[k] = i;
+                break;
+            case 1:
+                assert(flat.erase(k) == ref.erase(k));
+                break;
+            default: {
+                auto it = flat.find(k);
+                auto rit = ref.find(k);
+                assert((it == flat.end()) == (rit == ref.end()));
+                if (it != flat.end()) assert(it->second == rit->second);
+            }
+        }
+        assert(flat.size() == ref.size());
+    }
+    std::size_t visited = 0;
+    for (const auto &kv: flat) {
+        assert(ref.at(kv.first) == kv.second);
+        ++visited;
+    }
+    assert(visited == ref.size());
+    // 迭代中删除
+    for (auto it = flat.begin(); it != flat.end();) {
+        if (it->second % 2 == 0) it = flat.erase(it);
+        else ++it;
+    }
+    for (const auto &kv: flat) assert(kv.second % 2 != 0);
+}
+
+void test_flat_hash_map() {
+    check_flat_map_against_std<FlatHashMap<std::string, int>>();
+    check_flat_map_against_std<FlatHashMap<std::string, int, std::hash<std::string>,
+            std::equal_to<std::string>, FlatGroupPortable>>();
+    // 整数 key + 大量墓碑:插入删除交替,容量不应无限增长
+    FlatHashMap<int, int> churn;
+    for (int i = 0; i < 100000; ++i) {
+        churn.try_emplace(i, i);
+        if (i >= 100) churn.erase(i - 100);
+    }
+    assert(churn.size() == 100 && churn.capacity() <= 1024);
+    std::cout << "[flat_hash_map] PASS\n";
+}
+
+void test_flat_index_policies() {
+    // 相同操作序列下,两种索引容器的可观察行为一致
+    auto diff = [](auto &a, auto &b, auto makeValue) {
+        std::mt19937 gen(3);
+        for (int i = 0; i < 20000; ++i) {
+            int k = static_cast<int>(gen() % 300);
+            switch (gen() % 4) {
+                case 0:
+                    assert(a.get(k) == b.get(k));
+                    break;
+                case 1:
+                    a.erase(k);
+                    b.erase(k);
+                    break;
+                default:
+                    a.put(k, makeValue(i));
+                    b.put(k, makeValue(i));
+            }
+            assert(a.size() == b.size());
+        }
+    };
+    auto intValue = [](int i) { return i; };
+    FIFOCache<int, int> fifo(100);
+    FIFOCache<int, int, FlatHashIndex> flatFifo(100);
+    diff(fifo, flatFifo, intValue);
+    LRUCache<int, int> lru(100);
+    LRUCache<int, int, FlatHashIndex> flatLru(100);
+    diff(lru, flatLru, intValue);
+    LFUCache<int, int> lfu(100);
+    LFUCache<int, int, FlatHashIndex> flatLfu(100);
+    diff(lfu, flatLfu, intValue);
+    WeightedCache<int, std::pair<int, int>> weighted(100);
+    WeightedCache<int, std::pair<int, int>, FlatHashIndex> flatWeighted(100);
+    diff(weighted, flatWeighted, [](int i) { return std::make_pair(i, i % 1000); });
+
+    RandomReplacementCache<int, int, FlatHashIndex> rnd(100);
+    for (int i = 0; i < 10000; ++i) {
+        if (i % 3 == 0) rnd.erase((i * 7) % 500);
+        rnd.put(i % 500, i);
+        assert(rnd.size() <= 100 && rnd.get(i % 500) == i);
+    }
+    ConcurrentCache<int, int, LRUCache<int, int, FlatHashIndex>> concurrent(64);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < 4; ++t) {
+        workers.emplace_back([&concurrent, t]() {
+            for (int i = 0; i < 2000; ++i) {
+                concurrent.put((t * 2000 + i) % 200, i);
+                concurrent.get(i % 200);
+            }
+        });
+    }
+    for (auto &th: workers) th.join();
+    assert(concurrent.size() == 64);
+    std::cout << "[flat_index_policies] PASS\n";
+}
+
+// ===== TinyLFU Cache Tests =====
+void test_tinylfu_basic() {
+    TinyLFUCache<int, int> cache(100);
+    for (int i = 0; i < 100; ++i) cache.put(i, i);
+    assert(cache.size() == 100);
+    for (int i = 0; i < 100; ++i) assert(cache.get(i) == i);
+    cache.put(5, 50);
+    assert(cache.get(5) == 50);
+    cache.erase(5);
+    assert(!cache.contains(5));
+    for (int i = 100; i < 1000; ++i) {
+        cache.put(i, i);
+        assert(cache.size() <= 100);
+    }
+    TinyLFUCache<int, int> single(1);
+    single.put(1, 1);
+    single.put(2, 2);
+    assert(single.size() == 1 && single.contains(2));
+    std::cout << "[tinylfu_basic] PASS\n";
+}
+
+// Zipf 分布的热点流量与一次性扫描交替出现,按 cache-aside 方式访问,返回命中率
+template<typename CacheT>
+double zipf_scan_hit_ratio(CacheT &cache) {
+    const int universe = 5000;
+    std::vector<double> weights(universe);
+    for (int i = 0; i < universe; ++i) weights[i] = 1.0 / (i + 1);
+    std::discrete_distribution<int> zipf(weights.begin(), weights.end());
+    std::mt19937 gen(2024);
+    int scanKey = 1000000;
+    std::size_t hits = 0, lookups = 0;
+    for (int round = 0; round < 50; ++round) {
+        for (int i = 0; i < 2000; ++i) {
+            int k = zipf(gen);
+            ++lookups;
+            if (cache.get(k)) ++hits;
+            else cache.put(k, k);
+        }
+        for (int i = 0; i < 1000; ++i) {
+            int k = scanKey++;
+            if (!cache.get(k)) cache.put(k, k);
+        }
+    }
+    return static_cast<double>(hits) / static_cast<double>(lookups);
+}
+
+void test_tinylfu_scan_resistance() {
+    LRUCache<int, int> lru(200);
+    TinyLFUCache<int, int> tiny(200);
+    double lruRatio = zipf_scan_hit_ratio(lru);
+    double tinyRatio = zipf_scan_hit_ratio(tiny);
+    assert(tinyRatio > lruRatio + 0.05);
+    std::cout << "[tinylfu_scan_resistance] PASS (lru=" << lruRatio << ", tinylfu=" << tinyRatio << ")\n";
+}
+
+void test_tinylfu_concurrent() {
+    ConcurrentTinyLFUCache<int, int> cache(100);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < 8; ++t) {
+        workers.emplace_back([&cache, t]() {
+            for (int i = 0; i < 2000; ++i) {
+                int k = (i * (t + 1)) % 400;
+                if (auto v = cache.get(k)) assert(*v == k);
+                else cache.put(k, k);
+            }
+        });
+    }
+    for (auto &th: workers) th.join();
+    assert(cache.size() <= 100);
+    std::cout << "[tinylfu_concurrent] PASS\n";
+}
+
+// ===== ARC Cache Tests =====
+void test_arc_basic() {
+    ARCCache<int, int> cache(4);
+    for (int i = 1; i <= 4; ++i) cache.put(i, i);
+    assert(cache.get(2) == 2);  // 2 晋升到 T2
+    cache.put(5, 5);            // T1 的 LRU(key=1)被淘汰到 B1
+    assert(!cache.contains(1) && cache.contains(2) && cache.size() == 4);
+    assert(cache.target() == 0);
+    cache.put(1, 10);           // 幽灵命中 B1:p 增大,key=1 直接进入 T2
+    assert(cache.target() > 0);
+    assert(cache.get(1) == 10 && cache.size() == 4);
+    cache.erase(1);
+    assert(!cache.contains(1) && cache.size() == 3);
+    for (int i = 100; i < 1000; ++i) {
+        cache.put(i, i);
+        if (i % 3 == 0) cache.get(i - 1);
+        assert(cache.size() <= 4);
+    }
+    std::cout << "[arc_basic] PASS\n";
+}
+
+void test_arc_adapts() {
+    // 频率型流量中间夹杂扫描:ARC 应至少与 LRU 一样好
+    LRUCache<int, int> lru(200);
+    ARCCache<int, int> arc(200);
+    double lruRatio = zipf_scan_hit_ratio(lru);
+    double arcRatio = zipf_scan_hit_ratio(arc);
+    assert(arcRatio > lruRatio);
+    std::cout << "[arc_adapts] PASS (lru=" << lruRatio << ", arc=" << arcRatio << ")\n";
+}
+
+void test_arc_concurrent() {
+    ConcurrentARCCache<int, int> cache(64);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < 8; ++t) {
+        workers.emplace_back([&cache, t]() {
+            for (int i = 0; i < 2000; ++i) {
+                int k = (i * (t + 3)) % 256;
+                if (auto v = cache.get(k)) assert(*v == k);
+                else cache.put(k, k);
+            }
+        });
+    }
+    for (auto &th: workers) th.join();
+    assert(cache.size() <= 64);
+    std::cout << "[arc_concurrent] PASS\n";
+}
+
+// ===== S3-FIFO / SIEVE Cache Tests =====
+void test_sieve_basic() {
+    SIEVECache<int, int> cache(3);
+    cache.put(1, 1);
+    cache.put(2, 2);
+    cache.put(3, 3);
+    assert(cache.get(1) == 1);
+    cache.put(4, 4);  // 指针从队尾出发:1 已访问被跳过,淘汰 2
+    assert(cache.contains(1) && !cache.contains(2) && cache.contains(3));
+    cache.put(5, 5);  // 指针停在 3:未访问,淘汰 3
+    assert(!cache.contains(3) && cache.contains(1));
+    cache.erase(4);
+    assert(cache.size() == 2);
+    for (int i = 10; i < 1000; ++i) {
+        cache.put(i, i);
+        if (i % 2 == 0) cache.get(i - 1);
+        if (i % 7 == 0) cache.erase(i - 2);
+        assert(cache.size() <= 3);
+    }
+    std::cout << "[sieve_basic] PASS\n";
+}
+
+void test_s3fifo_basic() {
+    S3FIFOCache<int, int> cache(10);  // small = 1, main = 9
+    for (int i = 1; i <= 10; ++i) cache.put(i, i);
+    cache.put(11, 11);  // 已满:1 未被访问,从 small 淘汰并记入 ghost
+    assert(!cache.contains(1) && cache.contains(2));
+    cache.put(1, 1);    // 命中 ghost,直接进入 main
+    for (int i = 100; i < 130; ++i) cache.put(i, i);
+    assert(cache.contains(1));  // main 中的元素不受 small 中一次性 key 的冲刷
+    assert(cache.get(1) == 1);
+    cache.erase(1);
+    assert(!cache.contains(1));
+    for (int i = 0; i < 5000; ++i) {
+        cache.put(i % 97, i);
+        cache.get(i % 13);
+        if (i % 11 == 0) cache.erase(i % 97);
+        assert(cache.size() <= 10);
+    }
+    std::cout << "[s3fifo_basic] PASS\n";
+}
+
+void test_fifo_family_hit_ratio() {
+    LRUCache<int, int> lru(200);
+    S3FIFOCache<int, int> s3fifo(200);
+    SIEVECache<int, int> sieve(200);
+    double lruRatio = zipf_scan_hit_ratio(lru);
+    double s3fifoRatio = zipf_scan_hit_ratio(s3fifo);
+    double sieveRatio = zipf_scan_hit_ratio(sieve);
+    assert(s3fifoRatio > lruRatio && sieveRatio > lruRatio);
+    std::cout << "[fifo_family_hit_ratio] PASS (lru=" << lruRatio << ", s3fifo=" << s3fifoRatio
+              << ", sieve=" << sieveRatio << ")\n";
+}
+
+void test_fifo_family_concurrent() {
+    auto run = [](auto &cache) {
+        std::vector<std::thread> workers;
+        for (int t = 0; t < 8; ++t) {
+            workers.emplace_back([&cache, t]() {
+                for (int i = 0; i < 3000; ++i) {
+                    int k = (i * (t + 1)) % 300;
+                    if (auto v = cache.get(k)) assert(*v == k);
+                    else cache.put(k, k);
+                }
+            });
+        }
+        for (auto &th: workers) th.join();
+        assert(cache.size() <= 100);
+    };
+    ConcurrentS3FIFOCache<int, int> s3fifo(100);
+    ConcurrentSIEVECache<int, int> sieve(100);
+    run(s3fifo);
+    run(sieve);
+    std::cout << "[fifo_family_concurrent] PASS\n";
+}
+
+// ===== Byte-budget (Sizer) Tests =====
+struct StringBytesSizer {
+    std::size_t operator()(const int &, const std::string &value) const noexcept {
+        return sizeof(int) + value.size();
+    }
+};
+
+template<template<typename, typename, typename, typename> class Policy>
+void check_byte_budget() {
+    const std::size_t budget = 1000;
+    Policy<int, std::string, StdHashIndex, StringBytesSizer> cache(budget);
+    std::mt19937 gen(11);
+    for (int i = 0; i < 5000; ++i) {
+        int k = static_cast<int>(gen() % 200);
+        if (gen() % 5 == 0) {
+            cache.erase(k);
+        } else {
+            cache.put(k, std::string(gen() % 120, 'x'));
+        }
+        assert(cache.totalCharge() <= budget);
+    }
+    // 与逐个条目重新计算的结果一致
+    std::size_t sum = 0;
+    for (int k = 0; k < 200; ++k)
+        if (auto v = cache.get(k)) sum += StringBytesSizer{}(k, *v);
+    assert(sum == cache.totalCharge());
+    // 超出整个预算的对象被拒绝,并丢弃同 key 的旧值
+    cache.put(-1, "small");
+    cache.put(-1, std::string(budget, 'y'));
+    assert(!cache.contains(-1));
+    // 大对象挤出多个小对象
+    cache.put(-2, std::string(budget - sizeof(int), 'z'));
+    assert(cache.contains(-2) && cache.size() == 1 && cache.totalCharge() == budget);
+}
+
+void test_byte_budget() {
+    check_byte_budget<FIFOCache>();
+    check_byte_budget<LRUCache>();
+    check_byte_budget<LFUCache>();
+    check_byte_budget<RandomReplacementCache>();
+
+    // 默认 UnitSizer:计费即条目数
+    LRUCache<int, int> unit(3);
+    for (int i = 0; i < 10; ++i) unit.put(i, i);
+    assert(unit.totalCharge() == 3 && unit.size() == 3);
+
+    ConcurrentCache<int, std::string, LRUCache<int, std::string, StdHashIndex, StringBytesSizer>> concurrent(4096);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < 4; ++t) {
+        workers.emplace_back([&concurrent, t]() {
+            for (int i = 0; i < 2000; ++i) concurrent.put(t * 2000 + i, std::string(i % 64, 'v'));
+        });
+    }
+    for (auto &th: workers) th.join();
+    assert(concurrent.totalCharge() <= 4096);
+    ShardedConcurrentCache<int, std::string, FIFOCache<int, std::string, StdHashIndex, StringBytesSizer>> sharded(4096, 4);
+    for (int i = 0; i < 2000; ++i) sharded.put(i, std::string(i % 64, 'v'));
+    assert(sharded.totalCharge() <= 4096);
+    std::cout << "[byte_budget] PASS\n";
+}
+
+void test_timer_wheel() {
+    TimerWheel<int> wheel(0);
+    std::mt19937_64 gen(7);
+    std::unordered_map<int, std::int64_t> deadlines;
+    // 跨越所有层级(1ms ~ 数天)的到期时间
+    for (int k = 0; k < 5000; ++k) {
+        std::int64_t d = static_cast<std::int64_t>(gen() % (std::int64_t{1} << (20 + gen() % 30)));
+        deadlines[k] = d;
+        wheel.schedule(k, d);
+    }
+    // 一部分取消、一部分重新调度
+    for (int k = 0; k < 5000; k += 7) {
+        wheel.cancel(k);
+        deadlines.erase(k);
+    }
+    for (int k = 3; k < 5000; k += 11) {
+        if (!deadlines.count(k)) continue;
+        deadlines[k] += 12345678;
+        wheel.schedule(k, deadlines[k]);
+    }
+    assert(wheel.size() == deadlines.size());
+    std::int64_t now = 0;
+    while (!deadlines.empty()) {
+        now += static_cast<std::int64_t>(gen() % (std::int64_t{1} << (10 + gen() % 40)));
+        wheel.advance(now, [&](int key) {
+            // 回调不早于到期时间
+            assert(deadlines.count(key) && deadlines[key] <= now);
+            deadlines.erase(key);
+        });
+        // 推进后剩余的定时器最多延迟一个最细的槽(2^20 ns)
+        for (const auto &[key, d]: deadlines) assert(d > now - (std::int64_t{1} << 20));
+        assert(wheel.size() == deadlines.size());
+    }
+    std::cout << "[timer_wheel] PASS\n";
+}
+
+// 手动推进的时钟,用于确定性地测试 TTL
+struct ManualClock {
+    using rep = std::int64_t;
+    using period = std::nano;
+    using duration = std::chrono::nanoseconds;
+    using time_point = std::chrono::time_point<ManualClock>;
+    static constexpr bool is_steady = true;
+    static inline std::atomic<rep> ticks{0};
+
+    static time_point now() noexcept { return time_point(duration(ticks.load())); }
+
+    static void advance(duration d) { ticks.fetch_add(d.count()); }
+};
+
+template<typename Policy>
+void check_expiring_policy() {
+    using namespace std::chrono_literals;
+    ExpiringCache<int, int, Policy, ManualClock> cache(100, 10s);
+    cache.put(1, 1);             // 默认 TTL 10s
+    cache.put(2, 2, 1s);
+    cache.put(3, 3, 0s);         // 永不过期
+    assert(cache.get(2) == 2 && cache.contains(2));
+    ManualClock::advance(1s);
+    // 过期后立即不可见,但在清理前仍占用底层策略
+    assert(!cache.get(2) && !cache.contains(2) && cache.size() == 3);
+    cache.cleanUp();
+    assert(cache.size() == 2);
+    // 更新会重设 TTL
+    ManualClock::advance(8s);
+    cache.put(1, 10, 5s);
+    ManualClock::advance(3s);
+    assert(cache.get(1) == 10);
+    ManualClock::advance(2s);
+    assert(!cache.get(1));
+    // put 时顺带清理
+    cache.put(4, 4);
+    assert(!cache.contains(1) && cache.size() == 2);
+    ManualClock::advance(std::chrono::hours(24 * 30));
+    assert(cache.get(3) == 3 && !cache.expiration(3));
+    cache.erase(3);
+    cache.cleanUp();
+    assert(cache.size() == 0);
+    // 被淘汰的条目同时取消登记:大量不同的 key 以长 TTL 写入后,时间轮不超过容量
+    for (int i = 0; i < 20000; ++i) {
+        cache.put(1000 + i, i, std::chrono::hours(1));
+        assert(cache.timerCount() <= cache.size() && cache.size() <= 100);
+    }
+}
+
+void test_expiring_basic() {
+    check_expiring_policy<FIFOCache<int, int>>();
+    check_expiring_policy<LRUCache<int, int>>();
+    check_expiring_policy<LFUCache<int, int>>();
+    check_expiring_policy<RandomReplacementCache<int, int>>();
+    check_expiring_policy<TinyLFUCache<int, int>>();
+    check_expiring_policy<ARCCache<int, int>>();
+    check_expiring_policy<S3FIFOCache<int, int>>();
+    check_expiring_policy<SIEVECache<int, int>>();
+    check_expiring_policy<SlabLRUCache<int, int>>();
+
+    // 大量条目按不同 TTL 到期,cleanUp 恰好删除已过期的部分
+    using namespace std::chrono_literals;
+    ExpiringCache<int, int, LRUCache<int, int>, ManualClock> cache(10000);
+    for (int i = 0; i < 10000; ++i) cache.put(i, i, std::chrono::milliseconds(10 * (i + 1)));
+    ManualClock::advance(std::chrono::milliseconds(10 * 5000));
+    cache.cleanUp();
+    assert(cache.size() == 5000 && !cache.contains(4999) && cache.contains(5000));
+
+    // 超过整个预算而被拒绝的条目不留下登记;调用方的批次照常收到移除的条目
+    struct ValueSizer {
+        std::size_t operator()(const int &, const int &value) const { return static_cast<std::size_t>(value); }
+    };
+    ExpiringCache<int, int, LRUCache<int, int, StdHashIndex, ValueSizer>, ManualClock> budget(10, 1h);
+    RemovalBatch<int, int> removed;
+    budget.collectRemovals(&removed);
+    budget.put(1, 4);
+    budget.put(2, 50);
+    assert(!budget.contains(2) && budget.timerCount() == 1);
+    budget.put(3, 8);
+    assert(!budget.contains(1) && budget.timerCount() == 1);
+    assert(removed.size() == 2 && removed[0].key == 2 && removed[1].key == 1);
+    assert(removed[1].cause == RemovalCause::Capacity);
+    ManualClock::advance(1h);
+    budget.cleanUp();
+    assert(budget.size() == 0 && budget.timerCount() == 0);
+    assert(removed.size() == 3 && removed[2].key == 3 && removed[2].cause == RemovalCause::Expired);
+    std::cout << "[expiring_basic] PASS\n";
+}
+
+void test_expiring_concurrent() {
+    using namespace std::chrono_literals;
+    ConcurrentCache<int, int, ExpiringCache<int, int, LRUCache<int, int>, ManualClock>> cache(1000, 1h);
+    ShardedConcurrentCache<int, int, ExpiringCache<int, int, S3FIFOCache<int, int>, ManualClock>> sharded(1000, 4, 1h);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < 4; ++t) {
+        workers.emplace_back([&, t]() {
+            for (int i = 0; i < 2000; ++i) {
+                int key = (t * 2000 + i) % 1500;
+                if (i % 3 == 0) {
+                    cache.put(key, i, std::chrono::milliseconds(i + 1));
+                    sharded.put(key, i, std::chrono::milliseconds(i + 1));
+                } else {
+                    cache.put(key, i);
+                    sharded.put(key, i);
+                }
+                cache.get(key);
+                sharded.get(key);
+                if (i % 100 == 0) {
+                    ManualClock::advance(5ms);
+                    cache.cleanUp();
+                    sharded.cleanUp();
+                }
+            }
+        });
+    }
+    for (auto &th: workers) th.join();
+    ManualClock::advance(2h);
+    cache.cleanUp();
+    sharded.cleanUp();
+    assert(cache.size() == 0 && sharded.size() == 0);
+    std::cout << "[expiring_concurrent] PASS\n";
+}
+
+// 统计复制次数的值
+struct CopyCounted {
+    static inline int copies = 0;
+    int value = 0;
+
+    CopyCounted() = default;
+
+    explicit CopyCounted(int v) : value(v) {}
+
+    CopyCounted(const CopyCounted &other) : value(other.value) { ++copies; }
+
+    CopyCounted(CopyCounted &&other) noexcept = default;
+
+    CopyCounted &operator=(const CopyCounted &other) {
+        value = other.value;
+        ++copies;
+        return *this;
+    }
+
+    CopyCounted &operator=(CopyCounted &&other) noexcept = default;
+};
+
+template<typename CacheT>
+void check_batch_ops(CacheT &cache) {
+    std::vector<std::pair<int, int>> entries;
+    for (int i = 0; i < 100; ++i) entries.emplace_back(i, i * 10);
+    entries.emplace_back(5, -5);  // 同一 key 的后一次写入生效
+    cache.putMany(entries);
+    std::vector<int> keys;
+    for (int i = 0; i < 150; ++i) keys.push_back((i * 37) % 150);
+    auto values = cache.getMany(keys);
+    assert(values.size() == keys.size());
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+        int k = keys[i];
+        if (k >= 100) assert(!values[i]);
+        else assert(values[i] == (k == 5 ? -5 : k * 10));
+    }
+    std::vector<int> doomed = {1, 3, 5, 200};
+    cache.eraseMany(doomed);
+    assert(cache.size() == 97 && !cache.contains(3) && cache.contains(4));
+    assert(cache.getMany(std::span<const int>()).empty());
+}
+
+void test_batch_ops() {
+    {
+        LRUCache<int, int> c(128);
+        check_batch_ops(c);
+    }
+    {
+        FIFOCache<int, int, FlatHashIndex> c(128);
+        check_batch_ops(c);
+    }
+    {
+        SlabLRUCache<int, int> c(128);
+        check_batch_ops(c);
+    }
+    {
+        ARCCache<int, int, FlatHashIndex> c(128);
+        check_batch_ops(c);
+    }
+    {
+        ConcurrentLRUCache<int, int> c(128);
+        check_batch_ops(c);
+    }
+    {
+        ConcurrentS3FIFOCache<int, int> c(128);
+        check_batch_ops(c);
+    }
+    {
+        ShardedConcurrentCache<int, int, LRUCache<int, int, FlatHashIndex>> c(1024, 8);
+        check_batch_ops(c);
+    }
+
+    // 批量命中同样会被记录到访问顺序中
+    ConcurrentLRUCache<int, int> lru(3);
+    std::vector<std::pair<int, int>> init = {{1, 1}, {2, 2}, {3, 3}};
+    lru.putMany(init);
+    std::vector<int> hot = {1};
+    lru.getMany(hot);
+    lru.put(4, 4);
+    assert(lru.contains(1) && !lru.contains(2));
+
+    ShardedConcurrentCache<int, int, LRUCache<int, int>> sharded(4096, 8);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < 4; ++t) {
+        workers.emplace_back([&sharded, t]() {
+            std::vector<std::pair<int, int>> batch;
+            std::vector<int> keys;
+            for (int round = 0; round < 200; ++round) {
+                batch.clear();
+                keys.clear();
+                for (int i = 0; i < 64; ++i) {
+                    int k = (t * 131 + round * 17 + i) % 2048;
+                    batch.emplace_back(k, k);
+                    keys.push_back(k);
+                }
+                sharded.putMany(batch);
+                for (const auto &v: sharded.getMany(keys)) assert(!v || *v >= 0);
+                if (round % 10 == 0) sharded.eraseMany(keys);
+            }
+        });
+    }
+    for (auto &th: workers) th.join();
+    assert(sharded.size() <= 4096);
+
+    // 分片批量写入按下标分派,不为分组额外复制条目:复制次数与不分片时相同
+    std::vector<std::pair<int, CopyCounted>> counted;
+    for (int i = 0; i < 256; ++i) counted.emplace_back(i, CopyCounted{i});
+    ConcurrentCache<int, CopyCounted, LRUCache<int, CopyCounted>> single(1024);
+    CopyCounted::copies = 0;
+    single.putMany(counted);
+    int singleCopies = CopyCounted::copies;
+    ShardedConcurrentCache<int, CopyCounted, LRUCache<int, CopyCounted>> split(1024, 8);
+    CopyCounted::copies = 0;
+    split.putMany(counted);
+    assert(CopyCounted::copies == singleCopies && split.size() == 256);
+    std::vector<int> countedKeys = {3, 300, 17, 255};
+    auto found = split.getMany(countedKeys);
+    assert(found[0]->value == 3 && !found[1] && found[2]->value == 17 && found[3]->value == 255);
+    std::cout << "[batch_ops] PASS\n";
+}
+
+static std::string long_key(int i) {
+    return std::string(300, 'k') + std::to_string(i);
+}
+
+template<typename CacheT>
+void check_heterogeneous_lookup(CacheT &cache) {
+    for (int i = 0; i < 8; ++i) cache.put(long_key(i), i);
+    std::vector<std::string> probes;
+    for (int i = 0; i < 10; ++i) probes.push_back(long_key(i));
+    // 预热:并发装饰器的访问缓冲区槽位第一次使用时需要构造 key
+    for (int round = 0; round < 40; ++round)
+        for (int i = 0; i < 8; ++i) cache.get(std::string_view(probes[i]));
+    // 查找过程中不构造任何长 key(LFU 提升频率时的链表节点分配与 key 无关)
+    std::size_t before = g_large_allocations.load();
+    for (int i = 0; i < 10; ++i) {
+        std::string_view view(probes[i]);
+        auto v = cache.get(view);
+        assert(i < 8 ? v == i : !v);
+        assert(cache.contains(view) == (i < 8));
+    }
+    cache.erase(std::string_view(probes[9]));  // 不存在
+    assert(g_large_allocations.load() == before);
+    cache.erase(std::string_view(probes[0]));
+    assert(!cache.contains(std::string_view(probes[0])) && cache.size() == 7);
+    // const char* 同样可以直接查找
+    cache.put("short", 42);
+    assert(cache.get("short") == 42 && cache.contains("short"));
+    cache.erase("short");
+    assert(!cache.contains("short"));
+}
+
+void test_heterogeneous_lookup() {
+    {
+        FIFOCache<std::string, int> c(16);
+        check_heterogeneous_lookup(c);
+    }
+    {
+        LRUCache<std::string, int, FlatHashIndex> c(16);
+        check_heterogeneous_lookup(c);
+    }
+    {
+        LFUCache<std::string, int> c(16);
+        check_heterogeneous_lookup(c);
+    }
+    {
+        RandomReplacementCache<std::string, int, FlatHashIndex> c(16);
+        check_heterogeneous_lookup(c);
+    }
+    {
+        TinyLFUCache<std::string, int> c(16);
+        check_heterogeneous_lookup(c);
+    }
+    {
+        ARCCache<std::string, int> c(16);
+        check_heterogeneous_lookup(c);
+    }
+    {
+        S3FIFOCache<std::string, int> c(16);
+        check_heterogeneous_lookup(c);
+    }
+    {
+        SIEVECache<std::string, int> c(16);
+        check_heterogeneous_lookup(c);
+    }
+    {
+        SlabLRUCache<std::string, int> c(16);
+        check_heterogeneous_lookup(c);
+    }
+    {
+        SlabFIFOCache<std::string, int> c(16);
+        check_heterogeneous_lookup(c);
+    }
+    {
+        ExpiringCache<std::string, int, LRUCache<std::string, int>> c(16, std::chrono::hours(1));
+        check_heterogeneous_lookup(c);
+    }
+    {
+        ConcurrentLRUCache<std::string, int> c(16);
+        check_heterogeneous_lookup(c);
+    }
+    {
+        ConcurrentSIEVECache<std::string, int> c(16);
+        check_heterogeneous_lookup(c);
+    }
+    {
+        ShardedConcurrentCache<std::string, int, LFUCache<std::string, int>> c(64, 4);
+        check_heterogeneous_lookup(c);
+    }
+    WeightedCache<std::string, std::pair<int, int>> weighted(4);
+    weighted.put(long_key(1), {1, 1});
+    assert(weighted.get(std::string_view(long_key(1)))->first == 1);
+    weighted.erase(std::string_view(long_key(1)));
+    assert(!weighted.contains(std::string_view(long_key(1))));
+    std::cout << "[heterogeneous_lookup] PASS\n";
+}
+
+// 次级结构只引用索引中的 key:插入一个长 key 只复制一次
+template<typename CacheT>
+std::size_t long_key_copies_per_insert() {
+    CacheT cache(64);
+    std::vector<std::string> keys;
+    for (int i = 0; i < 200; ++i) keys.push_back(long_key(i));
+    std::size_t before = g_large_allocations.load();
+    for (const auto &key: keys) cache.put(key, 1);  // 过程中持续淘汰
+    return (g_large_allocations.load() - before) / keys.size();
+}
+
+void test_key_copies() {
+    assert((long_key_copies_per_insert<FIFOCache<std::string, int>>()) == 1);
+    assert((long_key_copies_per_insert<LFUCache<std::string, int>>()) == 1);
+    assert((long_key_copies_per_insert<RandomReplacementCache<std::string, int>>()) == 1);
+    // FlatHashIndex 会在重哈希时移动 key,次级结构只能保存副本
+    assert((long_key_copies_per_insert<FIFOCache<std::string, int, FlatHashIndex>>()) == 2);
+    std::cout << "[key_copies] PASS\n";
+}
+
+// 记录复制次数的值类型;移动不计数
+struct Tracked {
+    static inline int copies = 0;
+    static inline int constructions = 0;
+    int value = 0;
+
+    explicit Tracked(int v = 0) : value(v) { ++constructions; }
+    Tracked(const Tracked &other) : value(other.value) { ++copies; }
+    Tracked(Tracked &&other) noexcept : value(other.value) {}
+    Tracked &operator=(const Tracked &other) {
+        value = other.value;
+        ++copies;
+        return *this;
+    }
+    Tracked &operator=(Tracked &&other) noexcept {
+        value = other.value;
+        return *this;
+    }
+};
+
+template<typename CacheT>
+void check_move_and_visit(CacheT &cache) {
+    Tracked::copies = 0;
+    // 插入与更新(含淘汰)都只移动
+    for (int i = 0; i < 40; ++i) cache.put(long_key(i), Tracked(i));
+    for (int i = 30; i < 40; ++i) {
+        std::string key = long_key(i);
+        Tracked value(i * 10);
+        cache.put(std::move(key), std::move(value));
+    }
+    for (int i = 40; i < 50; ++i) cache.emplace(long_key(i), i);
+    assert(Tracked::copies == 0);
+    // visit 不复制值,get 复制一次;最后插入的 key 一定还在,更早的 key 取决于策略
+    int sum = 0;
+    bool present = cache.contains(long_key(35));
+    assert(cache.visit(long_key(35), [&sum](const Tracked &t) { sum += t.value; }) == present);
+    assert(sum == (present ? 350 : 0));
+    assert(cache.visit(long_key(49), [&sum](const Tracked &t) { sum += t.value; }));
+    assert(sum == (present ? 399 : 49));
+    assert(!cache.visit(long_key(100), [](const Tracked &) { assert(false); }));
+    assert(Tracked::copies == 0);
+    assert(cache.get(long_key(49))->value == 49 && Tracked::copies == 1);
+    // try_emplace:已存在时不构造值
+    int constructions = Tracked::constructions;
+    assert(!cache.try_emplace(long_key(49), 0));
+    assert(Tracked::constructions == constructions);
+    assert(cache.get(long_key(49))->value == 49);
+    assert(cache.try_emplace(long_key(200), 7));
+    assert(cache.get(long_key(200))->value == 7);
+}
+
+void test_move_and_visit() {
+    {
+        FIFOCache<std::string, Tracked> c(16);
+        check_move_and_visit(c);
+        // 移入的 key 不再复制:插入长 key 不产生分配
+        std::vector<std::string> keys;
+        for (int i = 0; i < 20; ++i) keys.push_back(long_key(300 + i));
+        std::size_t before = g_large_allocations.load();
+        for (int i = 0; i < 20; ++i) c.put(std::move(keys[i]), Tracked(i));
+        assert(g_large_allocations.load() == before);
+    }
+    {
+        LRUCache<std::string, Tracked, FlatHashIndex> c(16);
+        check_move_and_visit(c);
+    }
+    {
+        LFUCache<std::string, Tracked> c(16);
+        check_move_and_visit(c);
+    }
+    {
+        RandomReplacementCache<std::string, Tracked> c(16);
+        check_move_and_visit(c);
+    }
+    {
+        TinyLFUCache<std::string, Tracked> c(16);
+        check_move_and_visit(c);
+    }
+    {
+        ARCCache<std::string, Tracked> c(16);
+        check_move_and_visit(c);
+    }
+    {
+        S3FIFOCache<std::string, Tracked> c(16);
+        check_move_and_visit(c);
+    }
+    {
+        SIEVECache<std::string, Tracked> c(16);
+        check_move_and_visit(c);
+    }
+    {
+        SlabLRUCache<std::string, Tracked> c(16);
+        check_move_and_visit(c);
+    }
+    {
+        SlabFIFOCache<std::string, Tracked> c(16);
+        check_move_and_visit(c);
+    }
+    {
+        ExpiringCache<std::string, Tracked, LRUCache<std::string, Tracked>> c(16, std::chrono::hours(1));
+        check_move_and_visit(c);
+    }
+    {
+        ConcurrentLRUCache<std::string, Tracked> c(16);
+        check_move_and_visit(c);
+    }
+    {
+        ConcurrentFIFOCache<std::string, Tracked> c(16);
+        check_move_and_visit(c);
+    }
+    {
+        ShardedConcurrentCache<std::string, Tracked, LFUCache<std::string, Tracked>> c(64, 4);
+        check_move_and_visit(c);
+    }
+    WeightedCache<int, std::pair<Tracked, int>> weighted(4);
+    Tracked::copies = 0;
+    for (int i = 0; i < 8; ++i) weighted.emplace(i, Tracked(i), i);
+    weighted.emplace(7, Tracked(70), 7);  // 同一 key,只替换值
+    assert(Tracked::copies == 0);
+    assert(weighted.visit(7, [](const std::pair<Tracked, int> &e) { assert(e.first.value == 70); }));
+    assert(Tracked::copies == 0);
+    std::cout << "[move_and_visit] PASS\n";
+}
+
+// 并发 visit 与写入交错:visitor 看到的值总是完整的
+template<typename CacheT>
+void check_concurrent_visit(CacheT &cache) {
+    std::atomic<int> hits{0};
+    std::vector<std::thread> workers;
+    for (int t = 0; t < 4; ++t) {
+        workers.emplace_back([&cache, &hits, t] {
+            for (int i = 0; i < 2000; ++i) {
+                int key = (i * 7 + t) % 64;  // 工作集小于容量,保证有命中
+                if (t % 2 == 0) {
+                    cache.emplace(key, std::to_string(key) + std::string(64, 'v'));
+                } else {
+                    cache.visit(key, [&hits, key](const std::string &value) {
+                        assert(value == std::to_string(key) + std::string(64, 'v'));
+                        hits.fetch_add(1, std::memory_order_relaxed);
+                    });
+                    cache.try_emplace(key, std::to_string(key) + std::string(64, 'v'));
+                }
+            }
+        });
+    }
+    for (auto &th: workers) th.join();
+    assert(hits.load() > 0);
+}
+
+void test_concurrent_visit() {
+    {
+        ConcurrentLRUCache<int, std::string> c(128);
+        check_concurrent_visit(c);
+    }
+    {
+        ConcurrentS3FIFOCache<int, std::string> c(128);
+        check_concurrent_visit(c);
+    }
+    {
+        ShardedConcurrentCache<int, std::string, TinyLFUCache<int, std::string>> c(128, 4);
+        check_concurrent_visit(c);
+    }
+    std::cout << "[concurrent_visit] PASS\n";
+}
+
+// 热 key 同时未命中:只有一个调用方运行 loader,异常传给所有等待者,负缓存在 TTL 内生效
+template<typename CacheT>
+void check_get_or_load(CacheT &cache) {
+    std::atomic<int> loads{0};
+    std::atomic<int> ready{0};
+    std::vector<std::thread> workers;
+    std::vector<std::optional<int>> results(16);
+    for (int t = 0; t < 16; ++t) {
+        workers.emplace_back([&, t] {
+            ready.fetch_add(1);
+            while (ready.load() < 16) std::this_thread::yield();
+            results[t] = cache.getOrLoad(7, [&loads](const int &key) {
+                loads.fetch_add(1);
+                std::this_thread::sleep_for(std::chrono::milliseconds(20));
+                return key * 10;
+            });
+        });
+    }
+    for (auto &th: workers) th.join();
+    assert(loads.load() == 1);
+    for (const auto &r: results) assert(r == 70);
+    assert(cache.get(7) == 70);
+    // 已缓存时不再调用 loader
+    assert(cache.getOrLoad(7, [](const int &) -> int { assert(false); return 0; }) == 70);
+
+    // 异常传播给所有等待者,且不被缓存
+    std::atomic<int> failures{0};
+    loads = 0;
+    ready = 0;
+    workers.clear();
+    for (int t = 0; t < 8; ++t) {
+        workers.emplace_back([&] {
+            ready.fetch_add(1);
+            while (ready.load() < 8) std::this_thread::yield();
+            try {
+                cache.getOrLoad(8, [&loads](const int &) -> int {
+                    loads.fetch_add(1);
+                    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+                    throw std::runtime_error("backend down");
+                });
+            } catch (const std::runtime_error &) {
+                failures.fetch_add(1);
+            }
+        });
+    }
+    for (auto &th: workers) th.join();
+    assert(failures.load() == 8 && loads.load() >= 1 && loads.load() < 8);
+    assert(!cache.contains(8));
+    assert(cache.getOrLoad(8, [](const int &) { return 80; }) == 80);
+
+    // loader 返回空:不写入缓存;开启负缓存后 TTL 内不再调用 loader
+    loads = 0;
+    auto absent = [&loads](const int &) -> std::optional<int> {
+        loads.fetch_add(1);
+        return std::nullopt;
+    };
+    assert(!cache.getOrLoad(9, absent) && !cache.getOrLoad(9, absent) && loads.load() == 2);
+    cache.setNegativeCaching(std::chrono::milliseconds(50));
+    assert(!cache.getOrLoad(9, absent) && !cache.getOrLoad(9, absent) && loads.load() == 3);
+    assert(!cache.contains(9));
+    std::this_thread::sleep_for(std::chrono::milliseconds(60));
+    assert(!cache.getOrLoad(9, absent) && loads.load() == 4);
+    cache.setNegativeCaching(std::chrono::milliseconds(0));
+    assert(!cache.getOrLoad(9, absent) && loads.load() == 5);
+}
+
+void test_get_or_load() {
+    {
+        ConcurrentLRUCache<int, int> c(64);
+        check_get_or_load(c);
+    }
+    {
+        ConcurrentFIFOCache<int, int> c(64);
+        check_get_or_load(c);
+    }
+    {
+        ShardedConcurrentCache<int, int, TinyLFUCache<int, int>> c(256, 4);
+        check_get_or_load(c);
+    }
+    std::cout << "[get_or_load] PASS\n";
+}
+
+// 简单的线程池执行器
+class ThreadPoolExecutor {
+private:
+    std::mutex m_mutex;
+    std::condition_variable m_ready;
+    std::deque<std::function<void()>> m_tasks;
+    bool m_stop = false;
+    std::vector<std::thread> m_workers;
+
+public:
+    explicit ThreadPoolExecutor(std::size_t threads) {
+        for (std::size_t i = 0; i < threads; ++i) {
+            m_workers.emplace_back([this] {
+                while (true) {
+                    std::function<void()> task;
+                    {
+                        std::unique_lock lock(m_mutex);
+                        m_ready.wait(lock, [this] { return m_stop || !m_tasks.empty(); });
+                        if (m_tasks.empty()) return;
+                        task = std::move(m_tasks.front());
+                        m_tasks.pop_front();
+                    }
+                    task();
+                }
+            });
+        }
+    }
+
+    ~ThreadPoolExecutor() {
+        {
+            std::lock_guard lock(m_mutex);
+            m_stop = true;
+        }
+        m_ready.notify_all();
+        for (auto &th: m_workers) th.join();
+    }
+
+    void execute(std::function<void()> task) {
+        {
+            std::lock_guard lock(m_mutex);
+            m_tasks.push_back(std::move(task));
+        }
+        m_ready.notify_one();
+    }
+};
+
+// 把任务攒起来,由 drain 按提交顺序依次运行(包括运行期间新提交的任务)
+class DeferredExecutor {
+private:
+    std::mutex m_mutex;
+    std::deque<std::function<void()>> m_tasks;
+
+public:
+    void execute(std::function<void()> task) {
+        std::lock_guard lock(m_mutex);
+        m_tasks.push_back(std::move(task));
+    }
+
+    void drain() {
+        while (true) {
+            std::function<void()> task;
+            {
+                std::lock_guard lock(m_mutex);
+                if (m_tasks.empty()) return;
+                task = std::move(m_tasks.front());
+                m_tasks.pop_front();
+            }
+            task();
+        }
+    }
+};
+
+// 立即开始执行的协程,结果通过 std::future 取回
+template<typename T>
+struct FutureTask {
+    struct promise_type {
+        std::promise<T> result;
+
+        FutureTask get_return_object() { return {result.get_future()}; }
+
+        std::suspend_never initial_suspend() noexcept { return {}; }
+
+        std::suspend_never final_suspend() noexcept { return {}; }
+
+        void return_value(T value) { result.set_value(std::move(value)); }
+
+        void unhandled_exception() { result.set_exception(std::current_exception()); }
+    };
+
+    std::future<T> future;
+};
+
+template<typename CacheT, typename Loader>
+FutureTask<std::optional<int>> fetch_async(CacheT &cache, int key, Loader loader,
+                                           std::thread::id *resumedOn = nullptr) {
+    auto value = co_await cache.getAsync(key, loader);
+    if (resumedOn != nullptr) *resumedOn = std::this_thread::get_id();
+    co_return value;
+}
+
+template<typename Predicate>
+bool wait_until(Predicate predicate) {
+    for (int i = 0; i < 2000 && !predicate(); ++i) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    return predicate();
+}
+
+void test_async_cache() {
+    using namespace std::chrono_literals;
+    ThreadPoolExecutor pool(4);
+    auto self = std::this_thread::get_id();
+    std::thread::id resumedOn;
+    {
+        AsyncCache<int, int, LRUCache<int, int>, ThreadPoolExecutor, ManualClock> cache(pool, 64, 10s, 0.8);
+        std::atomic<int> loads{0};
+        std::atomic<int> version{0};
+        auto loader = [&loads, &version](const int &key) {
+            loads.fetch_add(1);
+            return key * 10 + version.load();
+        };
+        // 未命中在执行器线程上加载并恢复;命中不挂起,在调用线程上继续
+        assert(fetch_async(cache, 1, loader, &resumedOn).future.get() == 10 && loads.load() == 1);
+        assert(resumedOn != self);
+        assert(fetch_async(cache, 1, loader, &resumedOn).future.get() == 10 && loads.load() == 1);
+        assert(resumedOn == self);
+
+        // 度过 80% 寿命:命中立即返回旧值,后台刷新
+        version = 1;
+        ManualClock::advance(9s);
+        assert(fetch_async(cache, 1, loader).future.get() == 10);
+        assert(wait_until([&] { return cache.cache().get(1) == 11; }));
+        assert(loads.load() == 2);
+        // 刷新重设了 TTL:原本到期的时刻之后依然命中,且未到刷新点时不再刷新
+        ManualClock::advance(2s);
+        assert(fetch_async(cache, 1, loader).future.get() == 11);
+        assert(loads.load() == 2);
+
+        // 并发未命中只加载一次
+        std::atomic<int> slowLoads{0};
+        auto slow = [&slowLoads](const int &key) {
+            slowLoads.fetch_add(1);
+            std::this_thread::sleep_for(20ms);
+            return key;
+        };
+        std::vector<std::future<std::optional<int>>> pending;
+        for (int i = 0; i < 16; ++i) pending.push_back(fetch_async(cache, 5, slow).future);
+        for (auto &f: pending) assert(f.get() == 5);
+        assert(slowLoads.load() == 1);
+
+        // loader 的异常在 co_await 处抛出
+        bool threw = false;
+        try {
+            fetch_async(cache, 6, [](const int &) -> int { throw std::runtime_error("backend down"); })
+                    .future.get();
+        } catch (const std::runtime_error &) {
+            threw = true;
+        }
+        assert(threw && !cache.cache().contains(6));
+
+        // 后台刷新失败时保留旧值
+        ManualClock::advance(9s);
+        auto failing = [](const int &) -> int { throw std::runtime_error("backend down"); };
+        assert(fetch_async(cache, 5, failing).future.get() == 5);
+    }
+    {
+        // 刷新窗口内的一连串命中只触发一次后台刷新:命中全部完成后刷新任务才依次运行
+        DeferredExecutor deferred;
+        AsyncCache<int, int, LRUCache<int, int>, DeferredExecutor, ManualClock> cache(deferred, 64, 10s, 0.8);
+        int loads = 0;
+        auto loader = [&loads](const int &key) {
+            ++loads;
+            return key;
+        };
+        auto first = fetch_async(cache, 1, loader).future;
+        std::thread(&DeferredExecutor::drain, &deferred).join();
+        assert(first.get() == 1 && loads == 1);
+        ManualClock::advance(9s);
+        std::vector<std::future<std::optional<int>>> hits;
+        for (int i = 0; i < 32; ++i) hits.push_back(fetch_async(cache, 1, loader).future);
+        std::thread(&DeferredExecutor::drain, &deferred).join();
+        for (auto &f: hits) assert(f.get() == 1);
+        assert(loads == 2);
+    }
+    {
+        // 未开启 refresh-ahead 时只在到期后重新加载
+        AsyncCache<int, int, SIEVECache<int, int>, ThreadPoolExecutor, ManualClock> cache(pool, 64, 10s);
+        std::atomic<int> loads{0};
+        auto loader = [&loads](const int &key) {
+            loads.fetch_add(1);
+            return key;
+        };
+        assert(fetch_async(cache, 1, loader).future.get() == 1);
+        ManualClock::advance(9s);
+        assert(fetch_async(cache, 1, loader).future.get() == 1 && loads.load() == 1);
+        ManualClock::advance(1s);
+        assert(fetch_async(cache, 1, loader).future.get() == 1 && loads.load() == 2);
+    }
+    {
+        // 命中不经过执行器:任务队列不被运行也能立即完成
+        DeferredExecutor deferred;
+        AsyncCache<int, int, LRUCache<int, int>, DeferredExecutor, ManualClock> cache(deferred, 64, 10s);
+        cache.cache().put(1, 10);
+        auto hit = fetch_async(cache, 1, [](const int &key) { return key; }).future;
+        assert(hit.wait_for(0s) == std::future_status::ready && hit.get() == 10);
+        auto miss = fetch_async(cache, 2, [](const int &key) { return key; }).future;
+        assert(miss.wait_for(0s) == std::future_status::timeout);
+        std::thread(&DeferredExecutor::drain, &deferred).join();
+        assert(miss.get() == 2);
+    }
+    {
+        // 等待同一次慢加载的协程不占用执行器线程:两个线程的池里,其余 key 照常完成
+        ThreadPoolExecutor small(2);
+        AsyncCache<int, int, LRUCache<int, int>, ThreadPoolExecutor, ManualClock> cache(small, 64, 10s);
+        std::promise<void> gate;
+        std::shared_future<void> opened = gate.get_future().share();
+        std::atomic<int> loads{0};
+        auto gated = [&loads, opened](const int &key) {
+            loads.fetch_add(1);
+            opened.wait();
+            return key * 2;
+        };
+        std::vector<std::future<std::optional<int>>> waiters;
+        waiters.push_back(fetch_async(cache, 7, gated).future);
+        assert(wait_until([&] { return loads.load() == 1; }));
+        for (int i = 0; i < 8; ++i) waiters.push_back(fetch_async(cache, 7, gated).future);
+        auto other = fetch_async(cache, 8, [](const int &key) { return key; }).future;
+        assert(other.wait_for(2s) == std::future_status::ready && other.get() == 8);
+        gate.set_value();
+        for (auto &f: waiters) assert(f.get() == 14);
+        assert(loads.load() == 1);
+
+        // 加载失败时挂起的等待者同样收到异常
+        std::promise<void> failGate;
+        std::shared_future<void> failOpened = failGate.get_future().share();
+        auto failing = [failOpened](const int &) -> int {
+            failOpened.wait();
+            throw std::runtime_error("backend down");
+        };
+        std::vector<std::future<std::optional<int>>> failed;
+        for (int i = 0; i < 4; ++i) failed.push_back(fetch_async(cache, 9, failing).future);
+        failGate.set_value();
+        for (auto &f: failed) {
+            bool threw = false;
+            try { f.get(); } catch (const std::runtime_error &) { threw = true; }
+            assert(threw);
+        }
+    }
+    std::cout << "[async_cache] PASS\n";
+}
+
+// 策略本身没有虚函数,装饰器按值保存策略,调用都在编译期解析
+static_assert(!std::is_polymorphic_v<LRUCache<int, int>>);
+static_assert(!std::is_polymorphic_v<SlabFIFOCache<int, int>>);
+static_assert(!std::is_polymorphic_v<WeightedCache<int, std::pair<int, int>>>);
+static_assert(!std::is_polymorphic_v<ExpiringCache<int, int, ARCCache<int, int>>>);
+static_assert(!std::is_polymorphic_v<ComposedCache<int, int, SIEVEOrdering, TinyLFUAdmission>>);
+static_assert(CachePolicy<ComposedCache<int, int>, int, int>);
+static_assert(CachePolicy<TinyLFUCache<std::string, int>, std::string, int>);
+
+void test_composed_cache() {
+    // 与手写策略做差分对比
+    LRUCache<int, int> lru(50);
+    ComposedCache<int, int, LRUOrdering> composedLru(50);
+    FIFOCache<int, int> fifo(50);
+    ComposedCache<int, int, FIFOOrdering, AlwaysAdmit, FlatHashIndex> composedFifo(50);
+    SIEVECache<int, int> sieve(50);
+    ComposedCache<int, int, SIEVEOrdering> composedSieve(50);
+    std::mt19937 gen(7);
+    std::uniform_int_distribution<int> keyDist(0, 199);
+    for (int i = 0; i < 20000; ++i) {
+        int k = keyDist(gen);
+        switch (gen() % 4) {
+            case 0:
+                assert(lru.get(k) == composedLru.get(k));
+                assert(fifo.get(k) == composedFifo.get(k));
+                assert(sieve.get(k) == composedSieve.get(k));
+                break;
+            case 1:
+                lru.erase(k);
+                composedLru.erase(k);
+                fifo.erase(k);
+                composedFifo.erase(k);
+                sieve.erase(k);
+                composedSieve.erase(k);
+                break;
+            default:
+                lru.put(k, i);
+                composedLru.put(k, i);
+                fifo.put(k, i);
+                composedFifo.put(k, i);
+                sieve.put(k, i);
+                composedSieve.put(k, i);
+        }
+        assert(lru.size() == composedLru.size());
+        assert(fifo.size() == composedFifo.size());
+        assert(sieve.size() == composedSieve.size());
+    }
+
+    // TinyLFU 准入:一次性扫描不会冲掉热点
+    ComposedCache<int, int, SIEVEOrdering, TinyLFUAdmission> admitted(100);
+    for (int round = 0; round < 20; ++round)
+        for (int k = 0; k < 50; ++k) {
+            admitted.put(k, k);
+            admitted.get(k);
+        }
+    for (int k = 1000; k < 6000; ++k) admitted.put(k, k);
+    int hot = 0;
+    for (int k = 0; k < 50; ++k) hot += admitted.contains(k);
+    assert(hot == 50 && admitted.size() <= 100);
+
+    // 按字节计费
+    ComposedCache<int, std::string, LRUOrdering, AlwaysAdmit, StdHashIndex, StringBytesSizer> bytes(100);
+    for (int k = 0; k < 50; ++k) bytes.put(k, std::string(static_cast<std::size_t>(k % 20 + 1), 'x'));
+    assert(bytes.totalCharge() <= 100 && bytes.size() > 0);
+    bytes.put(999, std::string(100, 'x'));  // 加上 key 超出整个预算
+    assert(!bytes.contains(999));
+
+    // 组合策略同样可以放进并发装饰器
+    ConcurrentCache<int, int, ComposedCache<int, int, SIEVEOrdering, TinyLFUAdmission, FlatHashIndex>> concurrent(256);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < 4; ++t) {
+        workers.emplace_back([&concurrent, t] {
+            for (int i = 0; i < 5000; ++i) {
+                int k = (i * 13 + t) % 512;
+                if (!concurrent.get(k)) concurrent.put(k, k);
+            }
+        });
+    }
+    for (auto &th: workers) th.join();
+    assert(concurrent.size() <= 256);
+    std::cout << "[composed_cache] PASS\n";
+}
+
+void test_cache_adapter() {
+    // 需要运行时多态时,用 CacheAdapter 把具体策略包装成 Cache<K,V>
+    std::vector<std::unique_ptr<Cache<int, int>>> caches;
+    caches.push_back(std::make_unique<CacheAdapter<LRUCache<int, int>>>(2));
+    caches.push_back(std::make_unique<CacheAdapter<FIFOCache<int, int>>>(2));
+    caches.push_back(std::make_unique<CacheAdapter<ComposedCache<int, int, SIEVEOrdering>>>(2));
+    for (auto &cache: caches) {
+        cache->put(1, 10);
+        cache->put(2, 20);
+        assert(cache->get(1) == 10 && cache->contains(2) && cache->size() == 2);
+        int seen = 0;
+        assert(cache->visit(2, [&seen](const int &v) { seen = v; }) && seen == 20);
+        cache->emplace(3, 30);
+        assert(cache->size() == 2 && cache->get(3) == 30);
+        std::vector<int> keys{1, 2, 3};
+        auto values = cache->getMany(keys);
+        assert(values.size() == 3 && values[2] == 30);
+        cache->erase(3);
+        assert(!cache->contains(3));
+    }
+    auto *lru = static_cast<CacheAdapter<LRUCache<int, int>> *>(caches[0].get());
+    assert(lru->impl().peek(2) == 20);
+    std::cout << "[cache_adapter] PASS\n";
+}
+
+// 统计经过的分配,其余交给全局分配器
+class CountingResource : public std::pmr::memory_resource {
+public:
+    std::size_t allocations = 0;
+    std::size_t outstanding = 0;  // 尚未归还的字节数
+
+protected:
+    void *do_allocate(std::size_t bytes, std::size_t alignment) override {
+        ++allocations;
+        outstanding += bytes;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void *p, std::size_t bytes, std::size_t alignment) override {
+        outstanding -= bytes;
+        std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+
+    [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override {
+        return this == &other;
+    }
+};
+
+void test_memory_resource() {
+    // 每个策略的节点都从给定的资源分配,析构后全部归还
+    auto check = [](auto make) {
+        CountingResource counting;
+        {
+            auto cache = make(&counting);
+            for (int i = 0; i < 200; ++i) cache->put(i, {i, i});
+            assert(cache->resource() == &counting);
+            assert(counting.allocations > 0);
+        }
+        assert(counting.outstanding == 0);
+    };
+    using Entry = std::pair<int, int>;
+    check([](auto *r) { return std::make_unique<LRUCache<int, Entry>>(64, r); });
+    check([](auto *r) { return std::make_unique<FIFOCache<int, Entry>>(64, r); });
+    check([](auto *r) { return std::make_unique<LFUCache<int, Entry>>(64, r); });
+    check([](auto *r) { return std::make_unique<RandomReplacementCache<int, Entry>>(64, r); });
+    check([](auto *r) { return std::make_unique<TinyLFUCache<int, Entry>>(64, r); });
+    check([](auto *r) { return std::make_unique<ARCCache<int, Entry>>(64, r); });
+    check([](auto *r) { return std::make_unique<S3FIFOCache<int, Entry>>(64, r); });
+    check([](auto *r) { return std::make_unique<SIEVECache<int, Entry>>(64, r); });
+    check([](auto *r) { return std::make_unique<WeightedCache<int, Entry>>(64, r); });
+    check([](auto *r) { return std::make_unique<ComposedCache<int, Entry, SIEVEOrdering>>(64, r); });
+    check([](auto *r) { return std::make_unique<LRUCache<int, Entry, FlatHashIndex>>(64, r); });
+    check([](auto *r) {
+        return std::make_unique<ExpiringCache<int, Entry, LRUCache<int, Entry>>>(64, std::chrono::hours(1), r);
+    });
+
+    // FlatHashMap 赋值不传播 pmr 分配器:元素复制/移动到左侧对象自己的资源中
+    {
+        using PmrFlat = FlatHashMap<int, std::string, std::hash<int>, std::equal_to<int>, FlatGroupDefault,
+                std::pmr::polymorphic_allocator<std::pair<int, std::string>>>;
+        CountingResource left, right;
+        {
+            PmrFlat target(&left);
+            PmrFlat source(&right);
+            for (int i = 0; i < 100; ++i) source.try_emplace(i, std::string(32, static_cast<char>('a' + i % 26)));
+            target.try_emplace(-1, "old");
+            target = source;
+            assert(target.get_allocator().resource() == &left && source.get_allocator().resource() == &right);
+            assert(target.size() == 100 && !target.contains(-1));
+            for (const auto &kv: source) assert(target.find(kv.first)->second == kv.second);
+            assert(left.outstanding > 0);
+
+            target.clear();
+            target = std::move(source);
+            assert(target.get_allocator().resource() == &left && source.empty());
+            assert(target.size() == 100 && target.find(42)->second == std::string(32, 'q'));
+
+            // 资源相同时直接接管存储,不再分配
+            PmrFlat sibling(&left);
+            std::size_t before = left.allocations;
+            sibling = std::move(target);
+            assert(left.allocations == before && sibling.size() == 100 && target.empty());
+        }
+        assert(left.outstanding == 0 && right.outstanding == 0);
+    }
+    std::cout << "[memory_resource] PASS\n";
+}
+
+void test_node_pool() {
+    // 预热之后,淘汰释放的节点被下一次插入复用,不再访问全局分配器
+    NodePoolResource pool;
+    LRUCache<int, int> lru(128, &pool);
+    SIEVECache<int, int> sieve(128, &pool);
+    auto churn = [](auto &cache, int from) {
+        for (int i = from; i < from + 10000; ++i) {
+            cache.put(i, i);
+            cache.get(i - 64);
+            if (i % 5 == 0) cache.erase(i - 3);
+        }
+    };
+    churn(lru, 0);
+    churn(sieve, 0);
+    std::size_t before = g_allocations.load();
+    churn(lru, 10000);
+    churn(sieve, 10000);
+    assert(g_allocations.load() == before);
+    assert(lru.size() == 128 && lru.get(19999) == 19999);
+
+    // 过大的请求转给上游,release 归还所有块
+    CountingResource counting;
+    {
+        NodePoolResource local(&counting);
+        void *small = local.allocate(24, 8);
+        void *large = local.allocate(4096, 8);
+        assert(counting.allocations == 2);
+        local.deallocate(large, 4096, 8);
+        local.deallocate(small, 24, 8);
+        void *again = local.allocate(20, 8);
+        assert(again == small && counting.allocations == 2);
+        local.deallocate(again, 20, 8);
+    }
+    assert(counting.outstanding == 0);
+
+    // 被 ConcurrentCache 独占时分配都在写锁内;分片共享时使用加锁的节点池
+    NodePoolResource exclusive;
+    ConcurrentLRUCache<int, int> concurrent(256, &exclusive);
+    SynchronizedNodePoolResource shared;
+    ShardedConcurrentCache<int, int, LRUCache<int, int>> sharded(256, 4, &shared);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < 4; ++t) {
+        workers.emplace_back([&, t] {
+            for (int i = 0; i < 5000; ++i) {
+                int k = (i * 7 + t) % 512;
+                if (!concurrent.get(k)) concurrent.put(k, k);
+                if (!sharded.get(k)) sharded.put(k, k);
+            }
+        });
+    }
+    for (auto &th: workers) th.join();
+    assert(concurrent.size() <= 256 && sharded.size() <= 256);
+    std::cout << "[node_pool] PASS\n";
+}
+
+// ===== Stats Tests =====
+void test_stats() {
+    // 默认不统计:统计器是空类型,策略不提供 stats()
+    static_assert(std::is_empty_v<NoStats> && std::is_empty_v<OperationTimer<NoStats>>);
+    static_assert(!StatsRecordingPolicy<LRUCache<int, int>>);
+    static_assert(StatsRecordingPolicy<LRUCache<int, int, StdHashIndex, UnitSizer, CacheStats>>);
+
+    LRUCache<int, std::string, StdHashIndex, StringBytesSizer, CacheStats> lru(100);
+    lru.put(1, std::string(40, 'a'));
+    lru.put(2, std::string(40, 'b'));
+    assert(lru.get(1) && !lru.get(3) && lru.find(1) != nullptr);
+    assert(lru.peek(2));                      // peek 不计入
+    lru.put(3, std::string(40, 'c'));         // 淘汰 2
+    lru.put(4, std::string(200, 'd'));        // 超出整个预算,被拒绝
+    lru.erase(3);                             // 显式删除不算淘汰
+    auto s = lru.stats();
+    assert(s.hits == 2 && s.misses == 1 && s.puts == 4);
+    assert(s.evictionCount(EvictionCause::Size) == 1 && s.evictionCount(EvictionCause::Rejected) == 1);
+    assert(s.evictionCount() == 2 && s.size == 1 && s.charge == 44);
+    assert(s.hitRatio() > 0.66 && s.hitRatio() < 0.67);
+
+    // 准入失败计为 Rejected;TTL 到期的清理计为 Expired
+    TinyLFUCache<int, int, StdHashIndex, CacheStats> tiny(100);
+    for (int round = 0; round < 5; ++round)
+        for (int i = 0; i < 100; ++i) tiny.get(i) || (tiny.put(i, i), true);
+    for (int i = 1000; i < 1100; ++i) tiny.put(i, i);
+    assert(tiny.stats().evictionCount(EvictionCause::Rejected) > 0);
+
+    using namespace std::chrono_literals;
+    ExpiringCache<int, int, SIEVECache<int, int, StdHashIndex, CacheStats>, ManualClock> expiring(2, 10s);
+    expiring.put(1, 1);
+    expiring.put(2, 2);
+    ManualClock::advance(11s);
+    assert(!expiring.get(1));
+    expiring.put(3, 3);  // 清理到期的 1 和 2
+    expiring.put(4, 4);
+    auto e = expiring.stats();
+    assert(e.misses == 1 && e.evictionCount(EvictionCause::Expired) == 2);
+    assert(e.evictionCount(EvictionCause::Size) == 0 && e.size == 2);
+
+    // 并发:读锁下的命中同样计数,每次 get/put 各有一个延迟样本与一次加锁
+    ConcurrentCache<int, int, LRUCache<int, int, StdHashIndex, UnitSizer, CacheStats>> concurrent(64);
+    ShardedConcurrentCache<int, int, FIFOCache<int, int, StdHashIndex, UnitSizer, CacheStats>> sharded(64, 4);
+    const int threads = 4;
+    const int ops = 2000;
+    std::atomic<std::uint64_t> puts{0};
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            for (int i = 0; i < ops; ++i) {
+                int k = (i * 13 + t) % 128;
+                if (!concurrent.get(k)) {
+                    concurrent.put(k, k);
+                    puts.fetch_add(1);
+                }
+                if (!sharded.get(k)) sharded.put(k, k);
+            }
+        });
+    }
+    for (auto &th: workers) th.join();
+    auto c = concurrent.stats();
+    assert(c.requests() == threads * ops && c.puts == puts.load());
+    assert(c.latency(TimedOperation::Get).count() == threads * ops);
+    assert(c.latency(TimedOperation::Put).count() == puts.load());
+    assert(c.lockAcquisitions == threads * ops + puts.load());
+    // 两个线程可能同时未命中同一个 key,第二次 put 只是更新
+    assert(c.size == 64 && c.evictionCount(EvictionCause::Size) > 0);
+    assert(c.evictionCount(EvictionCause::Size) + c.size <= c.puts);
+    assert(c.latency(TimedOperation::Get).percentile(0.5) <= c.latency(TimedOperation::Get).percentile(0.99));
+    auto sh = sharded.stats();
+    assert(sh.requests() == threads * ops && sh.size == sharded.size());
+    assert(sh.evictionCount() > 0 && sh.evictionCount() + sh.size <= sh.puts);
+
+    // getOrLoad:一次请求只计一次未命中,加载延迟单独计入
+    concurrent.erase(-1);
+    auto before = concurrent.stats();
+    assert(concurrent.getOrLoad(-1, [](int k) { return k; }) == -1);
+    auto after = concurrent.stats();
+    assert(after.misses == before.misses + 1 && after.latency(TimedOperation::Load).count() == 1);
+
+    // 直方图:桶 i 的上界为 2^i ns
+    LatencySnapshot histogram;
+    histogram.buckets[3] = 90;
+    histogram.buckets[10] = 10;
+    assert(histogram.count() == 100);
+    assert(histogram.percentile(0.5) == std::chrono::nanoseconds(8));
+    assert(histogram.percentile(0.99) == std::chrono::nanoseconds(1024));
+    std::cout << "[stats] PASS\n";
+}
+
+template<typename CacheT>
+void check_removal_batch(CacheT &cache) {
+    RemovalBatch<int, int> batch;
+    cache.collectRemovals(&batch);
+    cache.put(1, 10);
+    cache.put(2, 20);
+    cache.put(2, 21);  // 旧值 20 被替换
+    assert(batch.size() == 1 && batch[0].key == 2 && batch[0].value == 20);
+    assert(batch[0].cause == RemovalCause::Replaced);
+    cache.put(3, 30);  // 容量 2:淘汰一个条目(或拒绝 3)
+    assert(batch.size() == 2 && batch[1].cause == RemovalCause::Capacity);
+    assert(!cache.contains(batch[1].key) && cache.size() == 2);
+    int present = cache.contains(1) ? 1 : 2;
+    cache.erase(present);
+    assert(batch.size() == 3 && batch[2].key == present && batch[2].cause == RemovalCause::Explicit);
+    cache.collectRemovals(nullptr);  // 恢复就地析构
+    cache.put(4, 40);
+    cache.erase(4);
+    assert(batch.size() == 3);
+}
+
+// 析构时回调 onDestroy;被移走的实例不回调
+struct LockProbe {
+    static inline std::function<void()> onDestroy;
+    int id = 0;
+
+    explicit LockProbe(int i) : id(i) {}
+
+    LockProbe(const LockProbe &other) : id(other.id) {}
+
+    LockProbe(LockProbe &&other) noexcept : id(std::exchange(other.id, 0)) {}
+
+    LockProbe &operator=(const LockProbe &other) = default;
+
+    LockProbe &operator=(LockProbe &&other) noexcept {
+        id = std::exchange(other.id, 0);
+        return *this;
+    }
+
+    ~LockProbe() {
+        if (id != 0 && onDestroy) onDestroy();
+    }
+};
+
+void test_removal_listener() {
+    {
+        LRUCache<int, int> lru(2);
+        FIFOCache<int, int> fifo(2);
+        LFUCache<int, int, FlatHashIndex> lfu(2);
+        RandomReplacementCache<int, int, FlatHashIndex> random(2);
+        TinyLFUCache<int, int> tiny(2);
+        ARCCache<int, int> arc(2);
+        S3FIFOCache<int, int> s3fifo(2);
+        SIEVECache<int, int> sieve(2);
+        SlabLRUCache<int, int> slabLru(2);
+        SlabFIFOCache<int, int> slabFifo(2);
+        ComposedCache<int, int, SIEVEOrdering, TinyLFUAdmission> composed(2);
+        ExpiringCache<int, int, LRUCache<int, int>> expiring(2);
+        check_removal_batch(lru);
+        check_removal_batch(fifo);
+        check_removal_batch(lfu);
+        check_removal_batch(random);
+        check_removal_batch(tiny);
+        check_removal_batch(arc);
+        check_removal_batch(s3fifo);
+        check_removal_batch(sieve);
+        check_removal_batch(slabLru);
+        check_removal_batch(slabFifo);
+        check_removal_batch(composed);
+        check_removal_batch(expiring);
+    }
+
+    // 超出整个预算的新条目连同被丢弃的旧值一起移入批次
+    LRUCache<int, std::string, StdHashIndex, StringBytesSizer> bytes(100);
+    RemovalBatch<int, std::string> rejected;
+    bytes.collectRemovals(&rejected);
+    bytes.put(1, std::string(40, 'a'));
+    bytes.put(1, std::string(200, 'b'));
+    assert(rejected.size() == 2 && bytes.size() == 0);
+    assert(rejected[0].cause == RemovalCause::Replaced && rejected[0].value == std::string(40, 'a'));
+    assert(rejected[1].cause == RemovalCause::Capacity && rejected[1].value.size() == 200);
+
+    // 时间轮清理掉的条目标记为 Expired
+    using namespace std::chrono_literals;
+    ExpiringCache<int, int, FIFOCache<int, int>, ManualClock> expiring(4, 10s);
+    RemovalBatch<int, int> expired;
+    expiring.collectRemovals(&expired);
+    expiring.put(1, 1);
+    expiring.put(2, 2, 0s);
+    ManualClock::advance(11s);
+    expiring.cleanUp();
+    assert(expired.size() == 1 && expired[0].key == 1 && expired[0].cause == RemovalCause::Expired);
+    assert(expiring.contains(2));
+
+    // 监听器在释放写锁之后运行,可以访问缓存,并取走 value
+    ConcurrentLRUCache<int, std::string> concurrent(2);
+    std::vector<std::pair<int, RemovalCause>> seen;
+    std::string taken;
+    concurrent.setRemovalListener([&](const int &key, std::string &&value, RemovalCause cause) {
+        assert(concurrent.contains(key) == (cause == RemovalCause::Replaced));  // 持有写锁时这里会死锁
+        seen.emplace_back(key, cause);
+        if (cause == RemovalCause::Capacity) taken = std::move(value);
+    });
+    concurrent.put(1, "one");
+    concurrent.put(2, "two");
+    concurrent.put(3, "three");       // 淘汰 1
+    concurrent.put(2, "deux");        // 替换 2
+    concurrent.erase(3);
+    assert(!concurrent.try_emplace(2, "zwei"));
+    assert(seen.size() == 3 && taken == "one");
+    assert(seen[0] == std::make_pair(1, RemovalCause::Capacity));
+    assert(seen[1] == std::make_pair(2, RemovalCause::Replaced));
+    assert(seen[2] == std::make_pair(3, RemovalCause::Explicit));
+    concurrent.setRemovalListener(nullptr);
+    concurrent.erase(2);
+    assert(seen.size() == 3);
+
+    // 没有监听器时被淘汰、替换的值同样在释放写锁之后才析构:析构时另一个线程可以立即读取缓存
+    {
+        ConcurrentLRUCache<int, LockProbe> probed(1);
+        int destroyed = 0;
+        bool underLock = false;
+        LockProbe::onDestroy = [&] {
+            ++destroyed;
+            auto reader = std::async(std::launch::async, [&] { return probed.contains(-1); });
+            if (reader.wait_for(200ms) == std::future_status::timeout) underLock = true;
+        };
+        probed.put(1, LockProbe(1));
+        probed.put(2, LockProbe(2));  // 淘汰 1
+        probed.put(2, LockProbe(3));  // 替换 2
+        probed.erase(2);
+        LockProbe::onDestroy = nullptr;
+        assert(destroyed == 3 && !underLock);
+    }
+
+    // 分片:同一个监听器被多个线程调用,淘汰总数与写入数一致
+    ShardedConcurrentCache<int, int, FIFOCache<int, int>> sharded(64, 4);
+    std::atomic<int> evicted{0};
+    sharded.setRemovalListener([&](const int &, int &&, RemovalCause cause) {
+        if (cause == RemovalCause::Capacity) evicted.fetch_add(1);
+    });
+    std::vector<std::thread> workers;
+    for (int t = 0; t < 4; ++t) {
+        workers.emplace_back([&, t] {
+            for (int i = 0; i < 1000; ++i) sharded.put(t * 1000 + i, i);
+        });
+    }
+    for (auto &th: workers) th.join();
+    assert(evicted.load() + static_cast<int>(sharded.size()) == 4000);
+    std::cout << "[removal_listener] PASS\n";
+}
+
+void test_miss_ratio_curve() {
+    // 精确的曲线与逐个容量模拟 LRU 的命中率一致
+    std::mt19937_64 rng(7);
+    std::vector<std::uint64_t> trace;
+    for (int i = 0; i < 20000; ++i) {
+        std::uint64_t hot = rng() % 64;
+        trace.push_back(rng() % 4 == 0 ? rng() % 2000 : hot);
+    }
+    MissRatioCurveBuilder exact;
+    for (auto key: trace) exact.access(key);
+    auto curve = exact.build();
+    assert(curve.references() == trace.size());
+    for (std::size_t capacity: {1, 8, 64, 200, 1000, 5000}) {
+        LRUCache<std::uint64_t, int> cache(capacity);
+        std::size_t hits = 0;
+        for (auto key: trace) {
+            if (cache.get(key)) ++hits;
+            else cache.put(key, 0);
+        }
+        assert(std::abs(curve.hitRatio(capacity) - static_cast<double>(hits) / trace.size()) < 1e-9);
+    }
+
+    // SHARDS 采样(固定采样率与定长版本)的误差在可接受范围内
+    MissRatioCurveBuilder sampled(0.25);
+    MissRatioCurveBuilder bounded(1.0, 256);
+    for (auto key: trace) {
+        sampled.access(key);
+        bounded.access(key);
+    }
+    assert(bounded.trackedKeys() <= 256 && bounded.sampleRate() < 1.0);
+    for (std::size_t capacity: {200, 1000, 5000}) {
+        assert(std::abs(sampled.build().missRatio(capacity) - curve.missRatio(capacity)) < 0.05);
+        assert(std::abs(bounded.build().missRatio(capacity) - curve.missRatio(capacity)) < 0.05);
+    }
+
+    // 两种 trace 格式读出相同的 key 序列
+    auto dir = std::filesystem::temp_directory_path();
+    auto binaryPath = (dir / "cachelib_trace_test.bin").string();
+    auto csvPath = (dir / "cachelib_trace_test.csv").string();
+    {
+        std::ofstream binary(binaryPath, std::ios::binary);
+        std::ofstream csv(csvPath);
+        csv << "time,key\n";
+        for (std::size_t i = 0; i < 100; ++i) {
+            std::uint64_t key = trace[i];
+            unsigned char bytes[8];
+            for (int b = 0; b < 8; ++b) bytes[b] = static_cast<unsigned char>(key >> (8 * b));
+            binary.write(reinterpret_cast<const char *>(bytes), sizeof(bytes));
+            csv << i << ", " << key << "\r\n";
+        }
+        csv << "100,user:42\n";
+    }
+    assert(TraceReader::formatOf(csvPath) == TraceFormat::Csv);
+    assert(TraceReader::formatOf(binaryPath) == TraceFormat::Binary);
+    TraceReader binaryReader(binaryPath);
+    TraceReader csvReader(csvPath, TraceFormat::Csv, 1, true);
+    std::uint64_t a = 0, b = 0;
+    for (std::size_t i = 0; i < 100; ++i) {
+        assert(binaryReader.next(a) && csvReader.next(b));
+        assert(a == trace[i] && b == trace[i]);
+    }
+    assert(!binaryReader.next(a) && binaryReader.progress() == 1.0);
+    assert(csvReader.next(b) && b == std::hash<std::string_view>{}("user:42"));
+    assert(!csvReader.next(b));
+    binaryReader.rewind();
+    assert(binaryReader.next(a) && a == trace[0]);
+    std::filesystem::remove(binaryPath);
+    std::filesystem::remove(csvPath);
+    std::cout << "[miss_ratio_curve] PASS\n";
+}
+
+// 不含指针的平凡结构体,显式声明按原始字节序列化
+struct SnapshotPoint {
+    int x;
+    double y;
+};
+
+template<>
+struct SnapshotBitwise<SnapshotPoint> : std::true_type {};
+
+struct SnapshotLink {
+    int id;
+    const char *name;
+};
+
+// 指针与视图写出的是地址,不能序列化;平凡结构体须显式声明
+static_assert(Serializable<int> && Serializable<RemovalCause> && Serializable<SnapshotPoint>);
+static_assert(Serializable<std::pair<std::string, SnapshotPoint>>);
+static_assert(!Serializable<int *> && !Serializable<const char *> && !Serializable<std::nullptr_t>);
+static_assert(!Serializable<std::string_view> && !Serializable<std::span<const int>>);
+static_assert(!Serializable<SnapshotLink> && !Serializable<std::vector<std::string_view>>);
+
+void test_snapshot() {
+    auto dir = std::filesystem::temp_directory_path();
+    auto path = (dir / "cachelib_snapshot_test.bin").string();
+
+    // LRU:访问顺序被保留,容量更小时保留最近使用的条目
+    {
+        LRUCache<std::string, std::string> cache(4);
+        for (int i = 1; i <= 4; ++i) cache.put("k" + std::to_string(i), std::string(i * 10, 'x'));
+        cache.get("k1");
+        cache.saveSnapshot(path);
+        assert(!std::filesystem::exists(path + ".tmp"));
+
+        LRUCache<std::string, std::string> restored(4);
+        restored.loadSnapshot(path);
+        assert(restored.size() == 4 && restored.peek("k3") == std::string(30, 'x'));
+        restored.put("k5", "v");  // 淘汰 k2(k1 被访问过,比 k2 新)
+        assert(!restored.contains("k2") && restored.contains("k1"));
+
+        LRUCache<std::string, std::string> smaller(2);
+        smaller.loadSnapshot(path);
+        assert(smaller.size() == 2 && smaller.contains("k4") && smaller.contains("k1"));
+    }
+    // LFU:频率被保留
+    {
+        LFUCache<int, int> cache(3);
+        cache.put(1, 10);
+        cache.put(2, 20);
+        cache.put(3, 30);
+        for (int i = 0; i < 3; ++i) cache.get(1);
+        cache.get(2);
+        cache.saveSnapshot(path);
+
+        LFUCache<int, int> restored(3);
+        restored.loadSnapshot(path);
+        restored.put(4, 40);  // 淘汰频率最低的 3
+        assert(!restored.contains(3));
+        restored.get(4);
+        restored.get(4);
+        restored.put(5, 50);  // 2 的频率为 2,4 的频率为 3:淘汰 2
+        assert(!restored.contains(2) && restored.contains(1) && restored.contains(4));
+        assert(restored.get(1) == 10);
+    }
+    // FIFO:插入顺序被保留
+    {
+        FIFOCache<int, std::vector<int>> cache(3);
+        cache.put(3, {3});
+        cache.put(1, {1, 1});
+        cache.put(2, {2, 2, 2});
+        cache.saveSnapshot(path);
+
+        FIFOCache<int, std::vector<int>> restored(3);
+        restored.loadSnapshot(path);
+        assert(restored.get(2) == std::vector<int>({2, 2, 2}));
+        restored.put(4, {});
+        assert(!restored.contains(3) && restored.contains(1));
+    }
+    // Weighted:权重被保留
+    {
+        WeightedCache<int, std::pair<std::string, int>> cache(3);
+        cache.put(1, {"a", 30});
+        cache.put(2, {"b", 10});
+        cache.put(3, {"c", 20});
+        cache.saveSnapshot(path);
+
+        WeightedCache<int, std::pair<std::string, int>> restored(3);
+        restored.loadSnapshot(path);
+        assert(restored.get(1) == std::make_pair(std::string("a"), 30));
+        restored.put(4, {"d", 40});
+        assert(!restored.contains(2) && restored.contains(3));
+    }
+    // 声明了 SnapshotBitwise 的结构体按原始字节往返
+    {
+        LRUCache<int, SnapshotPoint> cache(4);
+        cache.put(1, {7, 2.5});
+        cache.saveSnapshot(path);
+        LRUCache<int, SnapshotPoint> restored(4);
+        restored.loadSnapshot(path);
+        auto point = restored.get(1);
+        assert(point && point->x == 7 && point->y == 2.5);
+    }
+    // ConcurrentCache:加载时挤出的条目通知移除监听器
+    {
+        ConcurrentCache<int, int, LRUCache<int, int>> cache(100);
+        for (int i = 0; i < 100; ++i) cache.put(i, i * i);
+        cache.get(0);
+        cache.saveSnapshot(path);
+
+        ConcurrentCache<int, int, LRUCache<int, int>> restored(50);
+        std::vector<int> evicted;
+        restored.setRemovalListener([&](const int &key, int &&, RemovalCause cause) {
+            assert(cause == RemovalCause::Capacity);
+            evicted.push_back(key);
+        });
+        restored.loadSnapshot(path);
+        assert(restored.size() == 50 && evicted.size() == 50);
+        assert(restored.get(0) == 0 && restored.get(99) == 99 * 99 && !restored.contains(1));
+    }
+    // 来自其他策略、损坏或截断的快照被拒绝,缓存不变
+    {
+        LRUCache<int, int> cache(8);
+        for (int i = 0; i < 8; ++i) cache.put(i, i);
+        cache.saveSnapshot(path);
+
+        FIFOCache<int, int> other(8);
+        bool threw = false;
+        try { other.loadSnapshot(path); } catch (const std::runtime_error &) { threw = true; }
+        assert(threw && other.size() == 0);
+
+        auto size = std::filesystem::file_size(path);
+        {
+            std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+            file.seekp(static_cast<std::streamoff>(size - 3));
+            file.put('\x7f');
+        }
+        LRUCache<int, int> corrupted(8);
+        threw = false;
+        try { corrupted.loadSnapshot(path); } catch (const std::runtime_error &) { threw = true; }
+        assert(threw && corrupted.size() == 0);
+
+        std::filesystem::resize_file(path, size - 8);
+        threw = false;
+        try { corrupted.loadSnapshot(path); } catch (const std::runtime_error &) { threw = true; }
+        assert(threw && corrupted.size() == 0);
+    }
+    std::filesystem::remove(path);
+    std::cout << "[snapshot] PASS\n";
+}
+
+void test_region_store() {
+    auto path = (std::filesystem::temp_directory_path() / "cachelib_region_store_test.bin").string();
+    {
+        RegionStore<int, std::string> store(RegionStoreOptions{path, 4096, 4, 4096});
+        assert(store.capacityBytes() == 4 * 4096 && std::filesystem::file_size(path) == 4 * 4096);
+        for (int i = 0; i < 20; ++i) assert(store.insert(i, std::string(100, static_cast<char>('a' + i))));
+        assert(store.size() == 20 && store.stats().regionsWritten == 0);  // 仍在内存中的当前区域
+        assert(store.lookup(3) == std::string(100, 'd'));
+        assert(store.insert(3, "updated") && store.lookup(3) == "updated" && store.size() == 20);
+        assert(store.take(4) == std::string(100, 'e') && !store.contains(4));
+        assert(store.erase(5) && !store.lookup(5) && !store.erase(5));
+
+        // 写满区域后按对齐长度落盘,从文件读回;再绕回时回收最早的区域
+        for (int i = 100; i < 400; ++i) assert(store.insert(i, std::to_string(i) + std::string(100, 'x')));
+        const auto &stats = store.stats();
+        assert(stats.regionsWritten >= 4 && stats.bytesWritten == stats.regionsWritten * 4096);
+        assert(stats.reclaimedEntries > 0 && !store.contains(0) && !store.lookup(100));
+        assert(store.lookup(399) == "399" + std::string(100, 'x'));
+        std::size_t onDisk = 0;
+        for (int i = 100; i < 400; ++i) {
+            auto value = store.lookup(i);
+            if (!value) continue;
+            assert(*value == std::to_string(i) + std::string(100, 'x'));
+            ++onDisk;
+        }
+        assert(onDisk == store.size() && onDisk > 4096 * 3 / 120);
+
+        // 超过一个区域的记录不保存
+        assert(!store.insert(7, std::string(5000, 'z')) && !store.contains(7) && store.stats().rejectedEntries == 1);
+
+        bool threw = false;
+        try { RegionStore<int, int> bad(RegionStoreOptions{path, 1000, 4, 4096}); } catch (const std::invalid_argument &) { threw = true; }
+        assert(threw);
+    }
+    std::filesystem::remove(path);
+    std::cout << "[region_store] PASS\n";
+}
+
+void test_hybrid_cache() {
+    auto path = (std::filesystem::temp_directory_path() / "cachelib_hybrid_test.bin").string();
+    auto valueOf = [](int key) { return std::to_string(key) + std::string(50, 'v'); };
+    {
+        HybridCache<int, std::string> cache(RegionStoreOptions{path, 4096, 8, 4096}, 4);
+        for (int i = 0; i < 20; ++i) cache.put(i, valueOf(i));
+        assert(cache.memory().size() == 4 && cache.store().size() == 16 && cache.size() == 20);
+        for (int i = 0; i < 20; ++i) assert(cache.contains(i));
+
+        // 文件层命中后提升回 DRAM,DRAM 中最久未使用的条目落到文件层
+        assert(cache.get(0) == valueOf(0));
+        assert(cache.memory().contains(0) && !cache.memory().contains(16) && cache.store().contains(16));
+        assert(cache.size() == 20);
+
+        // put 覆盖文件层中的旧版本;erase 同时删除两层
+        cache.put(1, "new");
+        assert(cache.get(1) == "new" && cache.size() == 20);
+        cache.erase(2);
+        cache.erase(17);
+        assert(!cache.contains(2) && !cache.contains(17) && !cache.get(2) && cache.size() == 18);
+
+        const std::string *value = cache.find(3);
+        assert(value != nullptr && *value == valueOf(3) && cache.memory().contains(3));
+    }
+    // DRAM 层没有 peek/touch 时读操作在 ConcurrentCache 中持写锁
+    static_assert(HybridCache<int, std::string, FIFOCache<int, std::string>>::kExclusiveGet);
+    static_assert(!HybridCache<int, std::string>::kExclusiveGet);
+    for (bool fifo: {false, true}) {
+        auto run = [&](auto &cache) {
+            std::vector<std::thread> threads;
+            for (int t = 0; t < 4; ++t) {
+                threads.emplace_back([&, t] {
+                    std::mt19937 rng(t);
+                    for (int i = 0; i < 5000; ++i) {
+                        int key = static_cast<int>(rng() % 500);
+                        if (auto hit = cache.get(key)) assert(*hit == valueOf(key));
+                        else cache.put(key, valueOf(key));
+                    }
+                });
+            }
+            for (auto &thread: threads) thread.join();
+            assert(cache.size() <= 500);
+        };
+        if (fifo) {
+            ConcurrentHybridCache<int, std::string, FIFOCache<int, std::string>> cache(RegionStoreOptions{path, 8192, 8, 4096}, 50);
+            run(cache);
+        } else {
+            ConcurrentHybridCache<int, std::string> cache(RegionStoreOptions{path, 8192, 8, 4096}, 50);
+            run(cache);
+        }
+    }
+    std::filesystem::remove(path);
+    std::cout << "[hybrid_cache] PASS\n";
+}
+
+// 统计存活实例数,用于检查延迟回收
+struct Counted {
+    static inline std::atomic<int> alive{0};
+    int value;
+
+    explicit Counted(int v) : value(v) { ++alive; }
+
+    Counted(const Counted &other) : value(other.value) { ++alive; }
+
+    ~Counted() { --alive; }
+};
+
+void test_lock_free_read_cache() {
+    {
+        LockFreeFIFOCache<std::string, int> cache(3);
+        cache.put("a", 1);
+        cache.put("b", 2);
+        cache.put("c", 3);
+        cache.put("a", 10);  // 替换值,不调整顺序
+        assert(cache.get("a") == 10 && cache.get(std::string_view("b")) == 2);
+        cache.put("d", 4);
+        assert(!cache.contains("a") && cache.contains("b") && cache.size() == 3);
+        cache.erase("c");
+        assert(!cache.get("c") && cache.size() == 2);
+        int seen = 0;
+        assert(cache.visit("d", [&](const int &value) { seen = value; }) && seen == 4);
+        assert(!cache.visit("c", [](const int &) {}));
+    }
+    {
+        LockFreeRandomCache<int, int> cache(16);
+        for (int k = 0; k < 200; ++k) {
+            cache.put(k, k);
+            assert(cache.get(k) == k && cache.size() <= 16);
+            if (k % 3 == 0) cache.erase(k - 1);
+        }
+    }
+    // 被淘汰、替换、删除的节点经 epoch 回收释放;读者停留在临界区时不会释放它看到的节点
+    {
+        {
+            LockFreeFIFOCache<int, Counted> cache(8);
+            for (int i = 0; i < 1000; ++i) cache.put(i % 16, Counted(i));
+            for (int i = 0; i < 4 && cache.pendingReclamation() != 0; ++i) cache.reclaim();
+            assert(cache.pendingReclamation() == 0 && Counted::alive == 8);
+
+            std::atomic<bool> pinned{false};
+            std::atomic<bool> release{false};
+            std::thread reader([&] {
+                bool hit = cache.visit(7, [&](const Counted &value) {
+                    pinned = true;
+                    while (!release) std::this_thread::yield();
+                    assert(value.value == 999);  // 在此期间节点已被替换,但仍未释放
+                });
+                assert(hit);
+            });
+            while (!pinned) std::this_thread::yield();
+            for (int i = 0; i < 200; ++i) cache.put(7, Counted(-i));
+            for (int i = 0; i < 4; ++i) cache.reclaim();
+            assert(cache.pendingReclamation() != 0);
+            release = true;
+            reader.join();
+            for (int i = 0; i < 4 && cache.pendingReclamation() != 0; ++i) cache.reclaim();
+            assert(cache.pendingReclamation() == 0 && Counted::alive == 8);
+        }
+        assert(Counted::alive == 0);
+    }
+    // 读者与写者并发:读到的值总是完整且与 key 对应
+    {
+        LockFreeReadCache<int, std::string, RandomReplacement> random(64);
+        LockFreeFIFOCache<int, std::string> fifo(64);
+        auto valueOf = [](int key) { return std::to_string(key) + std::string(40, 'x'); };
+        auto run = [&](auto &cache) {
+            std::atomic<bool> stop{false};
+            std::vector<std::thread> readers;
+            for (int t = 0; t < 6; ++t) {
+                readers.emplace_back([&, t] {
+                    std::mt19937 rng(t);
+                    while (!stop) {
+                        int key = static_cast<int>(rng() % 256);
+                        if (auto value = cache.get(key)) assert(*value == valueOf(key));
+                    }
+                });
+            }
+            std::vector<std::thread> writers;
+            for (int t = 0; t < 2; ++t) {
+                writers.emplace_back([&, t] {
+                    std::mt19937 rng(100 + t);
+                    for (int i = 0; i < 20000; ++i) {
+                        int key = static_cast<int>(rng() % 256);
+                        if (i % 5 == 0) cache.erase(key);
+                        else cache.put(key, valueOf(key));
+                    }
+                });
+            }
+            for (auto &thread: writers) thread.join();
+            stop = true;
+            for (auto &thread: readers) thread.join();
+            assert(cache.size() <= 64);
+        };
+        run(random);
+        run(fifo);
+    }
+    std::cout << "[lock_free_read_cache] PASS\n";
+}
+
 int main() {
     test_fifo_basic();
     test_fifo_concurrent();
@@ -282,12 +2976,59 @@ int main() {
     test_random_concurrent_put();
     test_random_concurrent_get();
     test_random_concurrent_mixed();
+    test_random_sampled();
     test_weighted_basic();
     test_weighted_conflict();
     test_weighted_uniform();
+    test_weighted_heap();
+    test_weighted_gdsf();
     test_weighted_concurrent_put();
     test_weighted_concurrent_get();
     test_weighted_concurrent_mixed();
+    test_sharded_basic();
+    test_sharded_capacity_split();
+    test_sharded_hash_bits();
+    test_sharded_concurrent_all_policies();
+    test_buffered_access_order();
+    test_buffered_access_concurrent();
+    test_slab_matches_reference();
+    test_slab_no_steady_state_allocation();
+    test_slab_concurrent();
+    test_slab_throwing_value();
+    test_flat_hash_map();
+    test_flat_index_policies();
+    test_tinylfu_basic();
+    test_tinylfu_scan_resistance();
+    test_tinylfu_concurrent();
+    test_arc_basic();
+    test_arc_adapts();
+    test_arc_concurrent();
+    test_sieve_basic();
+    test_s3fifo_basic();
+    test_fifo_family_hit_ratio();
+    test_fifo_family_concurrent();
+    test_byte_budget();
+    test_timer_wheel();
+    test_expiring_basic();
+    test_expiring_concurrent();
+    test_batch_ops();
+    test_heterogeneous_lookup();
+    test_key_copies();
+    test_move_and_visit();
+    test_concurrent_visit();
+    test_get_or_load();
+    test_async_cache();
+    test_composed_cache();
+    test_cache_adapter();
+    test_memory_resource();
+    test_node_pool();
+    test_stats();
+    test_removal_listener();
+    test_miss_ratio_curve();
+    test_snapshot();
+    test_region_store();
+    test_hybrid_cache();
+    test_lock_free_read_cache();
     std::cout << "all_tests_passed.\n";
     return 0;
 }